@@ -0,0 +1,440 @@
+// MMUKO hosted kernel harness.
+// Builds kernel.c as an ordinary process: COM1 writes land in a memory
+// buffer, VGA text memory is a static array, and the boot phases run over
+// any memory size and seed in milliseconds instead of a QEMU boot.
+//
+// Usage: kernel-hosted [-v] [--sizes N,N,...] [--seeds N] [--threads N]
+//        (runs seeds 0..N; --threads sets the parallel tree checksum build)
+
+#define MMUKO_HOSTED 1
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include "kernel.c"
+
+#define HOST_SERIAL_CAPACITY (64 * 1024)
+#define UART_LCR_DLAB 0x80
+#define UART_LSR_THRE 0x20
+
+static char g_serial[HOST_SERIAL_CAPACITY];
+static size_t g_serial_len;
+static uint8_t g_uart_lcr;
+
+static void mmuko_host_outb(uint16_t port, uint8_t value)
+{
+    if (port == COM1 + 3) {
+        g_uart_lcr = value;
+    } else if (port == COM1 && (g_uart_lcr & UART_LCR_DLAB) == 0) {
+        if (g_serial_len < sizeof(g_serial) - 1) {
+            g_serial[g_serial_len++] = (char)value;
+        }
+    }
+}
+
+static uint8_t mmuko_host_inb(uint16_t port)
+{
+    // The transmitter is always ready, so serial_write_char never spins
+    return port == COM1 + 5 ? UART_LSR_THRE : 0x00;
+}
+
+static void host_reset(void)
+{
+    g_serial_len = 0;
+    g_serial[0] = '\0';
+    g_uart_lcr = 0;
+}
+
+static double now_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
+// Every byte sits in exactly one bucket, the one for its base index, with
+// consistent back links
+static bool check_base_index(const MMUKO_System *sys)
+{
+    size_t total = 0;
+
+    for (int base = 0; base < MMUKO_BASE_SLOTS; base++) {
+        size_t walked = 0;
+        size_t prev = MMUKO_NO_BYTE;
+        for (size_t i = sys->bases.head[base]; i != MMUKO_NO_BYTE;
+             i = sys->memory_map[i].base_next) {
+            const MMUKO_Byte *byte = &sys->memory_map[i];
+            if (i >= sys->memory_size || byte->base_index != base || byte->base_prev != prev ||
+                byte->base_index != (byte->raw_value % 12) + 1 || ++walked > sys->memory_size) {
+                return false;
+            }
+            prev = i;
+        }
+        if (walked != sys->bases.count[base] || prev != sys->bases.tail[base]) {
+            return false;
+        }
+        total += walked;
+    }
+    return total == sys->memory_size;
+}
+
+// A run passes when boot reports BOOT_OK, NSIGII_YES, the serial log holds
+// the success banners, the base index matches memory after the program's
+// write, and the last VGA line is the program's closing banner
+static bool check_run(BootStatus status)
+{
+    g_serial[g_serial_len] = '\0';
+    if (status != BOOT_OK || g_system.verification_code != NSIGII_YES) {
+        return false;
+    }
+    if (!check_base_index(&g_system)) {
+        return false;
+    }
+    if (strstr(g_serial, "BOOT_SUCCESS\r\n") == NULL ||
+        strstr(g_serial, "=== MMUKO PROGRAM END ===") == NULL) {
+        return false;
+    }
+    size_t last_row = (g_vga_row + VGA_HEIGHT - 1) % VGA_HEIGHT;
+    static const char banner[] = "=== MMUKO PROGRAM END ===";
+    for (size_t i = 0; i < sizeof(banner) - 1; i++) {
+        if ((mmuko_host_vga[last_row * VGA_WIDTH + i] & 0xFF) != (uint8_t)banner[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+#define REVERIFY_WRITES 8
+
+static bool byte_state_equal(const MMUKO_Byte *a, const MMUKO_Byte *b)
+{
+    if (a->raw_value != b->raw_value || a->base_index != b->base_index ||
+        a->primary_superposition != b->primary_superposition ||
+        a->secondary_superposition != b->secondary_superposition) {
+        return false;
+    }
+    for (int i = 0; i < 8; i++) {
+        const Cubit *x = &a->cubit_ring[i];
+        const Cubit *y = &b->cubit_ring[i];
+        if (x->index != y->index || x->value != y->value || x->spin_mrad != y->spin_mrad ||
+            x->direction != y->direction || x->state != y->state ||
+            x->superposed != y->superposed || x->entangled_with != y->entangled_with) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// After a passing run: write REVERIFY_WRITES random bytes, re-verify only
+// the dirty regions, and compare every byte with a full boot of the same
+// memory. *elapsed_us covers the writes and the incremental pass
+static bool check_incremental(uint32_t seed, double *elapsed_us)
+{
+    MMUKO_System *sys = &g_system;
+    uint32_t x = seed * 2654435761u + 1;
+
+    double start = now_ms();
+    for (int k = 0; k < REVERIFY_WRITES; k++) {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        mmuko_write_byte(sys, x % sys->memory_size, (uint8_t)(x >> 24));
+    }
+    BootStatus status = mmuko_boot_incremental(sys);
+    *elapsed_us = (now_ms() - start) * 1000.0;
+    if (status != BOOT_OK || sys->dirty_count != 0 || !check_base_index(sys)) {
+        return false;
+    }
+
+    // The writes updated the tree along their paths; a rebuild must agree
+    uint32_t updated = mmuko_tree_checksum(sys);
+    sys->checksum.valid = false;
+    if (mmuko_tree_checksum(sys) != updated) {
+        return false;
+    }
+
+    MMUKO_Byte *copy = malloc(sys->memory_size * sizeof(MMUKO_Byte));
+    uint32_t *copy_dirty = malloc(MMUKO_DIRTY_WORDS(sys->memory_size) * sizeof(uint32_t));
+    if (copy == NULL || copy_dirty == NULL) {
+        free(copy);
+        free(copy_dirty);
+        return false;
+    }
+    static MMUKO_System reference;
+    mmuko_system_init(&reference, copy, copy_dirty, sys->memory_size, 0);
+    for (size_t i = 0; i < sys->memory_size; i++) {
+        copy[i].raw_value = sys->memory_map[i].raw_value;
+    }
+    bool ok = mmuko_boot(&reference) == BOOT_OK;
+    for (size_t i = 0; ok && i < sys->memory_size; i++) {
+        ok = byte_state_equal(&sys->memory_map[i], &copy[i]);
+    }
+    free(copy);
+    free(copy_dirty);
+    return ok;
+}
+
+// After check_incremental: the root rehashed along the re-booted blocks'
+// paths matches a full rebuild, a random block's proof verifies, and
+// tampering with the leaf, a sibling or a cubit in memory is caught.
+// *rehash_us covers the rehash the incremental pass left for the root
+static bool check_merkle(uint32_t seed, double *rehash_us)
+{
+    MMUKO_System *sys = &g_system;
+    double start = now_ms();
+    const MMUKO_Digest *root = mmuko_merkle_root(sys);
+    *rehash_us = (now_ms() - start) * 1000.0;
+    if (root == NULL) {
+        return false;
+    }
+    MMUKO_Digest updated = *root;
+    merkle_mark_all(sys);
+    root = mmuko_merkle_root(sys);
+    if (root == NULL || !digest_equal(&updated, root)) {
+        return false;
+    }
+
+    size_t block = (seed * 2654435761u) % sys->merkle.blocks;
+    uint8_t leaf[MMUKO_MERKLE_LEAF_BYTES];
+    size_t length = mmuko_merkle_leaf(sys, block, leaf);
+    MMUKO_MerkleProof proof;
+    if (!mmuko_merkle_prove(sys, block, &proof) ||
+        !mmuko_merkle_verify(&updated, leaf, length, &proof)) {
+        return false;
+    }
+
+    leaf[length / 2] ^= 0x10;
+    bool caught = !mmuko_merkle_verify(&updated, leaf, length, &proof);
+    leaf[length / 2] ^= 0x10;
+    if (proof.depth > 0) {
+        proof.siblings[proof.depth - 1].bytes[0] ^= 1;
+        caught = caught && !mmuko_merkle_verify(&updated, leaf, length, &proof);
+        proof.siblings[proof.depth - 1].bytes[0] ^= 1;
+    }
+
+    size_t first = block * MMUKO_MERKLE_BLOCK;
+    Cubit *cubit = &sys->memory_map[first].cubit_ring[seed % 8];
+    if (mmuko_verify_region(sys, 0, sys->memory_size) != NSIGII_YES) {
+        return false;
+    }
+    cubit->state ^= 1;
+    caught = caught && mmuko_verify_region(sys, first, first + 1) == NSIGII_NO;
+    cubit->state ^= 1;
+    return caught && mmuko_verify_region(sys, first, first + 1) == NSIGII_YES;
+}
+
+typedef struct {
+    MMUKO_System *sys;
+    size_t first;
+    size_t last;
+} LeafRange;
+
+static void *leaf_worker(void *arg)
+{
+    LeafRange *range = arg;
+    mmuko_checksum_tree_leaves(range->sys, range->first, range->last);
+    return NULL;
+}
+
+// Leaves on `threads` threads in contiguous ranges, then the combine
+static uint32_t parallel_tree_checksum(MMUKO_System *sys, int threads)
+{
+    pthread_t workers[64];
+    LeafRange ranges[64];
+    size_t blocks = sys->checksum.blocks;
+    int started = 0;
+
+    for (int t = 0; t < threads; t++) {
+        ranges[t].sys = sys;
+        ranges[t].first = blocks * (size_t)t / (size_t)threads;
+        ranges[t].last = blocks * (size_t)(t + 1) / (size_t)threads;
+        if (t > 0 && pthread_create(&workers[t], NULL, leaf_worker, &ranges[t]) == 0) {
+            started |= 1 << t;
+        } else {
+            leaf_worker(&ranges[t]);
+        }
+    }
+    for (int t = 1; t < threads; t++) {
+        if (started & (1 << t)) {
+            pthread_join(workers[t], NULL);
+        }
+    }
+    mmuko_checksum_tree_combine(sys);
+    return sys->checksum.nodes[1];
+}
+
+// Legacy chain against serial and parallel tree builds on the booted
+// system; false if the two tree builds disagree
+static bool report_checksum_times(int threads)
+{
+    MMUKO_System *sys = &g_system;
+
+    double start = now_ms();
+    uint32_t legacy = mmuko_memory_checksum(sys);
+    double legacy_ms = now_ms() - start;
+
+    sys->checksum.valid = false;
+    start = now_ms();
+    uint32_t serial = mmuko_tree_checksum(sys);
+    double serial_ms = now_ms() - start;
+
+    start = now_ms();
+    uint32_t parallel = parallel_tree_checksum(sys, threads);
+    double parallel_ms = now_ms() - start;
+
+    start = now_ms();
+    mmuko_write_byte(sys, sys->memory_size / 2, (uint8_t)(sys->memory_map[sys->memory_size / 2].raw_value + 1));
+    double update_us = (now_ms() - start) * 1000.0;
+    mmuko_write_byte(sys, sys->memory_size / 2, (uint8_t)(sys->memory_map[sys->memory_size / 2].raw_value - 1));
+    bool restored = mmuko_tree_checksum(sys) == serial;
+
+    printf("  checksums: legacy=0x%08X %.3f ms  tree=0x%08X %.3f ms, %d threads %.3f ms,"
+           " one-byte update %.2f us\n",
+           legacy, legacy_ms, serial, serial_ms, threads, parallel_ms, update_us);
+    return serial == parallel && restored;
+}
+
+// Full Merkle build against proving and verifying one block
+static void report_merkle_times(void)
+{
+    MMUKO_System *sys = &g_system;
+
+    // report_checksum_times leaves its byte dirty, and dirty blocks are
+    // never hashed
+    mmuko_boot_incremental(sys);
+    merkle_mark_all(sys);
+    double start = now_ms();
+    mmuko_merkle_root(sys);
+    double build_ms = now_ms() - start;
+
+    size_t block = sys->merkle.blocks / 2;
+    uint8_t leaf[MMUKO_MERKLE_LEAF_BYTES];
+    MMUKO_MerkleProof proof;
+    start = now_ms();
+    size_t length = mmuko_merkle_leaf(sys, block, leaf);
+    bool verified = mmuko_merkle_prove(sys, block, &proof) &&
+                    mmuko_merkle_verify(mmuko_merkle_root(sys), leaf, length, &proof);
+    double proof_us = (now_ms() - start) * 1000.0;
+
+    printf("  merkle: %zu blocks, build %.3f ms, depth %u proof %s in %.2f us\n",
+           sys->merkle.blocks, build_ms, proof.depth, verified ? "verified" : "REJECTED", proof_us);
+}
+
+static int parse_sizes(const char *text, size_t *sizes, int max_sizes)
+{
+    int count = 0;
+    char *end;
+
+    while (*text != '\0' && count < max_sizes) {
+        unsigned long value = strtoul(text, &end, 0);
+        if (end == text || value == 0) {
+            return -1;
+        }
+        sizes[count++] = (size_t)value;
+        text = *end == ',' ? end + 1 : end;
+    }
+    return count;
+}
+
+int main(int argc, char **argv)
+{
+    size_t sizes[16] = {1, MMUKO_MEMORY_SIZE, 256, 4096, 65536};
+    int size_count = 5;
+    unsigned long seeds = 4;
+    long threads = sysconf(_SC_NPROCESSORS_ONLN);
+    bool verbose = false;
+    int failures = 0;
+    int runs = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-v") == 0) {
+            verbose = true;
+        } else if (strcmp(argv[i], "--sizes") == 0 && i + 1 < argc) {
+            size_count = parse_sizes(argv[++i], sizes, 16);
+            if (size_count <= 0) {
+                fprintf(stderr, "invalid --sizes list\n");
+                return 2;
+            }
+        } else if (strcmp(argv[i], "--seeds") == 0 && i + 1 < argc) {
+            seeds = strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = strtol(argv[++i], NULL, 0);
+        } else {
+            fprintf(stderr, "Usage: %s [-v] [--sizes N,N,...] [--seeds N] [--threads N]\n",
+                    argv[0]);
+            return 2;
+        }
+    }
+
+    if (threads < 1 || threads > 64) {
+        threads = threads < 1 ? 1 : 64;
+    }
+
+    // The real entry point first, exactly as QEMU runs it
+    host_reset();
+    double start = now_ms();
+    kernel_main(0x2BADB002, 0);
+    bool ok = g_system.boot_complete && check_run(BOOT_OK);
+    printf("kernel_main       size=%-6d seed=0     %s  checksum=0x%08X  %.3f ms\n",
+           MMUKO_MEMORY_SIZE, ok ? "PASS" : "FAIL", mmuko_memory_checksum(&g_system),
+           now_ms() - start);
+    if (verbose) {
+        fwrite(g_serial, 1, g_serial_len, stdout);
+    }
+    failures += ok ? 0 : 1;
+    runs++;
+
+    for (int s = 0; s < size_count; s++) {
+        MMUKO_Byte *memory = calloc(sizes[s], sizeof(MMUKO_Byte));
+        uint32_t *dirty = calloc(MMUKO_DIRTY_WORDS(sizes[s]), sizeof(uint32_t));
+        uint32_t *tree = calloc(MMUKO_CHECKSUM_TREE_WORDS(sizes[s]), sizeof(uint32_t));
+        MMUKO_Digest *merkle = calloc(MMUKO_MERKLE_NODES(sizes[s]), sizeof(MMUKO_Digest));
+        uint32_t *stale = calloc(MMUKO_MERKLE_STALE_WORDS(sizes[s]), sizeof(uint32_t));
+        if (memory == NULL || dirty == NULL || tree == NULL || merkle == NULL || stale == NULL) {
+            fprintf(stderr, "cannot allocate %zu MMUKO bytes\n", sizes[s]);
+            return 1;
+        }
+
+        MMUKO_Storage storage = {memory, dirty, tree, merkle, stale, sizes[s]};
+        for (unsigned long seed = 0; seed <= seeds; seed++) {
+            host_reset();
+            start = now_ms();
+            BootStatus status = mmuko_kernel_run(&storage, (uint32_t)seed);
+            double elapsed = now_ms() - start;
+
+            ok = check_run(status);
+            uint32_t checksum = mmuko_memory_checksum(&g_system);
+            double reverify_us = 0.0;
+            double rehash_us = 0.0;
+            ok = ok && check_incremental((uint32_t)seed, &reverify_us) &&
+                 check_merkle((uint32_t)seed, &rehash_us);
+            printf("mmuko_kernel_run  size=%-6zu seed=%-5lu %s  checksum=0x%08X  %.3f ms"
+                   "  reverify=%.1f us  rehash=%.1f us\n",
+                   sizes[s], seed, ok ? "PASS" : "FAIL", checksum, elapsed, reverify_us, rehash_us);
+            if (!ok && verbose) {
+                fwrite(g_serial, 1, g_serial_len, stdout);
+            }
+            failures += ok ? 0 : 1;
+            runs++;
+        }
+
+        if (!report_checksum_times((int)threads)) {
+            printf("  checksums: FAIL (tree builds or updates disagree)\n");
+            failures++;
+        }
+        report_merkle_times();
+
+        free(memory);
+        free(dirty);
+        free(tree);
+        free(merkle);
+        free(stale);
+    }
+
+    printf("%d runs, %d failed\n", runs, failures);
+    return failures == 0 ? 0 : 1;
+}
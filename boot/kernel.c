@@ -1,5 +1,7 @@
 // MMUKO freestanding QEMU kernel.
 // This file has no libc dependency: no printf, malloc, calloc, or file I/O.
+// With MMUKO_HOSTED it is included by kernel-hosted.c, which supplies the
+// port I/O shims and runs the boot phases as an ordinary process.
 
 #include <stdbool.h>
 #include <stddef.h>
@@ -23,11 +25,50 @@
 #define PHASE_ACTIVE_DONE 0x04
 #define PHASE_VERIFY_DONE 0x08
 
+// Base indices are 1-12; slot 0 is unused
+#define MMUKO_BASE_SLOTS 13
+#define MMUKO_NO_BYTE ((size_t)-1)
+
+// Phase 4 centres every byte on this base's superposition
+#define MMUKO_FRAME_BASE 6
+
+// Dirty tracking: the caller supplies one bit per byte
+// (MMUKO_DIRTY_WORDS(size) words), and the system summarizes it with one
+// bit per power-of-two group of bitmap words that has any bit set
+#define MMUKO_DIRTY_WORDS(size) (((size) + 31) / 32)
+#define MMUKO_DIRTY_GROUPS 4096
+
+// Tree checksum: blocks of MMUKO_CHECKSUM_BLOCK bytes are hashed on their
+// own and combined pairwise up a binary tree in caller storage of
+// MMUKO_CHECKSUM_TREE_WORDS(size) words
+#define MMUKO_CHECKSUM_BLOCK 64
+#define MMUKO_CHECKSUM_BLOCKS(size) (((size) + MMUKO_CHECKSUM_BLOCK - 1) / MMUKO_CHECKSUM_BLOCK)
+#define MMUKO_CHECKSUM_TREE_WORDS(size) (4 * MMUKO_CHECKSUM_BLOCKS(size))
+
+// Merkle tree: SHA-256 over the booted state of MMUKO_MERKLE_BLOCK-byte
+// blocks, in caller storage of MMUKO_MERKLE_NODES(size) digests and
+// MMUKO_MERKLE_STALE_WORDS(size) words of stale-node bits
+#define MMUKO_MERKLE_BLOCK 64
+#define MMUKO_MERKLE_BLOCKS(size) (((size) + MMUKO_MERKLE_BLOCK - 1) / MMUKO_MERKLE_BLOCK)
+#define MMUKO_MERKLE_NODES(size) (4 * MMUKO_MERKLE_BLOCKS(size))
+#define MMUKO_MERKLE_STALE_WORDS(size) ((MMUKO_MERKLE_NODES(size) + 31) / 32)
+#define MMUKO_MERKLE_RECORD 12      // Leaf bytes per memory byte
+#define MMUKO_MERKLE_LEAF_BYTES (MMUKO_MERKLE_BLOCK * MMUKO_MERKLE_RECORD)
+#define MMUKO_MERKLE_MAX_DEPTH 32
+
 #define VGA_WIDTH 80
 #define VGA_HEIGHT 25
-#define VGA_MEMORY ((volatile uint16_t *)0xB8000)
 #define COM1 0x3F8
 
+#ifdef MMUKO_HOSTED
+static volatile uint16_t mmuko_host_vga[VGA_WIDTH * VGA_HEIGHT];
+static void mmuko_host_outb(uint16_t port, uint8_t value);
+static uint8_t mmuko_host_inb(uint16_t port);
+#define VGA_MEMORY (mmuko_host_vga)
+#else
+#define VGA_MEMORY ((volatile uint16_t *)0xB8000)
+#endif
+
 typedef enum {
     N,
     NE,
@@ -72,8 +113,49 @@ typedef struct {
     int base_index;
     Direction primary_superposition;
     Direction secondary_superposition;
+    size_t base_prev;       // Neighbours in this base's bucket, MMUKO_NO_BYTE at the ends
+    size_t base_next;
 } MMUKO_Byte;
 
+// Bytes of each base index as an intrusive list through the memory map, in
+// memory order after phase 1. Needs no storage beyond the map itself
+typedef struct {
+    size_t head[MMUKO_BASE_SLOTS];
+    size_t tail[MMUKO_BASE_SLOTS];
+    size_t count[MMUKO_BASE_SLOTS];
+} MMUKO_BaseIndex;
+
+// Heap order: nodes[1] is the root, node n has children 2n and 2n + 1, and
+// block j's digest is leaf nodes[width + j]
+typedef struct {
+    uint32_t *nodes;            // NULL: no tree checksum for this system
+    size_t blocks;
+    size_t width;               // Leaves, the smallest power of two >= blocks
+    bool valid;                 // Leaves and nodes match memory
+} MMUKO_ChecksumTree;
+
+typedef struct {
+    uint8_t bytes[32];
+} MMUKO_Digest;
+
+// Same heap order as MMUKO_ChecksumTree, with SHA-256 nodes. Nodes are
+// rehashed when a root or proof needs them, not when their block changes
+typedef struct {
+    MMUKO_Digest *nodes;        // NULL: no Merkle tree for this system
+    uint32_t *stale;            // One bit per node whose digest is out of date
+    size_t blocks;
+    size_t width;
+    unsigned int depth;         // log2(width)
+    bool valid;                 // Tracks the last successful boot
+} MMUKO_MerkleTree;
+
+// Sibling digests from a block's leaf up to the root
+typedef struct {
+    size_t block;
+    unsigned int depth;
+    MMUKO_Digest siblings[MMUKO_MERKLE_MAX_DEPTH];
+} MMUKO_MerkleProof;
+
 typedef struct {
     uint16_t gravity_milli;
     uint16_t air_milli;
@@ -88,8 +170,25 @@ typedef struct {
     uint8_t phase_mask;
     uint8_t verification_code;
     bool boot_complete;
+    MMUKO_BaseIndex bases;
+    uint32_t *dirty;                    // One bit per byte written since it was last verified
+    uint32_t dirty_groups[MMUKO_DIRTY_GROUPS / 32];
+    unsigned int group_shift;           // A group is 1 << group_shift words of `dirty`
+    size_t dirty_count;                 // Bytes marked in `dirty`
+    MMUKO_ChecksumTree checksum;
+    MMUKO_MerkleTree merkle;
 } MMUKO_System;
 
+// Caller-owned arrays for one system; the kernel cannot allocate
+typedef struct {
+    MMUKO_Byte *memory;
+    uint32_t *dirty;            // MMUKO_DIRTY_WORDS(memory_size)
+    uint32_t *checksum_tree;    // MMUKO_CHECKSUM_TREE_WORDS(memory_size), or NULL
+    MMUKO_Digest *merkle;       // MMUKO_MERKLE_NODES(memory_size), or NULL
+    uint32_t *merkle_stale;     // MMUKO_MERKLE_STALE_WORDS(memory_size), with merkle
+    size_t memory_size;
+} MMUKO_Storage;
+
 typedef struct {
     int base;
     Direction primary;
@@ -98,6 +197,10 @@ typedef struct {
 
 static MMUKO_System g_system;
 static MMUKO_Byte g_memory[MMUKO_MEMORY_SIZE];
+static uint32_t g_dirty[MMUKO_DIRTY_WORDS(MMUKO_MEMORY_SIZE)];
+static uint32_t g_checksum_tree[MMUKO_CHECKSUM_TREE_WORDS(MMUKO_MEMORY_SIZE)];
+static MMUKO_Digest g_merkle[MMUKO_MERKLE_NODES(MMUKO_MEMORY_SIZE)];
+static uint32_t g_merkle_stale[MMUKO_MERKLE_STALE_WORDS(MMUKO_MEMORY_SIZE)];
 static size_t g_vga_row;
 static size_t g_vga_col;
 static uint8_t g_vga_color = 0x0F;
@@ -133,6 +236,25 @@ static const SuperpositionEntry superposition_table[] = {
     {1, N, S}
 };
 
+// Phase 5 resolves these bases, in this order
+static const int diamond_order[] = {12, 6, 8, 4, 10, 2, 1};
+#define DIAMOND_SIZE (sizeof(diamond_order) / sizeof(diamond_order[0]))
+
+#ifdef MMUKO_HOSTED
+static inline void outb(uint16_t port, uint8_t value)
+{
+    mmuko_host_outb(port, value);
+}
+
+static inline uint8_t inb(uint16_t port)
+{
+    return mmuko_host_inb(port);
+}
+
+static void mmuko_halt(void)
+{
+}
+#else
 static inline void outb(uint16_t port, uint8_t value)
 {
     __asm__ volatile("outb %0, %1" : : "a"(value), "Nd"(port));
@@ -145,6 +267,14 @@ static inline uint8_t inb(uint16_t port)
     return value;
 }
 
+static void mmuko_halt(void)
+{
+    for (;;) {
+        __asm__ volatile("hlt");
+    }
+}
+#endif
+
 static void serial_init(void)
 {
     outb(COM1 + 1, 0x00);
@@ -411,13 +541,668 @@ static Cubit *get_cubit_from_byte(MMUKO_Byte *byte, int index)
     return NULL;
 }
 
+static int base_of_value(uint8_t value)
+{
+    return (value % 12) + 1;
+}
+
+static void base_index_clear(MMUKO_BaseIndex *bases)
+{
+    for (int base = 0; base < MMUKO_BASE_SLOTS; base++) {
+        bases->head[base] = MMUKO_NO_BYTE;
+        bases->tail[base] = MMUKO_NO_BYTE;
+        bases->count[base] = 0;
+    }
+}
+
+static void base_index_link(MMUKO_System *sys, size_t i)
+{
+    MMUKO_BaseIndex *bases = &sys->bases;
+    MMUKO_Byte *byte = &sys->memory_map[i];
+    int base = byte->base_index;
+
+    byte->base_prev = bases->tail[base];
+    byte->base_next = MMUKO_NO_BYTE;
+    if (bases->tail[base] != MMUKO_NO_BYTE) {
+        sys->memory_map[bases->tail[base]].base_next = i;
+    } else {
+        bases->head[base] = i;
+    }
+    bases->tail[base] = i;
+    bases->count[base]++;
+}
+
+static void base_index_unlink(MMUKO_System *sys, size_t i)
+{
+    MMUKO_BaseIndex *bases = &sys->bases;
+    MMUKO_Byte *byte = &sys->memory_map[i];
+    int base = byte->base_index;
+
+    if (byte->base_prev != MMUKO_NO_BYTE) {
+        sys->memory_map[byte->base_prev].base_next = byte->base_next;
+    } else {
+        bases->head[base] = byte->base_next;
+    }
+    if (byte->base_next != MMUKO_NO_BYTE) {
+        sys->memory_map[byte->base_next].base_prev = byte->base_prev;
+    } else {
+        bases->tail[base] = byte->base_prev;
+    }
+    bases->count[base]--;
+}
+
+static void dirty_clear(MMUKO_System *sys)
+{
+    for (size_t w = 0; w < MMUKO_DIRTY_WORDS(sys->memory_size); w++) {
+        sys->dirty[w] = 0;
+    }
+    for (size_t g = 0; g < MMUKO_DIRTY_GROUPS / 32; g++) {
+        sys->dirty_groups[g] = 0;
+    }
+    sys->dirty_count = 0;
+}
+
+static void mark_dirty(MMUKO_System *sys, size_t i)
+{
+    size_t word = i >> 5;
+    uint32_t bit = 1u << (i & 31);
+
+    if ((sys->dirty[word] & bit) == 0) {
+        size_t group = word >> sys->group_shift;
+        sys->dirty[word] |= bit;
+        sys->dirty_groups[group >> 5] |= 1u << (group & 31);
+        sys->dirty_count++;
+    }
+}
+
+static uint32_t rotl32(uint32_t value, unsigned int n)
+{
+    return (value << n) | (value >> (32 - n));
+}
+
+static uint32_t mix32(uint32_t h)
+{
+    h ^= h >> 16;
+    h *= 0x85EBCA6B;
+    h ^= h >> 13;
+    h *= 0xC2B2AE35;
+    h ^= h >> 16;
+    return h;
+}
+
+// Order matters: swapping two subtrees changes the parent
+static uint32_t checksum_combine(uint32_t left, uint32_t right)
+{
+    return mix32(left * 0x9E3779B1 + rotl32(right, 16));
+}
+
+static uint32_t checksum_step(uint32_t h, const MMUKO_Byte *byte)
+{
+    uint32_t k = byte->raw_value | ((uint32_t)byte->base_index << 8);
+    k *= 0xCC9E2D51;
+    k = rotl32(k, 15);
+    k *= 0x1B873593;
+    h ^= k;
+    h = rotl32(h, 13);
+    return h * 5 + 0xE6546B64;
+}
+
+// Bytes ahead of the hash to prefetch: raw_value and base_index sit on
+// different cache lines of each MMUKO_Byte
+#define CHECKSUM_PREFETCH 16
+
+// The legacy checksum's inputs (raw value and base index) for one block,
+// hashed murmur3-style. Blocks depend on nothing else, so any range of them
+// can be hashed on its own core
+static uint32_t checksum_block(const MMUKO_System *sys, size_t block)
+{
+    size_t begin = block * MMUKO_CHECKSUM_BLOCK;
+    size_t end = begin + MMUKO_CHECKSUM_BLOCK;
+    uint32_t h = 0x4D4D554B ^ (uint32_t)block;
+
+    if (end > sys->memory_size) {
+        end = sys->memory_size;
+    }
+    for (size_t i = begin; i < end; i++) {
+        if (i + CHECKSUM_PREFETCH < sys->memory_size) {
+            __builtin_prefetch(&sys->memory_map[i + CHECKSUM_PREFETCH].raw_value);
+            __builtin_prefetch(&sys->memory_map[i + CHECKSUM_PREFETCH].base_index);
+        }
+        h = checksum_step(h, &sys->memory_map[i]);
+    }
+    return mix32(h ^ (uint32_t)(end - begin));
+}
+
+static void mmuko_checksum_tree_init(MMUKO_System *sys, uint32_t *nodes)
+{
+    MMUKO_ChecksumTree *tree = &sys->checksum;
+
+    tree->nodes = nodes;
+    tree->blocks = MMUKO_CHECKSUM_BLOCKS(sys->memory_size);
+    tree->width = 1;
+    while (tree->width < tree->blocks) {
+        tree->width <<= 1;
+    }
+    tree->valid = false;
+}
+
+// Hash blocks [first, last) into their leaves. Disjoint ranges may run
+// concurrently; mmuko_checksum_tree_combine() then builds the rest
+static void mmuko_checksum_tree_leaves(MMUKO_System *sys, size_t first, size_t last)
+{
+    MMUKO_ChecksumTree *tree = &sys->checksum;
+    for (size_t block = first; block < last; block++) {
+        tree->nodes[tree->width + block] = checksum_block(sys, block);
+    }
+}
+
+static void mmuko_checksum_tree_combine(MMUKO_System *sys)
+{
+    MMUKO_ChecksumTree *tree = &sys->checksum;
+
+    for (size_t leaf = tree->blocks; leaf < tree->width; leaf++) {
+        tree->nodes[tree->width + leaf] = 0;
+    }
+    for (size_t node = tree->width - 1; node >= 1; node--) {
+        tree->nodes[node] = checksum_combine(tree->nodes[2 * node], tree->nodes[2 * node + 1]);
+    }
+    tree->valid = true;
+}
+
+// The tree root, rebuilt first if memory changed since the last build
+// other than through mmuko_write_byte()
+static uint32_t mmuko_tree_checksum(MMUKO_System *sys)
+{
+    MMUKO_ChecksumTree *tree = &sys->checksum;
+
+    if (tree->nodes == NULL) {
+        return 0;
+    }
+    if (!tree->valid) {
+        mmuko_checksum_tree_leaves(sys, 0, tree->blocks);
+        mmuko_checksum_tree_combine(sys);
+    }
+    return tree->nodes[1];
+}
+
+// Rehash the byte's block and the log2(blocks) nodes above it
+static void checksum_tree_update(MMUKO_System *sys, size_t i)
+{
+    MMUKO_ChecksumTree *tree = &sys->checksum;
+    if (tree->nodes == NULL || !tree->valid) {
+        return;
+    }
+
+    size_t node = tree->width + i / MMUKO_CHECKSUM_BLOCK;
+    tree->nodes[node] = checksum_block(sys, i / MMUKO_CHECKSUM_BLOCK);
+    for (node >>= 1; node >= 1; node >>= 1) {
+        tree->nodes[node] = checksum_combine(tree->nodes[2 * node], tree->nodes[2 * node + 1]);
+    }
+}
+
+typedef struct {
+    uint32_t state[8];
+    uint32_t length_low;        // Message bytes, as a 64-bit count
+    uint32_t length_high;
+    uint8_t block[64];
+    size_t used;
+} Sha256;
+
+static const uint32_t sha256_k[64] = {
+    0x428A2F98, 0x71374491, 0xB5C0FBCF, 0xE9B5DBA5, 0x3956C25B, 0x59F111F1, 0x923F82A4, 0xAB1C5ED5,
+    0xD807AA98, 0x12835B01, 0x243185BE, 0x550C7DC3, 0x72BE5D74, 0x80DEB1FE, 0x9BDC06A7, 0xC19BF174,
+    0xE49B69C1, 0xEFBE4786, 0x0FC19DC6, 0x240CA1CC, 0x2DE92C6F, 0x4A7484AA, 0x5CB0A9DC, 0x76F988DA,
+    0x983E5152, 0xA831C66D, 0xB00327C8, 0xBF597FC7, 0xC6E00BF3, 0xD5A79147, 0x06CA6351, 0x14292967,
+    0x27B70A85, 0x2E1B2138, 0x4D2C6DFC, 0x53380D13, 0x650A7354, 0x766A0ABB, 0x81C2C92E, 0x92722C85,
+    0xA2BFE8A1, 0xA81A664B, 0xC24B8B70, 0xC76C51A3, 0xD192E819, 0xD6990624, 0xF40E3585, 0x106AA070,
+    0x19A4C116, 0x1E376C08, 0x2748774C, 0x34B0BCB5, 0x391C0CB3, 0x4ED8AA4A, 0x5B9CCA4F, 0x682E6FF3,
+    0x748F82EE, 0x78A5636F, 0x84C87814, 0x8CC70208, 0x90BEFFFA, 0xA4506CEB, 0xBEF9A3F7, 0xC67178F2
+};
+
+static uint32_t rotr32(uint32_t value, unsigned int n)
+{
+    return (value >> n) | (value << (32 - n));
+}
+
+static void sha256_init(Sha256 *ctx)
+{
+    static const uint32_t initial[8] = {
+        0x6A09E667, 0xBB67AE85, 0x3C6EF372, 0xA54FF53A,
+        0x510E527F, 0x9B05688C, 0x1F83D9AB, 0x5BE0CD19
+    };
+    for (int i = 0; i < 8; i++) {
+        ctx->state[i] = initial[i];
+    }
+    ctx->length_low = 0;
+    ctx->length_high = 0;
+    ctx->used = 0;
+}
+
+static void sha256_compress(Sha256 *ctx)
+{
+    uint32_t w[64];
+    for (int i = 0; i < 16; i++) {
+        w[i] = ((uint32_t)ctx->block[4 * i] << 24) | ((uint32_t)ctx->block[4 * i + 1] << 16) |
+               ((uint32_t)ctx->block[4 * i + 2] << 8) | ctx->block[4 * i + 3];
+    }
+    for (int i = 16; i < 64; i++) {
+        uint32_t s0 = rotr32(w[i - 15], 7) ^ rotr32(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        uint32_t s1 = rotr32(w[i - 2], 17) ^ rotr32(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+
+    uint32_t a = ctx->state[0], b = ctx->state[1], c = ctx->state[2], d = ctx->state[3];
+    uint32_t e = ctx->state[4], f = ctx->state[5], g = ctx->state[6], h = ctx->state[7];
+    for (int i = 0; i < 64; i++) {
+        uint32_t t1 = h + (rotr32(e, 6) ^ rotr32(e, 11) ^ rotr32(e, 25)) +
+                      ((e & f) ^ (~e & g)) + sha256_k[i] + w[i];
+        uint32_t t2 = (rotr32(a, 2) ^ rotr32(a, 13) ^ rotr32(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+        h = g;
+        g = f;
+        f = e;
+        e = d + t1;
+        d = c;
+        c = b;
+        b = a;
+        a = t1 + t2;
+    }
+    ctx->state[0] += a;
+    ctx->state[1] += b;
+    ctx->state[2] += c;
+    ctx->state[3] += d;
+    ctx->state[4] += e;
+    ctx->state[5] += f;
+    ctx->state[6] += g;
+    ctx->state[7] += h;
+}
+
+static void sha256_update(Sha256 *ctx, const uint8_t *data, size_t length)
+{
+    for (size_t i = 0; i < length; i++) {
+        ctx->block[ctx->used++] = data[i];
+        if (ctx->used == 64) {
+            sha256_compress(ctx);
+            ctx->used = 0;
+        }
+    }
+    uint32_t low = ctx->length_low + (uint32_t)length;
+    ctx->length_high += low < ctx->length_low;
+    ctx->length_low = low;
+}
+
+static void sha256_final(Sha256 *ctx, MMUKO_Digest *out)
+{
+    uint32_t bits_high = (ctx->length_high << 3) | (ctx->length_low >> 29);
+    uint32_t bits_low = ctx->length_low << 3;
+
+    ctx->block[ctx->used++] = 0x80;
+    if (ctx->used > 56) {
+        while (ctx->used < 64) {
+            ctx->block[ctx->used++] = 0;
+        }
+        sha256_compress(ctx);
+        ctx->used = 0;
+    }
+    while (ctx->used < 56) {
+        ctx->block[ctx->used++] = 0;
+    }
+    for (int i = 0; i < 4; i++) {
+        ctx->block[56 + i] = (uint8_t)(bits_high >> (24 - 8 * i));
+        ctx->block[60 + i] = (uint8_t)(bits_low >> (24 - 8 * i));
+    }
+    sha256_compress(ctx);
+
+    for (int i = 0; i < 8; i++) {
+        for (int j = 0; j < 4; j++) {
+            out->bytes[4 * i + j] = (uint8_t)(ctx->state[i] >> (24 - 8 * j));
+        }
+    }
+}
+
+static bool digest_equal(const MMUKO_Digest *a, const MMUKO_Digest *b)
+{
+    uint8_t diff = 0;
+    for (int i = 0; i < 32; i++) {
+        diff |= a->bytes[i] ^ b->bytes[i];
+    }
+    return diff == 0;
+}
+
+static void digest_clear(MMUKO_Digest *digest)
+{
+    for (int i = 0; i < 32; i++) {
+        digest->bytes[i] = 0;
+    }
+}
+
+// Leaf contents for one block: per byte its raw value, base index,
+// superposition pair, and each cubit's direction | state << 4. Returns the
+// length written to `out` (at most MMUKO_MERKLE_LEAF_BYTES)
+static size_t mmuko_merkle_leaf(const MMUKO_System *sys, size_t block, uint8_t *out)
+{
+    size_t begin = block * MMUKO_MERKLE_BLOCK;
+    size_t end = begin + MMUKO_MERKLE_BLOCK;
+    size_t used = 0;
+
+    if (end > sys->memory_size) {
+        end = sys->memory_size;
+    }
+    for (size_t i = begin; i < end; i++) {
+        const MMUKO_Byte *byte = &sys->memory_map[i];
+        out[used++] = byte->raw_value;
+        out[used++] = (uint8_t)byte->base_index;
+        out[used++] = (uint8_t)byte->primary_superposition;
+        out[used++] = (uint8_t)byte->secondary_superposition;
+        for (int c = 0; c < 8; c++) {
+            out[used++] = (uint8_t)(byte->cubit_ring[c].direction |
+                                    (byte->cubit_ring[c].state << 4));
+        }
+    }
+    return used;
+}
+
+// Leaves and inner nodes hash with different prefixes, so a leaf can never
+// pass for an inner node
+static void merkle_hash_leaf(const uint8_t *leaf, size_t length, MMUKO_Digest *out)
+{
+    static const uint8_t prefix = 0x00;
+    Sha256 ctx;
+    sha256_init(&ctx);
+    sha256_update(&ctx, &prefix, 1);
+    sha256_update(&ctx, leaf, length);
+    sha256_final(&ctx, out);
+}
+
+static void merkle_hash_node(const MMUKO_Digest *left, const MMUKO_Digest *right,
+                             MMUKO_Digest *out)
+{
+    static const uint8_t prefix = 0x01;
+    Sha256 ctx;
+    sha256_init(&ctx);
+    sha256_update(&ctx, &prefix, 1);
+    sha256_update(&ctx, left->bytes, 32);
+    sha256_update(&ctx, right->bytes, 32);
+    sha256_final(&ctx, out);
+}
+
+static void merkle_hash_block(const MMUKO_System *sys, size_t block, MMUKO_Digest *out)
+{
+    uint8_t leaf[MMUKO_MERKLE_LEAF_BYTES];
+    merkle_hash_leaf(leaf, mmuko_merkle_leaf(sys, block, leaf), out);
+}
+
+static void mmuko_merkle_init(MMUKO_System *sys, MMUKO_Digest *nodes, uint32_t *stale)
+{
+    MMUKO_MerkleTree *tree = &sys->merkle;
+
+    tree->nodes = nodes;
+    tree->stale = stale;
+    tree->blocks = MMUKO_MERKLE_BLOCKS(sys->memory_size);
+    tree->width = 1;
+    tree->depth = 0;
+    while (tree->width < tree->blocks) {
+        tree->width <<= 1;
+        tree->depth++;
+    }
+    tree->valid = false;
+}
+
+static bool merkle_node_stale(const MMUKO_MerkleTree *tree, size_t node)
+{
+    return (tree->stale[node >> 5] >> (node & 31)) & 1;
+}
+
+// Every node stale; mmuko_boot() calls this on success, so the tree is
+// hashed at the first root or proof instead of in the boot
+static void merkle_mark_all(MMUKO_System *sys)
+{
+    MMUKO_MerkleTree *tree = &sys->merkle;
+    if (tree->nodes == NULL) {
+        return;
+    }
+
+    for (size_t w = 0; w < MMUKO_MERKLE_STALE_WORDS(sys->memory_size); w++) {
+        tree->stale[w] = 0xFFFFFFFFu;
+    }
+    tree->valid = true;
+}
+
+// Mark one block and its path to the root stale. The ancestors of a
+// stale node are stale already, so the walk stops at the first one
+static void merkle_mark_block(MMUKO_System *sys, size_t block)
+{
+    MMUKO_MerkleTree *tree = &sys->merkle;
+    if (tree->nodes == NULL || !tree->valid) {
+        return;
+    }
+
+    for (size_t node = tree->width + block; node >= 1 && !merkle_node_stale(tree, node); node >>= 1) {
+        tree->stale[node >> 5] |= 1u << (node & 31);
+    }
+}
+
+// True if a byte of the block was written and not yet re-booted
+static bool merkle_block_dirty(const MMUKO_System *sys, size_t block)
+{
+    size_t first = block * MMUKO_MERKLE_BLOCK;
+    size_t last = first + MMUKO_MERKLE_BLOCK;
+    if (last > sys->memory_size) {
+        last = sys->memory_size;
+    }
+
+    for (size_t w = first >> 5; w < (last + 31) >> 5; w++) {
+        if (sys->dirty[w] != 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Rehash the stale nodes under `node`, children first. False if a stale
+// block holds unverified writes: its leaf would vouch for state that
+// mmuko_boot_incremental() has not checked yet
+static bool merkle_refresh(MMUKO_System *sys, size_t node)
+{
+    MMUKO_MerkleTree *tree = &sys->merkle;
+    if (!merkle_node_stale(tree, node)) {
+        return true;
+    }
+
+    if (node >= tree->width) {
+        size_t block = node - tree->width;
+        if (block >= tree->blocks) {
+            digest_clear(&tree->nodes[node]);
+        } else if (merkle_block_dirty(sys, block)) {
+            return false;
+        } else {
+            merkle_hash_block(sys, block, &tree->nodes[node]);
+        }
+    } else {
+        if (!merkle_refresh(sys, 2 * node) || !merkle_refresh(sys, 2 * node + 1)) {
+            return false;
+        }
+        merkle_hash_node(&tree->nodes[2 * node], &tree->nodes[2 * node + 1], &tree->nodes[node]);
+    }
+    tree->stale[node >> 5] &= ~(1u << (node & 31));
+    return true;
+}
+
+// NULL until a boot has set up the tree, or while a block changed since
+// the last root still has unverified writes
+static const MMUKO_Digest *mmuko_merkle_root(MMUKO_System *sys)
+{
+    if (sys->merkle.nodes == NULL || !sys->merkle.valid || !merkle_refresh(sys, 1)) {
+        return NULL;
+    }
+    return &sys->merkle.nodes[1];
+}
+
+static bool mmuko_merkle_prove(MMUKO_System *sys, size_t block, MMUKO_MerkleProof *proof)
+{
+    const MMUKO_MerkleTree *tree = &sys->merkle;
+    if (mmuko_merkle_root(sys) == NULL || block >= tree->blocks) {
+        return false;
+    }
+
+    proof->block = block;
+    proof->depth = tree->depth;
+    size_t node = tree->width + block;
+    for (unsigned int level = 0; level < tree->depth; level++, node >>= 1) {
+        proof->siblings[level] = tree->nodes[node ^ 1];
+    }
+    return true;
+}
+
+// Needs only the root, the leaf contents and the proof, so a remote party
+// holding a trusted root can check a block without the rest of memory
+static bool mmuko_merkle_verify(const MMUKO_Digest *root, const uint8_t *leaf, size_t length,
+                                const MMUKO_MerkleProof *proof)
+{
+    if (proof->depth > MMUKO_MERKLE_MAX_DEPTH) {
+        return false;
+    }
+
+    MMUKO_Digest hash;
+    merkle_hash_leaf(leaf, length, &hash);
+    size_t position = proof->block;
+    for (unsigned int level = 0; level < proof->depth; level++, position >>= 1) {
+        if ((position & 1) == 0) {
+            merkle_hash_node(&hash, &proof->siblings[level], &hash);
+        } else {
+            merkle_hash_node(&proof->siblings[level], &hash, &hash);
+        }
+    }
+    return position == 0 && digest_equal(&hash, root);
+}
+
+// NSIGII check of bytes [first, last) against the root of the last
+// verified boot: O(blocks in range * log blocks), independent of memory size,
+// once the blocks re-booted since the last root are rehashed
+static uint8_t mmuko_verify_region(MMUKO_System *sys, size_t first, size_t last)
+{
+    const MMUKO_Digest *root = mmuko_merkle_root(sys);
+    if (root == NULL || first >= last || last > sys->memory_size) {
+        return NSIGII_MAYBE;
+    }
+
+    uint8_t leaf[MMUKO_MERKLE_LEAF_BYTES];
+    MMUKO_MerkleProof proof;
+    for (size_t block = first / MMUKO_MERKLE_BLOCK; block <= (last - 1) / MMUKO_MERKLE_BLOCK; block++) {
+        size_t length = mmuko_merkle_leaf(sys, block, leaf);
+        if (!mmuko_merkle_prove(sys, block, &proof) ||
+            !mmuko_merkle_verify(root, leaf, length, &proof)) {
+            return NSIGII_NO;
+        }
+    }
+    return NSIGII_YES;
+}
+
+// Store a new raw value after boot. The base bucket moves in O(1) and the
+// byte is marked dirty; its cubit ring is stale until
+// mmuko_boot_incremental() re-runs the phases on it
+static void mmuko_write_byte(MMUKO_System *sys, size_t i, uint8_t value)
+{
+    MMUKO_Byte *byte = &sys->memory_map[i];
+    int base = base_of_value(value);
+
+    byte->raw_value = value;
+    if (base != byte->base_index) {
+        base_index_unlink(sys, i);
+        byte->base_index = base;
+        base_index_link(sys, i);
+    }
+    mark_dirty(sys, i);
+    checksum_tree_update(sys, i);
+}
+
+// Phase 2: false if a cubit is left without a direction
+static bool align_byte(MMUKO_Byte *byte)
+{
+    for (int i = 0; i < 8; i++) {
+        Cubit *c = &byte->cubit_ring[i];
+        if (c->direction == UNDEFINED_DIR) {
+            c->direction = resolve_direction_from_neighbors(byte, i);
+            if (c->direction == UNDEFINED_DIR) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Phase 3
+static void entangle_byte(MMUKO_Byte *byte)
+{
+    for (int i = 0; i < 8; i++) {
+        Cubit *c = &byte->cubit_ring[i];
+        if (c->superposed && c->entangled_with != -1) {
+            Cubit *partner = get_cubit_from_byte(byte, c->entangled_with);
+            if (partner != NULL && c->state == partner->state) {
+                partner->state = flip_state(partner->state);
+            }
+        }
+    }
+}
+
+// Phase 6: false if a cubit does not survive a full rotation
+static bool rotation_free(const MMUKO_Byte *byte)
+{
+    for (int i = 0; i < 8; i++) {
+        uint8_t original = byte->cubit_ring[i].value;
+        uint8_t test_value = rotate_bits(original, 4);
+        test_value = rotate_bits(test_value, 4);
+
+        if (test_value != original) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool is_diamond_base(int base)
+{
+    for (size_t i = 0; i < DIAMOND_SIZE; i++) {
+        if (diamond_order[i] == base) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Phases 1-6 for one byte of a booted system, whose base bucket is current
+static BootStatus boot_byte(MMUKO_Byte *byte)
+{
+    init_cubit_ring(byte);
+    lookup_superposition(byte->base_index, &byte->primary_superposition,
+                         &byte->secondary_superposition);
+
+    if (!align_byte(byte)) {
+        return BOOT_LOCK_DETECTED;
+    }
+    entangle_byte(byte);
+
+    lookup_superposition(MMUKO_FRAME_BASE, &byte->primary_superposition,
+                         &byte->secondary_superposition);
+    if (is_diamond_base(byte->base_index)) {
+        lookup_superposition(byte->base_index, &byte->primary_superposition,
+                             &byte->secondary_superposition);
+    }
+
+    return rotation_free(byte) ? BOOT_OK : BOOT_ROTATION_LOCK;
+}
+
 static BootStatus phase1_cubit_init(MMUKO_System *sys)
 {
     puts_kernel("[SPARSE] Initializing cubit rings...\n");
 
+    base_index_clear(&sys->bases);
+    dirty_clear(sys);
+    sys->checksum.valid = false;
+    sys->merkle.valid = false;
     for (size_t i = 0; i < sys->memory_size; i++) {
         uint8_t value = sys->memory_map[i].raw_value;
-        sys->memory_map[i].base_index = (value % 12) + 1;
+        sys->memory_map[i].base_index = base_of_value(value);
+        base_index_link(sys, i);
 
         init_cubit_ring(&sys->memory_map[i]);
         lookup_superposition(sys->memory_map[i].base_index,
@@ -436,16 +1221,9 @@ static BootStatus phase2_compass_alignment(MMUKO_System *sys)
     puts_kernel("[REMEMBER] Compass alignment...\n");
 
     for (size_t b = 0; b < sys->memory_size; b++) {
-        MMUKO_Byte *byte = &sys->memory_map[b];
-        for (int i = 0; i < 8; i++) {
-            Cubit *c = &byte->cubit_ring[i];
-            if (c->direction == UNDEFINED_DIR) {
-                c->direction = resolve_direction_from_neighbors(byte, i);
-                if (c->direction == UNDEFINED_DIR) {
-                    puts_kernel("[ERROR] Boot lock detected\n");
-                    return BOOT_LOCK_DETECTED;
-                }
-            }
+        if (!align_byte(&sys->memory_map[b])) {
+            puts_kernel("[ERROR] Boot lock detected\n");
+            return BOOT_LOCK_DETECTED;
         }
     }
 
@@ -458,16 +1236,7 @@ static BootStatus phase3_superposition_entanglement(MMUKO_System *sys)
     puts_kernel("[REMEMBER] Entangling superposition pairs...\n");
 
     for (size_t b = 0; b < sys->memory_size; b++) {
-        MMUKO_Byte *byte = &sys->memory_map[b];
-        for (int i = 0; i < 8; i++) {
-            Cubit *c = &byte->cubit_ring[i];
-            if (c->superposed && c->entangled_with != -1) {
-                Cubit *partner = get_cubit_from_byte(byte, c->entangled_with);
-                if (partner != NULL && c->state == partner->state) {
-                    partner->state = flip_state(partner->state);
-                }
-            }
-        }
+        entangle_byte(&sys->memory_map[b]);
     }
 
     puts_kernel("[REMEMBER] Superposition entanglement complete\n");
@@ -480,7 +1249,7 @@ static BootStatus phase4_frame_centering(MMUKO_System *sys)
     Direction secondary;
 
     puts_kernel("[REMEMBER] Frame of reference centering...\n");
-    lookup_superposition(6, &primary, &secondary);
+    lookup_superposition(MMUKO_FRAME_BASE, &primary, &secondary);
     sys->frame_of_reference = primary;
 
     for (size_t i = 0; i < sys->memory_size; i++) {
@@ -496,29 +1265,28 @@ static BootStatus phase4_frame_centering(MMUKO_System *sys)
     return BOOT_OK;
 }
 
+// Walks only this base's bucket, so the seven bases together touch each
+// byte once instead of scanning the map seven times
 static void resolve_base_state(MMUKO_System *sys, int base)
 {
     Direction primary;
     Direction secondary;
     lookup_superposition(base, &primary, &secondary);
 
-    for (size_t i = 0; i < sys->memory_size; i++) {
-        if (sys->memory_map[i].base_index == base) {
-            sys->memory_map[i].primary_superposition = primary;
-            sys->memory_map[i].secondary_superposition = secondary;
-        }
+    for (size_t i = sys->bases.head[base]; i != MMUKO_NO_BYTE;
+         i = sys->memory_map[i].base_next) {
+        sys->memory_map[i].primary_superposition = primary;
+        sys->memory_map[i].secondary_superposition = secondary;
     }
 }
 
 static BootStatus phase5_nonlinear_resolution(MMUKO_System *sys)
 {
-    static const int boot_order[] = {12, 6, 8, 4, 10, 2, 1};
-
     puts_kernel("[ACTIVE] Nonlinear index resolution...\n");
-    for (size_t i = 0; i < sizeof(boot_order) / sizeof(boot_order[0]); i++) {
+    for (size_t i = 0; i < DIAMOND_SIZE; i++) {
         Direction primary;
         Direction secondary;
-        int base = boot_order[i];
+        int base = diamond_order[i];
 
         resolve_base_state(sys, base);
         lookup_superposition(base, &primary, &secondary);
@@ -540,16 +1308,9 @@ static BootStatus phase6_rotation_verification(MMUKO_System *sys)
     puts_kernel("[VERIFY] Rotation freedom check...\n");
 
     for (size_t b = 0; b < sys->memory_size; b++) {
-        MMUKO_Byte *byte = &sys->memory_map[b];
-        for (int i = 0; i < 8; i++) {
-            uint8_t original = byte->cubit_ring[i].value;
-            uint8_t test_value = rotate_bits(original, 4);
-            test_value = rotate_bits(test_value, 4);
-
-            if (test_value != original) {
-                puts_kernel("[ERROR] Rotation lock detected\n");
-                return BOOT_ROTATION_LOCK;
-            }
+        if (!rotation_free(&sys->memory_map[b])) {
+            puts_kernel("[ERROR] Rotation lock detected\n");
+            return BOOT_ROTATION_LOCK;
         }
     }
 
@@ -557,7 +1318,10 @@ static BootStatus phase6_rotation_verification(MMUKO_System *sys)
     return BOOT_OK;
 }
 
-static void mmuko_system_init(MMUKO_System *sys, MMUKO_Byte *memory, size_t memory_size)
+// seed 0 keeps the fixed boot pattern; any other seed fills memory from a
+// xorshift32 stream so the hosted harness can sweep inputs.
+static void mmuko_system_init(MMUKO_System *sys, MMUKO_Byte *memory, uint32_t *dirty,
+                              size_t memory_size, uint32_t seed)
 {
     sys->memory_map = memory;
     sys->memory_size = memory_size;
@@ -566,8 +1330,25 @@ static void mmuko_system_init(MMUKO_System *sys, MMUKO_Byte *memory, size_t memo
     sys->verification_code = NSIGII_MAYBE;
     sys->boot_complete = false;
 
+    // Smallest power-of-two group that keeps the bitmap within the summary
+    sys->dirty = dirty;
+    sys->checksum.nodes = NULL;
+    sys->merkle.nodes = NULL;
+    sys->group_shift = 0;
+    while ((MMUKO_DIRTY_WORDS(memory_size) >> sys->group_shift) > MMUKO_DIRTY_GROUPS) {
+        sys->group_shift++;
+    }
+    dirty_clear(sys);
+
     for (size_t i = 0; i < memory_size; i++) {
-        memory[i].raw_value = (uint8_t)(i * 17 + 42);
+        if (seed == 0) {
+            memory[i].raw_value = (uint8_t)(i * 17 + 42);
+        } else {
+            seed ^= seed << 13;
+            seed ^= seed >> 17;
+            seed ^= seed << 5;
+            memory[i].raw_value = (uint8_t)(seed >> 24);
+        }
     }
 }
 
@@ -720,6 +1501,8 @@ static BootStatus mmuko_boot(MMUKO_System *sys)
         return status;
     }
 
+    merkle_mark_all(sys);
+
     puts_kernel("\n=== BOOT SUCCESS ===\n");
     puts_kernel("NSIGII_VERIFIED\n");
     puts_kernel("BOOT_SUCCESS\n");
@@ -727,6 +1510,74 @@ static BootStatus mmuko_boot(MMUKO_System *sys)
     return BOOT_OK;
 }
 
+// Re-run phases 1-6 and the NSIGII check on the bytes written since the
+// last boot, instead of the whole map. A system that has not booted, or
+// whose last incremental pass failed, gets a full boot
+static BootStatus mmuko_boot_incremental(MMUKO_System *sys)
+{
+    if (!sys->boot_complete) {
+        return mmuko_boot(sys);
+    }
+
+    BootStatus status = BOOT_OK;
+    size_t bytes = 0;
+    size_t words = MMUKO_DIRTY_WORDS(sys->memory_size);
+
+    for (size_t g = 0; g < MMUKO_DIRTY_GROUPS / 32 && status == BOOT_OK; g++) {
+        while (sys->dirty_groups[g] != 0 && status == BOOT_OK) {
+            size_t group = g * 32 + (size_t)__builtin_ctz(sys->dirty_groups[g]);
+            size_t first = group << sys->group_shift;
+            size_t last = first + ((size_t)1 << sys->group_shift);
+            if (last > words) {
+                last = words;
+            }
+
+            for (size_t w = first; w < last && status == BOOT_OK; w++) {
+                while (sys->dirty[w] != 0) {
+                    size_t i = w * 32 + (size_t)__builtin_ctz(sys->dirty[w]);
+                    status = boot_byte(&sys->memory_map[i]);
+                    if (status != BOOT_OK) {
+                        break;
+                    }
+                    merkle_mark_block(sys, i / MMUKO_MERKLE_BLOCK);
+                    sys->dirty[w] &= sys->dirty[w] - 1;
+                    sys->dirty_count--;
+                    bytes++;
+                }
+            }
+            if (status == BOOT_OK) {
+                sys->dirty_groups[g] &= sys->dirty_groups[g] - 1;
+            }
+        }
+    }
+
+    if (status != BOOT_OK) {
+        // Same phase bookkeeping as a full boot that failed here
+        sys->phase_mask &= (uint8_t)~(status == BOOT_LOCK_DETECTED ? PHASE_REMEMBER_DONE
+                                                                   : PHASE_VERIFY_DONE);
+        sys->boot_complete = false;
+        sys->merkle.valid = false;
+        sys->verification_code = nsigii_verify_system(sys);
+        puts_kernel(status == BOOT_LOCK_DETECTED ? "[ERROR] Boot lock detected\n"
+                                                 : "[ERROR] Rotation lock detected\n");
+        return status;
+    }
+
+    sys->verification_code = nsigii_verify_system(sys);
+    puts_kernel("[INCREMENTAL] Re-verified ");
+    put_dec_u32((uint32_t)bytes);
+    puts_kernel(" dirty bytes, NSIGII code: ");
+    put_hex_u32(sys->verification_code);
+    puts_kernel("\n");
+
+    if (sys->verification_code != NSIGII_YES) {
+        sys->boot_complete = false;
+        sys->merkle.valid = false;
+        return BOOT_FAILED;
+    }
+    return BOOT_OK;
+}
+
 static void mmuko_print_cubit_state(MMUKO_System *sys, size_t byte_index, int cubit_index)
 {
     if (byte_index >= sys->memory_size || cubit_index < 0 || cubit_index >= 8) {
@@ -749,6 +1600,7 @@ static void mmuko_print_cubit_state(MMUKO_System *sys, size_t byte_index, int cu
     puts_kernel("\n");
 }
 
+// Legacy checksum: one rotate-xor-add chain over every byte in order
 static uint32_t mmuko_memory_checksum(const MMUKO_System *sys)
 {
     uint32_t checksum = 0x4D4D554B;
@@ -768,8 +1620,7 @@ static void mmuko_program_main(MMUKO_System *sys)
     puts_kernel("[PROGRAM] Hello from a program launched by mmuko_boot.\n");
 
     uint8_t before = sys->memory_map[0].raw_value;
-    sys->memory_map[0].raw_value = rotate_bits(before, 1);
-    init_cubit_ring(&sys->memory_map[0]);
+    mmuko_write_byte(sys, 0, rotate_bits(before, 1));
 
     puts_kernel("[PROGRAM] Rotated byte 0: ");
     put_hex_u32(before);
@@ -777,20 +1628,41 @@ static void mmuko_program_main(MMUKO_System *sys)
     put_hex_u32(sys->memory_map[0].raw_value);
     puts_kernel("\n");
 
+    if (mmuko_boot_incremental(sys) != BOOT_OK) {
+        puts_kernel("[PROGRAM] Re-verification failed\n");
+    }
+
     puts_kernel("[PROGRAM] Memory checksum: ");
     put_hex_u32(mmuko_memory_checksum(sys));
     puts_kernel("\n");
+    if (sys->checksum.nodes != NULL) {
+        puts_kernel("[PROGRAM] Tree checksum: ");
+        put_hex_u32(mmuko_tree_checksum(sys));
+        puts_kernel("\n");
+    }
+
+    // Prove byte 0's block against the root, as a remote verifier would
+    const MMUKO_Digest *root = mmuko_merkle_root(sys);
+    if (root != NULL) {
+        puts_kernel("[PROGRAM] Merkle root: ");
+        for (int i = 0; i < 8; i++) {
+            put_char("0123456789abcdef"[root->bytes[i] >> 4]);
+            put_char("0123456789abcdef"[root->bytes[i] & 0xF]);
+        }
+        puts_kernel("...\n[PROGRAM] Byte 0 inclusion proof (");
+        put_dec_u32(sys->merkle.depth);
+        puts_kernel(" hashes), NSIGII code: ");
+        put_hex_u32(mmuko_verify_region(sys, 0, 1));
+        puts_kernel("\n");
+    }
 
     mmuko_print_cubit_state(sys, 0, 0);
     mmuko_print_cubit_state(sys, 0, 2);
     puts_kernel("=== MMUKO PROGRAM END ===\n");
 }
 
-void kernel_main(uint32_t multiboot_magic, uint32_t multiboot_info)
+static BootStatus mmuko_kernel_run(const MMUKO_Storage *storage, uint32_t seed)
 {
-    (void)multiboot_magic;
-    (void)multiboot_info;
-
     serial_init();
     vga_clear();
 
@@ -800,7 +1672,13 @@ void kernel_main(uint32_t multiboot_magic, uint32_t multiboot_info)
         puts_kernel("OBIELF mode: executable-first package, linkable-next handoff\n");
     }
 
-    mmuko_system_init(&g_system, g_memory, MMUKO_MEMORY_SIZE);
+    mmuko_system_init(&g_system, storage->memory, storage->dirty, storage->memory_size, seed);
+    if (storage->checksum_tree != NULL) {
+        mmuko_checksum_tree_init(&g_system, storage->checksum_tree);
+    }
+    if (storage->merkle != NULL) {
+        mmuko_merkle_init(&g_system, storage->merkle, storage->merkle_stale);
+    }
     BootStatus status = mmuko_boot(&g_system);
 
     if (status == BOOT_OK) {
@@ -815,7 +1693,17 @@ void kernel_main(uint32_t multiboot_magic, uint32_t multiboot_info)
         puts_kernel("\n");
     }
 
-    for (;;) {
-        __asm__ volatile("hlt");
-    }
+    return status;
+}
+
+void kernel_main(uint32_t multiboot_magic, uint32_t multiboot_info)
+{
+    (void)multiboot_magic;
+    (void)multiboot_info;
+
+    static const MMUKO_Storage storage = {
+        g_memory, g_dirty, g_checksum_tree, g_merkle, g_merkle_stale, MMUKO_MEMORY_SIZE
+    };
+    mmuko_kernel_run(&storage, 0);
+    mmuko_halt();
 }
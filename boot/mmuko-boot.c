@@ -6,7 +6,7 @@
 // Version: 0.1-implementation
 // ============================================================
 //
-// Compile with `gcc -o mmuko-boot mmuko-boot.c`
+// Build with `make -C boot mmuko-boot` (host compiler)
 // MMUKO: Nonlinear, nonpolar OS boot model
 // Core principle: every bit has a spin, a compass direction,
 // and a superposition state. Boot = resolving all states
@@ -19,6 +19,11 @@
 #include <stdbool.h>
 #include <string.h>
 #include <math.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "mmuko-boot.h"
 
 // ─────────────────────────────────────────────
 // CONSTANTS & DEFINITIONS
@@ -43,73 +48,6 @@
 #define SPIN_WEST       (PI / 3.0)         // dual with NORTHEAST
 #define SPIN_NORTHWEST  (PI / 4.0)         // dual with NORTH
 
-// ─────────────────────────────────────────────
-// ENUMERATIONS
-// ─────────────────────────────────────────────
-
-typedef enum {
-    N, NE, E, SE, S, SW, W, NW, UNDEFINED_DIR
-} Direction;
-
-typedef enum {
-    UP, DOWN, CHARM, STRANGE, LEFT, RIGHT
-} State;
-
-typedef enum {
-    RSHIFT, LSHIFT, ROTATE
-} ShiftOp;
-
-typedef enum {
-    BOOT_OK,
-    BOOT_LOCK_DETECTED,
-    BOOT_ROTATION_LOCK,
-    BOOT_UNDEFINED_DIRECTION,
-    BOOT_FAILED
-} BootStatus;
-
-// ─────────────────────────────────────────────
-// STRUCTURES
-// ─────────────────────────────────────────────
-
-typedef struct {
-    int index;              // 0–7
-    uint8_t value;          // 0 or 1
-    double spin;            // derived from compass direction
-    Direction direction;    // compass direction
-    State state;            // quantum-like state
-    bool superposed;        // is this cubit in superposition?
-    int entangled_with;     // index of entangled partner (-1 if none)
-} Cubit;
-
-typedef struct {
-    uint8_t raw_value;
-    Cubit cubit_ring[8];
-    int base_index;
-    Direction primary_superposition;
-    Direction secondary_superposition;
-} MMUKO_Byte;
-
-typedef struct {
-    double gravity;
-    double air;
-    double water;
-} VacuumMedium;
-
-typedef struct {
-    MMUKO_Byte* memory_map;
-    size_t memory_size;
-    VacuumMedium medium;
-    Direction frame_of_reference;
-    bool boot_complete;
-} MMUKO_System;
-
-// Superposition lookup entry
-typedef struct {
-    int base;
-    Direction primary;
-    Direction secondary;
-} SuperpositionEntry;
-
 // ─────────────────────────────────────────────
 // GLOBAL LOOKUP TABLE (Weak Map Implementation)
 // ─────────────────────────────────────────────
@@ -156,7 +94,10 @@ static const double spin_values[] = {
 };
 
 // Entanglement pairs: index → entangled partner index
-static const int entangled_pairs[] = {7, 6, 5, -1, -1, 2, 1, 0};
+const int mmuko_entangled_pairs[8] = {7, 6, 5, -1, -1, 2, 1, 0};
+
+// Diamond traversal order of phase 5
+const int mmuko_diamond_order[MMUKO_DIAMOND_SIZE] = {12, 6, 8, 4, 10, 2, 1};
 
 // ─────────────────────────────────────────────
 // PHASE 0: VACUUM MEDIUM INITIALIZATION
@@ -168,7 +109,6 @@ VacuumMedium init_vacuum_medium(void) {
         .air = 0.0,
         .water = 0.0
     };
-    printf("[PHASE 0] Vacuum medium initialized: G=%.4f\n", medium.gravity);
     return medium;
 }
 
@@ -196,11 +136,76 @@ void init_cubit_ring(MMUKO_Byte* byte) {
         c->spin = spin_values[i];
         c->direction = directions[i];
         c->state = resolve_state(i, byte->raw_value);
-        c->entangled_with = entangled_pairs[i];
-        c->superposed = (entangled_pairs[i] != -1);
+        c->entangled_with = mmuko_entangled_pairs[i];
+        c->superposed = (mmuko_entangled_pairs[i] != -1);
     }
 }
 
+// ─────────────────────────────────────────────
+// CANONICAL RING TABLE (Flyweight)
+// ─────────────────────────────────────────────
+
+// A phase-1 ring depends only on raw_value (base index: raw % 12 + 1, then
+// the superposition lookup), so all 256 possible rings are built here by
+// the compiler. mmuko_canonical_rings_verify() checks them against
+// init_cubit_ring() and lookup_superposition()
+
+#define RING_BIT(v, i)      (((v) >> ((i) & 7)) & 1)
+#define RING_STATE(v, i)    (RING_BIT(v, i) ? (RING_BIT(v, (i) + 1) ? UP : CHARM) \
+                                            : (RING_BIT(v, (i) + 1) ? STRANGE : DOWN))
+#define RING_PARTNER(i)     ((i) == 3 || (i) == 4 ? -1 : 7 - (i))
+#define RING_SPIN(i)        ((i) == 0 ? SPIN_NORTH : (i) == 1 ? SPIN_NORTHEAST : \
+                             (i) == 2 ? SPIN_EAST : (i) == 3 ? SPIN_SOUTHEAST : \
+                             (i) == 4 ? SPIN_SOUTH : (i) == 5 ? SPIN_SOUTHWEST : \
+                             (i) == 6 ? SPIN_WEST : SPIN_NORTHWEST)
+
+#define RING_CUBIT(v, i) \
+    { (i), RING_BIT(v, i), RING_SPIN(i), (Direction)(i), RING_STATE(v, i), \
+      RING_PARTNER(i) != -1, RING_PARTNER(i) }
+
+#define RING(v) \
+    { (v), { RING_CUBIT(v, 0), RING_CUBIT(v, 1), RING_CUBIT(v, 2), RING_CUBIT(v, 3), \
+             RING_CUBIT(v, 4), RING_CUBIT(v, 5), RING_CUBIT(v, 6), RING_CUBIT(v, 7) }, \
+      MMUKO_RING_BASE(v), MMUKO_BASE_PRIMARY(MMUKO_RING_BASE(v)), \
+      MMUKO_BASE_SECONDARY(MMUKO_RING_BASE(v)) }
+
+#define RING4(v)    RING(v), RING((v) + 1), RING((v) + 2), RING((v) + 3)
+#define RING16(v)   RING4(v), RING4((v) + 4), RING4((v) + 8), RING4((v) + 12)
+#define RING64(v)   RING16(v), RING16((v) + 16), RING16((v) + 32), RING16((v) + 48)
+
+const MMUKO_Byte mmuko_canonical_rings[256] = {
+    RING64(0), RING64(64), RING64(128), RING64(192)
+};
+
+bool mmuko_canonical_rings_verify(void) {
+    for (int v = 0; v < 256; v++) {
+        MMUKO_Byte expected;
+        memset(&expected, 0, sizeof(expected));
+        expected.raw_value = (uint8_t)v;
+        expected.base_index = (v % 12) + 1;
+        init_cubit_ring(&expected);
+        lookup_superposition(expected.base_index, &expected.primary_superposition,
+                             &expected.secondary_superposition);
+
+        const MMUKO_Byte* ring = &mmuko_canonical_rings[v];
+        if (ring->raw_value != expected.raw_value || ring->base_index != expected.base_index ||
+            ring->primary_superposition != expected.primary_superposition ||
+            ring->secondary_superposition != expected.secondary_superposition) {
+            return false;
+        }
+        for (int i = 0; i < 8; i++) {
+            const Cubit* a = &ring->cubit_ring[i];
+            const Cubit* b = &expected.cubit_ring[i];
+            if (a->index != b->index || a->value != b->value || a->spin != b->spin ||
+                a->direction != b->direction || a->state != b->state ||
+                a->superposed != b->superposed || a->entangled_with != b->entangled_with) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
 // ─────────────────────────────────────────────
 // SUPERPOSITION LOOKUP (Weak Map)
 // ─────────────────────────────────────────────
@@ -295,24 +300,29 @@ Direction resolve_direction_from_neighbors(MMUKO_Byte* byte, int cubit_index) {
     return max_dir;
 }
 
+int mmuko_ring_align(MMUKO_Byte* byte) {
+    for (int i = 0; i < 8; i++) {
+        Cubit* c = &byte->cubit_ring[i];
+        if (c->direction == UNDEFINED_DIR) {
+            c->direction = resolve_direction_from_neighbors(byte, i);
+            if (c->direction == UNDEFINED_DIR) return i;
+        }
+    }
+    return -1;
+}
+
 BootStatus phase2_compass_alignment(MMUKO_System* sys) {
-    printf("[PHASE 2] Compass alignment...\n");
+    MMUKO_LOG(sys, "[PHASE 2] Compass alignment...\n");
 
     for (size_t b = 0; b < sys->memory_size; b++) {
-        MMUKO_Byte* byte = &sys->memory_map[b];
-        for (int i = 0; i < 8; i++) {
-            Cubit* c = &byte->cubit_ring[i];
-            if (c->direction == UNDEFINED_DIR) {
-                c->direction = resolve_direction_from_neighbors(byte, i);
-                if (c->direction == UNDEFINED_DIR) {
-                    printf("[ERROR] Boot lock detected at byte %zu, cubit %d\n", b, i);
-                    return BOOT_LOCK_DETECTED;
-                }
-            }
+        int cubit = mmuko_ring_align(&sys->memory_map[b]);
+        if (cubit >= 0) {
+            MMUKO_LOG(sys, "[ERROR] Boot lock detected at byte %zu, cubit %d\n", b, cubit);
+            return BOOT_LOCK_DETECTED;
         }
     }
 
-    printf("[PHASE 2] All cubits aligned to compass directions\n");
+    MMUKO_LOG(sys, "[PHASE 2] All cubits aligned to compass directions\n");
     return BOOT_OK;
 }
 
@@ -339,26 +349,37 @@ Cubit* get_cubit_from_byte(MMUKO_Byte* byte, int index) {
     return NULL;
 }
 
+uint8_t mmuko_ring_entangle(MMUKO_Byte* byte) {
+    uint8_t resolved = 0;
+    for (int i = 0; i < 8; i++) {
+        Cubit* c = &byte->cubit_ring[i];
+        if (c->superposed && c->entangled_with != -1) {
+            Cubit* partner = get_cubit_from_byte(byte, c->entangled_with);
+            if (partner && c->state == partner->state) {
+                // Constructive interference — RESOLVE by flipping partner
+                partner->state = flip_state(partner->state);
+                resolved |= (uint8_t)(1u << i);
+            }
+        }
+    }
+    return resolved;
+}
+
 BootStatus phase3_superposition_entanglement(MMUKO_System* sys) {
-    printf("[PHASE 3] Entangling superposition pairs...\n");
+    MMUKO_LOG(sys, "[PHASE 3] Entangling superposition pairs...\n");
 
     for (size_t b = 0; b < sys->memory_size; b++) {
         MMUKO_Byte* byte = &sys->memory_map[b];
-        for (int i = 0; i < 8; i++) {
-            Cubit* c = &byte->cubit_ring[i];
-            if (c->superposed && c->entangled_with != -1) {
-                Cubit* partner = get_cubit_from_byte(byte, c->entangled_with);
-                if (partner && c->state == partner->state) {
-                    // Constructive interference — RESOLVE by flipping partner
-                    partner->state = flip_state(partner->state);
-                    printf("[PHASE 3] Resolved interference at byte %zu, pair (%d, %d)\n", 
-                           b, i, c->entangled_with);
-                }
+        uint8_t resolved = mmuko_ring_entangle(byte);
+        for (int i = 0; resolved != 0; i++, resolved >>= 1) {
+            if (resolved & 1) {
+                MMUKO_LOG(sys, "[PHASE 3] Resolved interference at byte %zu, pair (%d, %d)\n", 
+                       b, i, byte->cubit_ring[i].entangled_with);
             }
         }
     }
 
-    printf("[PHASE 3] Superposition entanglement complete\n");
+    MMUKO_LOG(sys, "[PHASE 3] Superposition entanglement complete\n");
     return BOOT_OK;
 }
 
@@ -374,11 +395,11 @@ int get_middle_base(void) {
 
 void set_frame_of_reference(MMUKO_System* sys, Direction center_dir) {
     sys->frame_of_reference = center_dir;
-    printf("[PHASE 4] Frame of reference set to %s\n", direction_to_string(center_dir));
+    MMUKO_LOG(sys, "[PHASE 4] Frame of reference set to %s\n", direction_to_string(center_dir));
 }
 
 BootStatus phase4_frame_centering(MMUKO_System* sys) {
-    printf("[PHASE 4] Frame of reference centering...\n");
+    MMUKO_LOG(sys, "[PHASE 4] Frame of reference centering...\n");
 
     int center_base = get_middle_base();
     Direction primary, secondary;
@@ -413,18 +434,14 @@ void resolve_base_state(MMUKO_System* sys, int base) {
 }
 
 BootStatus phase5_nonlinear_resolution(MMUKO_System* sys) {
-    printf("[PHASE 5] Nonlinear index resolution (diamond table)...\n");
-
-    // Diamond traversal order
-    const int boot_order[] = {12, 6, 8, 4, 10, 2, 1};
-    const int boot_order_size = sizeof(boot_order) / sizeof(int);
+    MMUKO_LOG(sys, "[PHASE 5] Nonlinear index resolution (diamond table)...\n");
 
-    for (int i = 0; i < boot_order_size; i++) {
-        int base = boot_order[i];
+    for (int i = 0; i < MMUKO_DIAMOND_SIZE; i++) {
+        int base = mmuko_diamond_order[i];
         resolve_base_state(sys, base);
         Direction primary, secondary;
         lookup_superposition(base, &primary, &secondary);
-        printf("[PHASE 5] Base %d resolved → %s/%s\n", 
+        MMUKO_LOG(sys, "[PHASE 5] Base %d resolved → %s/%s\n", 
                base, direction_to_string(primary), direction_to_string(secondary));
     }
 
@@ -435,24 +452,29 @@ BootStatus phase5_nonlinear_resolution(MMUKO_System* sys) {
 // PHASE 6: ROTATION VERIFICATION
 // ─────────────────────────────────────────────
 
+int mmuko_ring_rotation_lock(const MMUKO_Byte* byte) {
+    for (int i = 0; i < 8; i++) {
+        uint8_t original = byte->cubit_ring[i].value;
+        uint8_t test_val = rotate_bits(original, 4);   // half rotation
+        test_val = rotate_bits(test_val, 4);           // full rotation
+
+        if (test_val != original) return i;
+    }
+    return -1;
+}
+
 BootStatus phase6_rotation_verification(MMUKO_System* sys) {
-    printf("[PHASE 6] Rotation freedom check...\n");
+    MMUKO_LOG(sys, "[PHASE 6] Rotation freedom check...\n");
 
     for (size_t b = 0; b < sys->memory_size; b++) {
-        MMUKO_Byte* byte = &sys->memory_map[b];
-        for (int i = 0; i < 8; i++) {
-            uint8_t original = byte->cubit_ring[i].value;
-            uint8_t test_val = rotate_bits(original, 4);   // half rotation
-            test_val = rotate_bits(test_val, 4);           // full rotation
-
-            if (test_val != original) {
-                printf("[ERROR] Rotation lock at byte %zu, cubit %d\n", b, i);
-                return BOOT_ROTATION_LOCK;
-            }
+        int cubit = mmuko_ring_rotation_lock(&sys->memory_map[b]);
+        if (cubit >= 0) {
+            MMUKO_LOG(sys, "[ERROR] Rotation lock at byte %zu, cubit %d\n", b, cubit);
+            return BOOT_ROTATION_LOCK;
         }
     }
 
-    printf("[PHASE 6] All cubits rotate freely (360° verified)\n");
+    MMUKO_LOG(sys, "[PHASE 6] All cubits rotate freely (360° verified)\n");
     return BOOT_OK;
 }
 
@@ -461,21 +483,14 @@ BootStatus phase6_rotation_verification(MMUKO_System* sys) {
 // ─────────────────────────────────────────────
 
 BootStatus phase1_cubit_init(MMUKO_System* sys) {
-    printf("[PHASE 1] Initializing cubit rings...\n");
+    MMUKO_LOG(sys, "[PHASE 1] Initializing cubit rings...\n");
 
+    // Each ring is a pure function of its raw value: copy the canonical one
     for (size_t i = 0; i < sys->memory_size; i++) {
-        // Calculate base index from raw value
-        uint8_t val = sys->memory_map[i].raw_value;
-        // Simple base calculation: map 0-255 to 1-12 scale
-        sys->memory_map[i].base_index = (val % 12) + 1;
-
-        init_cubit_ring(&sys->memory_map[i]);
-        lookup_superposition(sys->memory_map[i].base_index,
-                           &sys->memory_map[i].primary_superposition,
-                           &sys->memory_map[i].secondary_superposition);
+        sys->memory_map[i] = mmuko_canonical_rings[sys->memory_map[i].raw_value];
     }
 
-    printf("[PHASE 1] Initialized %zu cubit rings\n", sys->memory_size);
+    MMUKO_LOG(sys, "[PHASE 1] Initialized %zu cubit rings\n", sys->memory_size);
     return BOOT_OK;
 }
 
@@ -483,82 +498,193 @@ BootStatus phase1_cubit_init(MMUKO_System* sys) {
 // MAIN BOOT SEQUENCE
 // ─────────────────────────────────────────────
 
-BootStatus mmuko_boot(MMUKO_System* sys) {
-    printf("\n=== MMUKO BOOT SEQUENCE v%s ===\n\n", MMUKO_VERSION);
+// Phases 1–6 over MMUKO_LAYOUT_RINGS
+static const MMUKO_PhaseFn ring_phases[MMUKO_PHASE_COUNT] = {
+    phase1_cubit_init,                  // PHASE 1: Cubit Ring Init
+    phase2_compass_alignment,           // PHASE 2: Compass Alignment
+    phase3_superposition_entanglement,  // PHASE 3: Superposition Entanglement
+    phase4_frame_centering,             // PHASE 4: Frame Centering
+    phase5_nonlinear_resolution,        // PHASE 5: Nonlinear Resolution
+    phase6_rotation_verification        // PHASE 6: Rotation Verification
+};
 
-    BootStatus status;
+BootStatus mmuko_boot(MMUKO_System* sys) {
+    MMUKO_LOG(sys, "\n=== MMUKO BOOT SEQUENCE v%s ===\n\n", MMUKO_VERSION);
 
     // PHASE 0: Vacuum Medium
     sys->medium = init_vacuum_medium();
+    MMUKO_LOG(sys, "[PHASE 0] Vacuum medium initialized: G=%.4f\n", sys->medium.gravity);
+
+    // PHASES 1–6, on whichever layout the system was created with
+    const MMUKO_PhaseFn* phases =
+        sys->layout == MMUKO_LAYOUT_PLANES ? mmuko_plane_phases :
+        sys->layout == MMUKO_LAYOUT_FLYWEIGHT ? mmuko_flyweight_phases :
+        sys->pool ? mmuko_parallel_phases : ring_phases;
+
+    // A checkpoint may already hold the first phases, or their failure
+    int first = 0;
+    if (sys->checkpoint) {
+        BootStatus restored = BOOT_OK;
+        first = mmuko_checkpoint_restore(sys, &restored);
+        if (restored != BOOT_OK) return restored;
+    }
 
-    // PHASE 1: Cubit Ring Init
-    status = phase1_cubit_init(sys);
-    if (status != BOOT_OK) return status;
-
-    // PHASE 2: Compass Alignment
-    status = phase2_compass_alignment(sys);
-    if (status != BOOT_OK) return status;
-
-    // PHASE 3: Superposition Entanglement
-    status = phase3_superposition_entanglement(sys);
-    if (status != BOOT_OK) return status;
-
-    // PHASE 4: Frame Centering
-    status = phase4_frame_centering(sys);
-    if (status != BOOT_OK) return status;
-
-    // PHASE 5: Nonlinear Resolution
-    status = phase5_nonlinear_resolution(sys);
-    if (status != BOOT_OK) return status;
-
-    // PHASE 6: Rotation Verification
-    status = phase6_rotation_verification(sys);
-    if (status != BOOT_OK) return status;
+    // The fused pass covers all six; a fault replays them phase by phase.
+    // Checkpoints are taken between phases, so they always run phased
+    if (sys->checkpoint || !(sys->fused && mmuko_fused_phases(sys))) {
+        for (int p = first; p < MMUKO_PHASE_COUNT; p++) {
+            BootStatus status = phases[p](sys);
+            if (sys->checkpoint) mmuko_checkpoint_save(sys, p + 1, status);
+            if (status != BOOT_OK) {
+                if (sys->checkpoint) mmuko_checkpoint_finish(sys);
+                return status;
+            }
+        }
+        if (sys->checkpoint) mmuko_checkpoint_finish(sys);
+    }
 
     // PHASE 7: Boot Complete
-    printf("\n[PHASE 7] MMUKO BOOT COMPLETE — All cubits aligned, no lock detected.\n");
+    MMUKO_LOG(sys, "\n[PHASE 7] MMUKO BOOT COMPLETE — All cubits aligned, no lock detected.\n");
     sys->boot_complete = true;
 
     return BOOT_OK;
 }
 
+BootStatus mmuko_boot_quiet(MMUKO_System* sys) {
+    bool quiet = sys->quiet;
+    sys->quiet = true;
+    BootStatus status = mmuko_boot(sys);
+    sys->quiet = quiet;
+    return status;
+}
+
 // ─────────────────────────────────────────────
 // SYSTEM INITIALIZATION & TEST
 // ─────────────────────────────────────────────
 
-MMUKO_System* mmuko_system_create(size_t memory_size) {
-    MMUKO_System* sys = (MMUKO_System*)malloc(sizeof(MMUKO_System));
+MMUKO_System* mmuko_system_create_layout(size_t memory_size, MMUKO_Layout layout) {
+    MMUKO_System* sys = (MMUKO_System*)calloc(1, sizeof(MMUKO_System));
     if (!sys) return NULL;
 
-    sys->memory_map = (MMUKO_Byte*)calloc(memory_size, sizeof(MMUKO_Byte));
-    if (!sys->memory_map) {
-        free(sys);
-        return NULL;
+    sys->layout = layout;
+    if (layout == MMUKO_LAYOUT_PLANES) {
+        if (!mmuko_planes_alloc(&sys->planes, memory_size)) {
+            free(sys);
+            return NULL;
+        }
+    } else if (layout == MMUKO_LAYOUT_FLYWEIGHT) {
+        if (!mmuko_flyweight_alloc(&sys->flyweight, memory_size)) {
+            free(sys);
+            return NULL;
+        }
+    } else {
+        sys->memory_map = (MMUKO_Byte*)calloc(memory_size, sizeof(MMUKO_Byte));
+        if (!sys->memory_map) {
+            free(sys);
+            return NULL;
+        }
     }
 
     sys->memory_size = memory_size;
+    sys->memory_capacity = memory_size;
     sys->frame_of_reference = N;
     sys->boot_complete = false;
 
     // Initialize with test pattern
     for (size_t i = 0; i < memory_size; i++) {
-        sys->memory_map[i].raw_value = (uint8_t)(i * 17 + 42);  // pseudo-random pattern
+        uint8_t value = MMUKO_TEST_PATTERN(i);
+        if (layout == MMUKO_LAYOUT_PLANES) {
+            sys->planes.raw[i] = value;
+        } else if (layout == MMUKO_LAYOUT_FLYWEIGHT) {
+            sys->flyweight.raw[i] = value;
+        } else {
+            sys->memory_map[i].raw_value = value;
+        }
     }
 
     return sys;
 }
 
+bool mmuko_system_load(MMUKO_System* sys, const uint8_t* data, size_t size) {
+    if (size > sys->memory_capacity) return false;
+
+    if (sys->layout == MMUKO_LAYOUT_PLANES) {
+        memcpy(sys->planes.raw, data, size);
+        sys->planes.size = size;
+    } else if (sys->layout == MMUKO_LAYOUT_FLYWEIGHT) {
+        memcpy(sys->flyweight.raw, data, size);
+    } else {
+        for (size_t i = 0; i < size; i++) {
+            sys->memory_map[i].raw_value = data[i];
+        }
+    }
+
+    sys->memory_size = size;
+    sys->frame_of_reference = N;
+    sys->boot_complete = false;
+    return true;
+}
+
+size_t mmuko_layout_state_bytes(MMUKO_Layout layout) {
+    switch (layout) {
+        case MMUKO_LAYOUT_PLANES: return MMUKO_PLANE_COUNT;
+        case MMUKO_LAYOUT_FLYWEIGHT: return 1;
+        default: return sizeof(MMUKO_Byte);
+    }
+}
+
+MMUKO_System* mmuko_system_create(size_t memory_size) {
+    return mmuko_system_create_layout(memory_size, MMUKO_LAYOUT_RINGS);
+}
+
+bool mmuko_system_set_threads(MMUKO_System* sys, int threads) {
+    mmuko_pool_destroy(sys->pool);
+    sys->pool = NULL;
+    if (threads == 1) return true;
+
+    sys->pool = mmuko_pool_create(threads);
+    return sys->pool != NULL;
+}
+
 void mmuko_system_destroy(MMUKO_System* sys) {
     if (sys) {
-        free(sys->memory_map);
+        mmuko_pool_destroy(sys->pool);
+        mmuko_checkpoint_close(sys->checkpoint);
+        mmuko_rings_free(sys);
+        mmuko_planes_free(&sys->planes);
+        mmuko_flyweight_free(&sys->flyweight);
         free(sys);
     }
 }
 
+bool mmuko_get_cubit(const MMUKO_System* sys, size_t byte_idx, int cubit_idx, Cubit* out) {
+    if (byte_idx >= sys->memory_size || cubit_idx < 0 || cubit_idx >= 8) return false;
+
+    if (sys->layout == MMUKO_LAYOUT_RINGS) {
+        *out = sys->memory_map[byte_idx].cubit_ring[cubit_idx];
+        return true;
+    }
+    if (sys->layout == MMUKO_LAYOUT_FLYWEIGHT) {
+        *out = mmuko_flyweight_ring(&sys->flyweight, byte_idx)->cubit_ring[cubit_idx];
+        return true;
+    }
+
+    const MMUKO_Planes* planes = &sys->planes;
+    out->index = cubit_idx;
+    out->value = (planes->raw[byte_idx] >> cubit_idx) & 1;
+    out->spin = spin_values[cubit_idx];
+    out->direction = (Direction)mmuko_plane_direction(planes, byte_idx, cubit_idx);
+    out->state = mmuko_plane_state(planes, byte_idx, cubit_idx);
+    out->superposed = (planes->superposed[byte_idx] >> cubit_idx) & 1;
+    out->entangled_with = mmuko_entangled_pairs[cubit_idx];
+    return true;
+}
+
 void mmuko_print_cubit_state(MMUKO_System* sys, size_t byte_idx, int cubit_idx) {
-    if (byte_idx >= sys->memory_size || cubit_idx < 0 || cubit_idx >= 8) return;
+    Cubit cubit;
+    if (!mmuko_get_cubit(sys, byte_idx, cubit_idx, &cubit)) return;
 
-    Cubit* c = &sys->memory_map[byte_idx].cubit_ring[cubit_idx];
+    Cubit* c = &cubit;
     printf("Byte[%zu].Cubit[%d]: val=%d, dir=%s, state=%s, spin=%.4f, super=%s, ent=%d\n",
            byte_idx, cubit_idx,
            c->value,
@@ -569,23 +695,713 @@ void mmuko_print_cubit_state(MMUKO_System* sys, size_t byte_idx, int cubit_idx)
            c->entangled_with);
 }
 
+// ─────────────────────────────────────────────
+// STATE DIGEST
+// ─────────────────────────────────────────────
+
+void mmuko_ring_record(const MMUKO_Byte* byte, uint8_t rec[MMUKO_STATE_RECORD_SIZE]) {
+    memset(rec, 0, MMUKO_STATE_RECORD_SIZE);
+    rec[0] = byte->raw_value;
+    for (int i = 0; i < 8; i++) {
+        const Cubit* c = &byte->cubit_ring[i];
+        rec[1] |= (uint8_t)((c->state & 1) << i);
+        rec[2] |= (uint8_t)(((c->state >> 1) & 1) << i);
+        rec[3] |= (uint8_t)((c->superposed ? 1 : 0) << i);
+        if (c->direction == UNDEFINED_DIR) {
+            rec[7] |= (uint8_t)(1 << i);
+        } else {
+            rec[4] |= (uint8_t)((c->direction & 1) << i);
+            rec[5] |= (uint8_t)(((c->direction >> 1) & 1) << i);
+            rec[6] |= (uint8_t)(((c->direction >> 2) & 1) << i);
+        }
+    }
+    rec[8] = (uint8_t)byte->base_index;
+    rec[9] = (uint8_t)(byte->primary_superposition | (byte->secondary_superposition << 4));
+}
+
+void mmuko_state_record(const MMUKO_System* sys, size_t b, uint8_t rec[MMUKO_STATE_RECORD_SIZE]) {
+    if (sys->layout == MMUKO_LAYOUT_PLANES) {
+        const MMUKO_Planes* planes = &sys->planes;
+        rec[0] = planes->raw[b];
+        rec[1] = planes->state_lo[b];
+        rec[2] = planes->state_hi[b];
+        rec[3] = planes->superposed[b];
+        rec[4] = planes->direction[0][b];
+        rec[5] = planes->direction[1][b];
+        rec[6] = planes->direction[2][b];
+        rec[7] = planes->undefined[b];
+        rec[8] = planes->base_index[b];
+        rec[9] = planes->superposition[b];
+    } else if (sys->layout == MMUKO_LAYOUT_FLYWEIGHT) {
+        mmuko_ring_record(mmuko_flyweight_ring(&sys->flyweight, b), rec);
+    } else {
+        mmuko_ring_record(&sys->memory_map[b], rec);
+    }
+}
+
+// Inverse of mmuko_ring_record: index, spin and partner are fixed per cubit
+void mmuko_ring_from_record(MMUKO_Byte* byte, const uint8_t rec[MMUKO_STATE_RECORD_SIZE]) {
+    byte->raw_value = rec[0];
+    for (int i = 0; i < 8; i++) {
+        Cubit* c = &byte->cubit_ring[i];
+        c->index = i;
+        c->value = (rec[0] >> i) & 1;
+        c->spin = spin_values[i];
+        c->state = (State)(((rec[1] >> i) & 1) | (((rec[2] >> i) & 1) << 1));
+        c->superposed = (rec[3] >> i) & 1;
+        c->direction = (rec[7] >> i) & 1 ? UNDEFINED_DIR :
+                       (Direction)(((rec[4] >> i) & 1) | (((rec[5] >> i) & 1) << 1) |
+                                   (((rec[6] >> i) & 1) << 2));
+        c->entangled_with = mmuko_entangled_pairs[i];
+    }
+    byte->base_index = rec[8];
+    byte->primary_superposition = (Direction)(rec[9] & 0x0F);
+    byte->secondary_superposition = (Direction)(rec[9] >> 4);
+}
+
+uint64_t mmuko_state_digest_update(const MMUKO_System* sys, uint64_t hash) {
+    return mmuko_state_digest_range(sys, 0, sys->memory_size, hash);
+}
+
+uint64_t mmuko_state_digest_range(const MMUKO_System* sys, size_t begin, size_t end,
+                                  uint64_t hash) {
+    uint8_t rec[MMUKO_STATE_RECORD_SIZE];
+
+    for (size_t b = begin; b < end; b++) {
+        mmuko_state_record(sys, b, rec);
+        for (int i = 0; i < MMUKO_STATE_RECORD_SIZE; i++) {
+            hash = (hash ^ rec[i]) * 0x100000001B3ull;
+        }
+    }
+    return hash;
+}
+
+uint64_t mmuko_state_digest_final(uint64_t hash, Direction frame) {
+    return (hash ^ (uint64_t)frame) * 0x100000001B3ull;
+}
+
+uint64_t mmuko_state_digest(const MMUKO_System* sys) {
+    uint64_t hash = mmuko_state_digest_update(sys, MMUKO_DIGEST_INIT);
+    return mmuko_state_digest_final(hash, sys->frame_of_reference);
+}
+
 // ─────────────────────────────────────────────
 // MAIN ENTRY POINT
 // ─────────────────────────────────────────────
 
-int main() {
+static bool parse_size(const char* text, size_t* out) {
+    char* end;
+    unsigned long long value = strtoull(text, &end, 0);
+    if (end == text) return false;
+
+    switch (*end) {
+        case 'K': case 'k': value <<= 10; end++; break;
+        case 'M': case 'm': value <<= 20; end++; break;
+        case 'G': case 'g': value <<= 30; end++; break;
+        default: break;
+    }
+    if (*end != '\0' || value == 0) return false;
+    *out = (size_t)value;
+    return true;
+}
+
+static const char* layout_name(MMUKO_Layout layout) {
+    switch (layout) {
+        case MMUKO_LAYOUT_PLANES: return "planes";
+        case MMUKO_LAYOUT_FLYWEIGHT: return "flyweight";
+        default: return "rings";
+    }
+}
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+// Timing excludes logging
+static BootStatus timed_boot(MMUKO_System* sys, double* seconds) {
+    double start = now_seconds();
+    BootStatus status = mmuko_boot_quiet(sys);
+    *seconds = now_seconds() - start;
+    return status;
+}
+
+#define BENCH_ROUNDS 2
+
+// Phased against fused on one system, best of BENCH_ROUNDS each; the
+// modes alternate so neither gets all the first-touch page faults
+static int run_bench(MMUKO_System* sys) {
+    double best[2] = {0.0, 0.0};
+    BootStatus status[2] = {BOOT_OK, BOOT_OK};
+    uint64_t digest[2] = {0, 0};
+
+    for (int round = 0; round < BENCH_ROUNDS; round++) {
+        for (int mode = 0; mode < 2; mode++) {
+            double seconds;
+            sys->fused = mode == 1;
+            status[mode] = timed_boot(sys, &seconds);
+            digest[mode] = mmuko_state_digest(sys);
+            if (round == 0 || seconds < best[mode]) best[mode] = seconds;
+        }
+    }
+
+    const char* names[2] = {"phased", "fused"};
+    for (int mode = 0; mode < 2; mode++) {
+        printf("%-7s %9.3f s  %8.1f MB/s  status=%d  digest=0x%016llx\n",
+               names[mode], best[mode], (double)sys->memory_size / best[mode] / 1e6,
+               status[mode], (unsigned long long)digest[mode]);
+    }
+    printf("Fused speedup: %.2fx\n", best[0] / best[1]);
+
+    if (status[0] != status[1] || digest[0] != digest[1]) {
+        printf("MISMATCH between phased and fused results\n");
+        return 1;
+    }
+    return 0;
+}
+
+// Fused rings boots on the heap map against each placement, best of
+// BENCH_ROUNDS boots each. Fused, because the phased boot's per-byte log
+// lines would hide the memory traffic. Creation includes the first touch
+static int run_alloc_bench(size_t mem_size, int threads) {
+    static const struct {
+        const char* name;
+        unsigned placement;
+    } configs[] = {
+        {"heap", 0},
+        {"huge", MMUKO_PLACE_HUGE},
+        {"local", MMUKO_PLACE_LOCAL},
+        {"huge,local", MMUKO_PLACE_HUGE | MMUKO_PLACE_LOCAL},
+    };
+    const int count = (int)(sizeof(configs) / sizeof(configs[0]));
+    double best[4];
+    uint64_t digest[4];
+    int rc = 0;
+
+    for (int c = 0; c < count; c++) {
+        double start = now_seconds();
+        MMUKO_System* sys;
+        if (configs[c].placement == 0) {
+            sys = mmuko_system_create(mem_size);
+            if (sys && !mmuko_system_set_threads(sys, threads)) {
+                mmuko_system_destroy(sys);
+                sys = NULL;
+            }
+        } else {
+            sys = mmuko_system_create_placed(mem_size, threads, configs[c].placement);
+        }
+        if (!sys) {
+            fprintf(stderr, "Failed to create the %s system\n", configs[c].name);
+            return 1;
+        }
+        double create = now_seconds() - start;
+        sys->fused = true;
+
+        BootStatus status = BOOT_OK;
+        for (int round = 0; round < BENCH_ROUNDS; round++) {
+            double seconds;
+            status = timed_boot(sys, &seconds);
+            if (round == 0 || seconds < best[c]) best[c] = seconds;
+        }
+        digest[c] = mmuko_state_digest(sys);
+
+        printf("%-10s %-10s create %7.3f s  boot %7.3f s  %8.1f MB/s  huge %6zu MiB"
+               "  status=%d  digest=0x%016llx\n",
+               configs[c].name, mmuko_pages_name(sys->pages), create, best[c],
+               (double)mem_size / best[c] / 1e6, mmuko_huge_bytes(sys) >> 20, status,
+               (unsigned long long)digest[c]);
+        if (status != BOOT_OK || digest[c] != digest[0]) rc = 1;
+        mmuko_system_destroy(sys);
+    }
+
+    for (int c = 1; c < count; c++) {
+        printf("%s speedup over heap: %.2fx\n", configs[c].name, best[0] / best[c]);
+    }
+    if (rc != 0) printf("MISMATCH between heap and placed results\n");
+    return rc;
+}
+
+#define MMUKO_WHATIF_WRITES 8
+
+typedef struct {
+    MMUKO_Fork* forks;
+    const MMUKO_DigestTree* tree;   // Over the baseline, shared by every fork
+    BootStatus* status;
+    size_t* fault_byte;
+    uint64_t* digest;
+    bool* digested;
+} WhatIfBatch;
+
+static void evaluate_forks(MMUKO_System* sys, size_t begin, size_t end, void* ctx) {
+    (void)sys;
+    WhatIfBatch* batch = (WhatIfBatch*)ctx;
+    for (size_t f = begin; f < end; f++) {
+        batch->status[f] = mmuko_fork_status(&batch->forks[f], &batch->fault_byte[f]);
+        batch->digested[f] = mmuko_fork_digest(&batch->forks[f], batch->tree, &batch->digest[f]);
+    }
+}
+
+// Full boot of fork 0's memory, to check its overlay result
+static bool verify_fork(const MMUKO_System* sys, const MMUKO_Fork* fk, BootStatus status,
+                        uint64_t digest) {
+    uint8_t* data = (uint8_t*)malloc(sys->memory_size);
+    MMUKO_System* copy = mmuko_system_create_layout(sys->memory_size, sys->layout);
+    bool ok = data && copy;
+
+    if (ok) {
+        uint8_t rec[MMUKO_STATE_RECORD_SIZE];
+        for (size_t b = 0; b < sys->memory_size; b++) {
+            mmuko_fork_record(fk, b, rec);
+            data[b] = rec[0];
+        }
+        ok = mmuko_system_load(copy, data, sys->memory_size);
+    }
+    if (ok) {
+        BootStatus full = mmuko_boot_quiet(copy);
+        ok = full == status;
+        if (ok && full == BOOT_OK) {
+            MMUKO_DigestTree tree;
+            ok = mmuko_digest_tree_build(&tree, copy) && mmuko_digest_tree_root(&tree) == digest;
+            mmuko_digest_tree_free(&tree);
+        }
+    }
+
+    free(data);
+    if (copy) mmuko_system_destroy(copy);
+    return ok;
+}
+
+// Forks of a booted system, each with MMUKO_WHATIF_WRITES random byte writes
+static bool create_forks(const MMUKO_System* sys, MMUKO_Fork* forks, size_t count) {
+    uint64_t rng = 0x9E3779B97F4A7C15ull;
+    for (size_t f = 0; f < count; f++) {
+        if (!mmuko_fork_init(&forks[f], sys)) return false;
+        for (int w = 0; w < MMUKO_WHATIF_WRITES; w++) {
+            rng ^= rng << 13;
+            rng ^= rng >> 7;
+            rng ^= rng << 17;
+            if (!mmuko_fork_write(&forks[f], (size_t)(rng >> 8) % sys->memory_size, (uint8_t)rng)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// `count` what-if forks of a booted system, evaluated on its pool when it
+// has one; fork 0 is then checked against a full boot
+static int run_what_if(MMUKO_System* sys, size_t count) {
+    MMUKO_Fork* forks = (MMUKO_Fork*)calloc(count, sizeof(MMUKO_Fork));
+    BootStatus* status = (BootStatus*)malloc(count * sizeof(BootStatus));
+    size_t* fault_byte = (size_t*)malloc(count * sizeof(size_t));
+    uint64_t* digest = (uint64_t*)malloc(count * sizeof(uint64_t));
+    bool* digested = (bool*)malloc(count * sizeof(bool));
+    MMUKO_DigestTree tree = {0};
+    int rc = 1;
+
+    double start = now_seconds();
+    bool tree_ok = mmuko_digest_tree_build(&tree, sys);
+    double tree_seconds = now_seconds() - start;
+
+    if (!forks || !status || !fault_byte || !digest || !digested || !tree_ok ||
+        !create_forks(sys, forks, count)) {
+        fprintf(stderr, "Failed to create the what-if forks\n");
+    } else {
+        WhatIfBatch batch = {forks, &tree, status, fault_byte, digest, digested};
+        start = now_seconds();
+        if (sys->pool) {
+            mmuko_pool_run(sys->pool, sys, count, 1, evaluate_forks, &batch);
+        } else {
+            evaluate_forks(sys, 0, count, &batch);
+        }
+        double seconds = now_seconds() - start;
+
+        printf("\nWhat-if forks: %zu, %d writes each\n", count, MMUKO_WHATIF_WRITES);
+        for (size_t f = 0; f < count; f++) {
+            if (!digested[f]) {
+                printf("  fork %-4zu out of memory for its digest\n", f);
+                digest[f] = 0;
+            } else if (status[f] == BOOT_OK) {
+                printf("  fork %-4zu status=%d  changed %zu  overlay %zu bytes  digest=0x%016llx\n",
+                       f, status[f], mmuko_fork_changed(&forks[f]), mmuko_fork_bytes(&forks[f]),
+                       (unsigned long long)digest[f]);
+            } else {
+                printf("  fork %-4zu status=%d at byte %zu  changed %zu  overlay %zu bytes\n",
+                       f, status[f], fault_byte[f], mmuko_fork_changed(&forks[f]),
+                       mmuko_fork_bytes(&forks[f]));
+            }
+        }
+        printf("Baseline digest tree in %.3f s, forks evaluated in %.3f s\n", tree_seconds, seconds);
+
+        if (verify_fork(sys, &forks[0], status[0], digest[0])) {
+            printf("Fork 0 matches a full boot of its memory\n");
+            rc = 0;
+        } else {
+            printf("MISMATCH between fork 0 and a full boot of its memory\n");
+        }
+    }
+
+    if (forks) {
+        for (size_t f = 0; f < count; f++) mmuko_fork_free(&forks[f]);
+    }
+    free(forks);
+    free(status);
+    free(fault_byte);
+    free(digest);
+    free(digested);
+    mmuko_digest_tree_free(&tree);
+    return rc;
+}
+
+#define MMUKO_QUERY_TERMS 8
+
+// Scan every cubit of [begin, end) through mmuko_get_cubit, to check a query
+static size_t scan_count(const MMUKO_System* sys, const MMUKO_IndexTerm* terms, int term_count,
+                         size_t begin, size_t end) {
+    size_t count = 0;
+    for (size_t b = begin; b < end && b < sys->memory_size; b++) {
+        uint8_t rec[MMUKO_STATE_RECORD_SIZE];
+        MMUKO_Byte ring;
+        mmuko_state_record(sys, b, rec);
+        mmuko_ring_from_record(&ring, rec);
+        for (int i = 0; i < 8; i++) {
+            const Cubit* c = &ring.cubit_ring[i];
+            bool match = true;
+            for (int t = 0; t < term_count && match; t++) {
+                int value;
+                switch (terms[t].attribute) {
+                    case MMUKO_INDEX_DIRECTION: value = c->direction; break;
+                    case MMUKO_INDEX_STATE: value = c->state; break;
+                    case MMUKO_INDEX_SUPERPOSED: value = c->superposed; break;
+                    case MMUKO_INDEX_BASE: value = ring.base_index; break;
+                    case MMUKO_INDEX_PRIMARY: value = ring.primary_superposition; break;
+                    default: value = ring.secondary_superposition; break;
+                }
+                match = value == terms[t].value;
+            }
+            count += match;
+        }
+    }
+    return count;
+}
+
+// Index the booted state, count the cubits of bytes [begin, end) matching
+// every term, and check the count against a scan
+static int run_query(const MMUKO_System* sys, const char* query, size_t begin, size_t end) {
+    MMUKO_IndexTerm terms[MMUKO_QUERY_TERMS];
+    int term_count = 0;
+    char text[256];
+    snprintf(text, sizeof(text), "%s", query);
+    for (char* term = strtok(text, ","); term; term = strtok(NULL, ",")) {
+        if (term_count == MMUKO_QUERY_TERMS || !mmuko_index_parse_term(term, &terms[term_count])) {
+            fprintf(stderr, "Bad query term '%s'\n", term);
+            return 1;
+        }
+        term_count++;
+    }
+    if (end > sys->memory_size) end = sys->memory_size;
+
+    MMUKO_Index index;
+    double start = now_seconds();
+    if (!mmuko_index_build(&index, sys)) {
+        fprintf(stderr, "Failed to build the bitmap index\n");
+        return 1;
+    }
+    double build = now_seconds() - start;
+    size_t uncompressed = 0;
+    for (int a = 0; a < MMUKO_INDEX_ATTRIBUTES; a++) {
+        uncompressed += (size_t)mmuko_index_values((MMUKO_IndexAttribute)a) * 8 *
+                        (a >= MMUKO_INDEX_BASE ? index.byte_words : index.cubit_words);
+    }
+
+    start = now_seconds();
+    size_t count = mmuko_index_count(&index, terms, term_count, begin, end);
+    double seconds = now_seconds() - start;
+
+    start = now_seconds();
+    size_t scanned = scan_count(sys, terms, term_count, begin, end);
+    double scan = now_seconds() - start;
+
+    printf("\nBitmap index: %zu runs, %zu KiB (%zu KiB uncompressed), built in %.3f s\n",
+           mmuko_index_runs(&index), mmuko_index_bytes(&index) >> 10,
+           uncompressed >> 10, build);
+    printf("Query %s over bytes [%zu, %zu): %zu cubits in %.6f s (scan %.3f s)\n",
+           query, begin, end, count, seconds, scan);
+    mmuko_index_free(&index);
+
+    if (count != scanned) {
+        printf("MISMATCH between the index (%zu) and a scan (%zu)\n", count, scanned);
+        return 1;
+    }
+    return 0;
+}
+
+static int run_scan(const char* path, MMUKO_Layout layout, size_t window, int threads, bool fused,
+                    const char* checkpoint, bool resume) {
+    MMUKO_ScanResult result;
+    double start = now_seconds();
+    if (!mmuko_scan_file(path, layout, window, threads, fused, checkpoint, resume, &result)) return 1;
+    double seconds = now_seconds() - start;
+
+    printf("Scanned %s: %zu bytes in %zu windows of %zu (%s layout)\n",
+           path, result.bytes, result.windows, result.window, layout_name(layout));
+    printf("Scan time: %.3f s  %.1f MB/s\n", seconds,
+           (double)(result.bytes - result.resumed_offset) / seconds / 1e6);
+
+    if (result.status != BOOT_OK) {
+        printf("\n=== SCAN FAILED ===\n");
+        printf("Status code: %d in the window at offset %zu\n", result.status, result.fault_offset);
+        return 1;
+    }
+    printf("State digest: 0x%016llx\n", (unsigned long long)result.digest);
+    return 0;
+}
+
+static int run_stream(const char* path, MMUKO_Layout layout, size_t chunk, int threads, bool fused) {
+    bool use_stdin = strcmp(path, "-") == 0;
+    int fd = use_stdin ? STDIN_FILENO : open(path, O_RDONLY);
+    if (fd < 0) {
+        fprintf(stderr, "Cannot open %s\n", path);
+        return 1;
+    }
+
+    MMUKO_StreamResult result;
+    double start = now_seconds();
+    bool ok = mmuko_stream_fd(fd, layout, chunk, threads, fused, &result);
+    double seconds = now_seconds() - start;
+    if (!use_stdin) close(fd);
+    if (!ok) return 1;
+
+    printf("Streamed %s: %zu bytes in %zu chunks of %zu (%s layout, %d workers)\n",
+           use_stdin ? "stdin" : path, result.bytes, result.chunks, result.chunk,
+           layout_name(layout), result.workers);
+    printf("Stream time: %.3f s  %.1f MB/s  (reader waited on full queues %zu times)\n",
+           seconds, (double)result.bytes / seconds / 1e6, result.reader_stalls);
+
+    if (result.status != BOOT_OK) {
+        printf("\n=== STREAM FAILED ===\n");
+        printf("Status code: %d in the chunk at offset %zu\n", result.status, result.fault_offset);
+        return 1;
+    }
+    printf("Stream digest: 0x%016llx\n", (unsigned long long)result.digest);
+    return 0;
+}
+
+static int usage(const char* argv0) {
+    fprintf(stderr,
+            "Usage: %s [--size <bytes>[K|M|G]] [--layout rings|planes|flyweight]\n"
+            "          [--threads <n>] [--fused] [--bench] [--simd <kernels>]\n"
+            "          [--file <path> [--window <bytes>[K|M|G]]]\n"
+            "          [--stream <path>|- [--chunk <bytes>[K|M|G]]]\n"
+            "          [--place huge|local|huge,local] [--bench-alloc]\n"
+            "          [--checkpoint <path> [--resume]] [--what-if <forks>]\n"
+            "          [--query <attr>=<value>[,...] [--range <begin>:<end>]]\n"
+            "  --size    Modelled memory size (default 16)\n"
+            "  --layout  rings: one MMUKO_Byte per byte (reference)\n"
+            "            planes: raw bytes plus bit-planes, ~10 bytes per byte\n"
+            "            flyweight: raw bytes plus 256 shared rings, ~1 byte per byte\n"
+            "  --threads Worker threads for the rings layout (default 1, 0: all CPUs)\n"
+            "  --fused   Run phases 1–6 in a single pass over memory\n"
+            "  --bench   Time phased against fused boots (default 1G, planes layout)\n"
+            "  --simd    Plane kernels: auto (default), scalar, avx2, avx512\n"
+            "  --file    Boot a file or block device instead of the test pattern\n"
+            "  --window  Bytes booted at a time with --file (default: 256M of state)\n"
+            "  --stream  Boot a file or pipe (- for stdin) through a reader/worker/merge\n"
+            "            pipeline; --threads sets the workers (default 1, 0: all CPUs)\n"
+            "  --chunk   Bytes per pipeline chunk, in whole 64K blocks (default: 32M of state)\n"
+            "  --place   Rings map on huge pages and/or first-touched by the pinned\n"
+            "            thread that boots each chunk (NUMA-local)\n"
+            "  --bench-alloc Time fused rings boots on the heap map against each placement\n"
+            "            (default 4M bytes, about 1G of rings)\n"
+            "  --checkpoint Save the state after every phase to <path> (rings, planes),\n"
+            "            or with --file the scan position after every window\n"
+            "  --resume  Continue from the last phase or window saved in the checkpoint\n"
+            "  --what-if After booting, evaluate <forks> copy-on-write forks with random\n"
+            "            byte writes against the booted state\n"
+            "  --query   After booting, count the cubits matching every term with bitmap\n"
+            "            indexes; attributes: direction, state, superposed, base, primary,\n"
+            "            secondary (e.g. state=STRANGE,direction=SW)\n"
+            "  --range   Bytes the query covers (default: all)\n",
+            argv0);
+    return 2;
+}
+
+int main(int argc, char** argv) {
+    size_t mem_size = 16;
+    MMUKO_Layout layout = MMUKO_LAYOUT_RINGS;
+    int threads = 1;
+    bool fused = false;
+    bool bench = false;
+    bool size_given = false;
+    bool layout_given = false;
+    const char* file = NULL;
+    size_t window = 0;
+    const char* stream = NULL;
+    size_t chunk = 0;
+    unsigned placement = 0;
+    bool bench_alloc = false;
+    const char* checkpoint = NULL;
+    bool resume = false;
+    size_t what_if = 0;
+    const char* query = NULL;
+    size_t range_begin = 0;
+    size_t range_end = SIZE_MAX;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--size") == 0 && i + 1 < argc) {
+            if (!parse_size(argv[++i], &mem_size)) return usage(argv[0]);
+            size_given = true;
+        } else if (strcmp(argv[i], "--layout") == 0 && i + 1 < argc) {
+            const char* name = argv[++i];
+            layout_given = true;
+            if (strcmp(name, "rings") == 0) {
+                layout = MMUKO_LAYOUT_RINGS;
+            } else if (strcmp(name, "planes") == 0) {
+                layout = MMUKO_LAYOUT_PLANES;
+            } else if (strcmp(name, "flyweight") == 0) {
+                layout = MMUKO_LAYOUT_FLYWEIGHT;
+            } else {
+                return usage(argv[0]);
+            }
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            char* end;
+            long value = strtol(argv[++i], &end, 10);
+            if (*end != '\0' || value < 0 || value > 1024) return usage(argv[0]);
+            threads = (int)value;
+        } else if (strcmp(argv[i], "--fused") == 0) {
+            fused = true;
+        } else if (strcmp(argv[i], "--bench") == 0) {
+            bench = true;
+        } else if (strcmp(argv[i], "--file") == 0 && i + 1 < argc) {
+            file = argv[++i];
+        } else if (strcmp(argv[i], "--window") == 0 && i + 1 < argc) {
+            if (!parse_size(argv[++i], &window)) return usage(argv[0]);
+        } else if (strcmp(argv[i], "--stream") == 0 && i + 1 < argc) {
+            stream = argv[++i];
+        } else if (strcmp(argv[i], "--chunk") == 0 && i + 1 < argc) {
+            if (!parse_size(argv[++i], &chunk)) return usage(argv[0]);
+        } else if (strcmp(argv[i], "--place") == 0 && i + 1 < argc) {
+            const char* name = argv[++i];
+            if (strcmp(name, "huge") == 0) {
+                placement = MMUKO_PLACE_HUGE;
+            } else if (strcmp(name, "local") == 0) {
+                placement = MMUKO_PLACE_LOCAL;
+            } else if (strcmp(name, "huge,local") == 0) {
+                placement = MMUKO_PLACE_HUGE | MMUKO_PLACE_LOCAL;
+            } else {
+                return usage(argv[0]);
+            }
+        } else if (strcmp(argv[i], "--bench-alloc") == 0) {
+            bench_alloc = true;
+        } else if (strcmp(argv[i], "--checkpoint") == 0 && i + 1 < argc) {
+            checkpoint = argv[++i];
+        } else if (strcmp(argv[i], "--resume") == 0) {
+            resume = true;
+        } else if (strcmp(argv[i], "--query") == 0 && i + 1 < argc) {
+            query = argv[++i];
+        } else if (strcmp(argv[i], "--range") == 0 && i + 1 < argc) {
+            char* end;
+            range_begin = (size_t)strtoull(argv[++i], &end, 0);
+            if (*end != ':') return usage(argv[0]);
+            range_end = (size_t)strtoull(end + 1, &end, 0);
+            if (*end != '\0' || range_end <= range_begin) return usage(argv[0]);
+        } else if (strcmp(argv[i], "--what-if") == 0 && i + 1 < argc) {
+            if (!parse_size(argv[++i], &what_if) || what_if == 0) return usage(argv[0]);
+        } else if (strcmp(argv[i], "--simd") == 0 && i + 1 < argc) {
+            const char* name = argv[++i];
+            if (!mmuko_simd_select(name)) {
+                fprintf(stderr, "Plane kernels '%s' are unknown or unsupported here\n", name);
+                return usage(argv[0]);
+            }
+        } else {
+            return usage(argv[0]);
+        }
+    }
+
+    // Scans and streams take their size from the input
+    if ((file || stream) && (size_given || bench)) return usage(argv[0]);
+    if (file && stream) return usage(argv[0]);
+
+    // Placement applies to a created rings map
+    if ((placement || bench_alloc) && (file || stream || bench || layout != MMUKO_LAYOUT_RINGS)) {
+        return usage(argv[0]);
+    }
+
+    // Checkpoints cover one phased boot of a created system, or a scan's
+    // position; a stream cannot be read again, so it has none
+    if ((resume && !checkpoint) ||
+        (checkpoint && (stream || bench || bench_alloc ||
+                        (!file && layout == MMUKO_LAYOUT_FLYWEIGHT)))) {
+        return usage(argv[0]);
+    }
+
+    // Forks and queries start from a created system's boot
+    if ((what_if || query) && (file || stream || bench || bench_alloc)) return usage(argv[0]);
+    if (range_end != SIZE_MAX && !query) return usage(argv[0]);
+
+    // Rings take ~270 bytes per modelled byte, too many for a 1G benchmark
+    if (bench && !size_given) mem_size = (size_t)1 << 30;
+    if (bench && !layout_given) layout = MMUKO_LAYOUT_PLANES;
+
     printf("MMUKO OS Boot Loader\n");
     printf("OBINexus R&D — \"Don't just boot systems. Boot truthful ones.\"\n\n");
 
-    // Create system with 16 bytes of MMUKO memory
-    size_t mem_size = 16;
-    MMUKO_System* sys = mmuko_system_create(mem_size);
+    if (!mmuko_canonical_rings_verify()) {
+        fprintf(stderr, "Canonical ring table does not match init_cubit_ring\n");
+        return 1;
+    }
+
+    if (bench_alloc) {
+        return run_alloc_bench(size_given ? mem_size : (size_t)4 << 20, threads);
+    }
+
+    if (file || stream) {
+        if (layout == MMUKO_LAYOUT_PLANES) {
+            printf("Plane kernels: %s\n", mmuko_simd_name());
+        }
+        return file ? run_scan(file, layout, window, threads, fused, checkpoint, resume)
+                    : run_stream(stream, layout, chunk, threads, fused);
+    }
+
+    // Create system with 16 bytes of MMUKO memory unless --size says otherwise
+    MMUKO_System* sys = placement ? mmuko_system_create_placed(mem_size, threads, placement)
+                                  : mmuko_system_create_layout(mem_size, layout);
     if (!sys) {
         fprintf(stderr, "Failed to create MMUKO system\n");
         return 1;
     }
 
-    printf("Initialized MMUKO system with %zu bytes\n", mem_size);
+    if (!placement && !mmuko_system_set_threads(sys, threads)) {
+        fprintf(stderr, "Failed to start MMUKO worker threads\n");
+        mmuko_system_destroy(sys);
+        return 1;
+    }
+    if (checkpoint && !mmuko_system_set_checkpoint(sys, checkpoint, resume)) {
+        fprintf(stderr, "Failed to set up checkpoints at %s\n", checkpoint);
+        mmuko_system_destroy(sys);
+        return 1;
+    }
+
+    printf("Initialized MMUKO system with %zu bytes (%s layout)\n", mem_size, layout_name(layout));
+    if (sys->pool && layout == MMUKO_LAYOUT_RINGS) {
+        printf("Parallel boot on %d threads\n", mmuko_pool_threads(sys->pool));
+    }
+    if (placement) {
+        printf("Memory map: %s, %zu MiB on huge pages%s\n", mmuko_pages_name(sys->pages),
+               mmuko_huge_bytes(sys) >> 20,
+               placement & MMUKO_PLACE_LOCAL ? ", first-touched by pinned threads" : "");
+    }
+    if (layout == MMUKO_LAYOUT_PLANES) {
+        printf("Plane kernels: %s\n", mmuko_simd_name());
+    }
+
+    if (bench) {
+        int rc = run_bench(sys);
+        mmuko_system_destroy(sys);
+        return rc;
+    }
+    sys->fused = fused;
 
     // Execute boot sequence
     BootStatus status = mmuko_boot(sys);
@@ -595,6 +1411,7 @@ int main() {
         printf("Frame of reference: %s\n", direction_to_string(sys->frame_of_reference));
         printf("Gravity medium: G=%.4f (lepton=%.4f, muon=%.4f, deep=%.4f)\n",
                G_VACUUM, G_LEPTON, G_MUON, G_DEEP);
+        printf("State digest: 0x%016llx\n", (unsigned long long)mmuko_state_digest(sys));
 
         // Print sample cubit states
         printf("\nSample cubit states:\n");
@@ -609,10 +1426,14 @@ int main() {
         printf("Status code: %d\n", status);
     }
 
+    int rc = (status == BOOT_OK) ? 0 : 1;
+    if (rc == 0 && what_if) rc = run_what_if(sys, what_if);
+    if (rc == 0 && query) rc = run_query(sys, query, range_begin, range_end);
+
     // Cleanup
     mmuko_system_destroy(sys);
 
-    return (status == BOOT_OK) ? 0 : 1;
+    return rc;
 }
 
 // ============================================================
@@ -0,0 +1,599 @@
+// ============================================================
+// MMUKO-BOOT.H — MMUKO OS Boot Sequence Types and API
+// Project: OBINexus / OBIELF R&D
+// ============================================================
+//
+// Shared by mmuko-boot.c (reference phases, CLI) and the
+// alternative memory layouts and execution modes built on it.
+// ============================================================
+
+#ifndef MMUKO_BOOT_H
+#define MMUKO_BOOT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// ─────────────────────────────────────────────
+// ENUMERATIONS
+// ─────────────────────────────────────────────
+
+typedef enum {
+    N, NE, E, SE, S, SW, W, NW, UNDEFINED_DIR
+} Direction;
+
+typedef enum {
+    UP, DOWN, CHARM, STRANGE, LEFT, RIGHT
+} State;
+
+typedef enum {
+    RSHIFT, LSHIFT, ROTATE
+} ShiftOp;
+
+typedef enum {
+    BOOT_OK,
+    BOOT_LOCK_DETECTED,
+    BOOT_ROTATION_LOCK,
+    BOOT_UNDEFINED_DIRECTION,
+    BOOT_FAILED
+} BootStatus;
+
+// Memory representation of an MMUKO_System
+typedef enum {
+    MMUKO_LAYOUT_RINGS,     // One MMUKO_Byte (eight Cubit structs) per byte
+    MMUKO_LAYOUT_PLANES,    // Structure of arrays: raw bytes plus bit-planes
+    MMUKO_LAYOUT_FLYWEIGHT  // Raw bytes plus 256 shared rings
+} MMUKO_Layout;
+
+// ─────────────────────────────────────────────
+// STRUCTURES
+// ─────────────────────────────────────────────
+
+typedef struct {
+    int index;              // 0–7
+    uint8_t value;          // 0 or 1
+    double spin;            // derived from compass direction
+    Direction direction;    // compass direction
+    State state;            // quantum-like state
+    bool superposed;        // is this cubit in superposition?
+    int entangled_with;     // index of entangled partner (-1 if none)
+} Cubit;
+
+typedef struct {
+    uint8_t raw_value;
+    Cubit cubit_ring[8];
+    int base_index;
+    Direction primary_superposition;
+    Direction secondary_superposition;
+} MMUKO_Byte;
+
+// Bit-plane layout: bit i of plane[b] belongs to cubit i of byte b.
+// Index, spin and entanglement partner are fixed per cubit index and are
+// not stored. States are 2 bits (UP/DOWN/CHARM/STRANGE, the only states a
+// ring can reach); directions are 3 bits plus an UNDEFINED_DIR plane.
+// About 10 bytes per modelled byte instead of sizeof(MMUKO_Byte)
+typedef struct {
+    uint8_t* raw;               // Cubit values
+    uint8_t* state_lo;          // State bit 0
+    uint8_t* state_hi;          // State bit 1
+    uint8_t* superposed;
+    uint8_t* direction[3];      // Direction bits 0..2
+    uint8_t* undefined;         // Direction is UNDEFINED_DIR
+    uint8_t* base_index;        // 1–12
+    uint8_t* superposition;     // Primary (low nibble), secondary (high nibble)
+    size_t size;                // Bytes in use; the planes are allocated for more after a load
+} MMUKO_Planes;
+
+#define MMUKO_PLANE_COUNT 10
+
+// Flyweight layout: every byte with the same raw value shares one ring,
+// which the phases update once
+typedef struct {
+    uint8_t* raw;                   // The only per-byte storage
+    MMUKO_Byte classes[256];        // Current ring for each raw value
+    size_t population[256];         // Bytes per class
+} MMUKO_Flyweight;
+
+typedef struct {
+    double gravity;
+    double air;
+    double water;
+} VacuumMedium;
+
+typedef struct MMUKO_Pool MMUKO_Pool;
+typedef struct MMUKO_Checkpoint MMUKO_Checkpoint;
+
+// What backs a ring-layout memory map (mmuko-memory.c)
+typedef enum {
+    MMUKO_PAGES_HEAP,       // calloc
+    MMUKO_PAGES_HUGETLB,    // Reserved huge pages (MAP_HUGETLB)
+    MMUKO_PAGES_THP,        // Anonymous mapping advised for transparent huge pages
+    MMUKO_PAGES_BASE        // Anonymous mapping on base pages
+} MMUKO_Pages;
+
+typedef struct {
+    MMUKO_Byte* memory_map;     // MMUKO_LAYOUT_RINGS only
+    MMUKO_Pages pages;          // Backing of memory_map
+    size_t mapped_bytes;        // Mapping length unless pages is MMUKO_PAGES_HEAP
+    size_t memory_size;
+    size_t memory_capacity;     // Size at creation; mmuko_system_load may use less
+    VacuumMedium medium;
+    Direction frame_of_reference;
+    bool boot_complete;
+    MMUKO_Layout layout;
+    MMUKO_Planes planes;        // MMUKO_LAYOUT_PLANES only
+    MMUKO_Flyweight flyweight;  // MMUKO_LAYOUT_FLYWEIGHT only
+    MMUKO_Pool* pool;           // Parallel ring phases when set (mmuko_system_set_threads)
+    bool fused;                 // Run phases 1–6 in one pass (mmuko-fused.c)
+    MMUKO_Checkpoint* checkpoint;   // Phase checkpoints when set (mmuko_system_set_checkpoint)
+    bool quiet;                 // Skip the boot log (mmuko_boot_quiet)
+} MMUKO_System;
+
+// One line of the boot log, unless the system boots quietly
+#define MMUKO_LOG(sys, ...) do { if (!(sys)->quiet) printf(__VA_ARGS__); } while (0)
+
+// Superposition lookup entry
+typedef struct {
+    int base;
+    Direction primary;
+    Direction secondary;
+} SuperpositionEntry;
+
+typedef BootStatus (*MMUKO_PhaseFn)(MMUKO_System* sys);
+
+#define MMUKO_PHASE_COUNT 6
+
+// Raw value of byte i in a freshly created system
+#define MMUKO_TEST_PATTERN(i) ((uint8_t)((i) * 17 + 42))
+#define MMUKO_DIAMOND_SIZE 7
+
+// Phase-1 base index of a raw value and its superposition lookup
+// (odd bases round up to the next table entry), as constant expressions
+#define MMUKO_RING_BASE(v)          ((v) % 12 + 1)
+#define MMUKO_BASE_PRIMARY(b)       ((b) <= 1 ? N : (b) <= 2 ? NE : (b) <= 4 ? W : \
+                                     (b) <= 6 ? SW : (b) <= 8 ? E : (b) <= 10 ? SE : S)
+#define MMUKO_BASE_SECONDARY(b)     ((b) <= 1 ? S : (b) <= 2 ? W : (b) <= 6 ? E : \
+                                     (b) <= 8 ? W : N)
+
+// ─────────────────────────────────────────────
+// REFERENCE BOOT (mmuko-boot.c)
+// ─────────────────────────────────────────────
+
+extern const int mmuko_entangled_pairs[8];
+extern const int mmuko_diamond_order[MMUKO_DIAMOND_SIZE];
+
+// Phase-1 ring for every raw value, built at compile time
+extern const MMUKO_Byte mmuko_canonical_rings[256];
+bool mmuko_canonical_rings_verify(void);
+
+const char* direction_to_string(Direction dir);
+const char* state_to_string(State s);
+State resolve_state(int index, uint8_t byte_val);
+void init_cubit_ring(MMUKO_Byte* byte);
+void lookup_superposition(int base, Direction* primary, Direction* secondary);
+uint8_t rotate_bits(uint8_t value, int n);
+State flip_state(State s);
+int get_middle_base(void);
+void set_frame_of_reference(MMUKO_System* sys, Direction center_dir);
+
+// Per-ring phase steps shared by every layout
+int mmuko_ring_align(MMUKO_Byte* byte);                 // Stuck cubit, or -1
+uint8_t mmuko_ring_entangle(MMUKO_Byte* byte);          // Bit i: cubit i flipped its partner
+int mmuko_ring_rotation_lock(const MMUKO_Byte* byte);   // Locked cubit, or -1
+
+BootStatus mmuko_boot(MMUKO_System* sys);
+BootStatus mmuko_boot_quiet(MMUKO_System* sys);    // No boot log; safe on worker threads
+
+MMUKO_System* mmuko_system_create(size_t memory_size);
+MMUKO_System* mmuko_system_create_layout(size_t memory_size, MMUKO_Layout layout);
+void mmuko_system_destroy(MMUKO_System* sys);
+
+// Derived-state bytes per modelled byte in a layout
+size_t mmuko_layout_state_bytes(MMUKO_Layout layout);
+
+// Replace the raw bytes with `size` bytes of `data` (at most the creation
+// size) and reset the system for another boot. False if it does not fit
+bool mmuko_system_load(MMUKO_System* sys, const uint8_t* data, size_t size);
+
+// Run the ring layout's phases on `threads` threads (0: one per online CPU,
+// 1: single-threaded reference). Other layouts ignore the pool
+bool mmuko_system_set_threads(MMUKO_System* sys, int threads);
+
+// Any layout: materialize cubit `cubit_idx` of byte `byte_idx`
+bool mmuko_get_cubit(const MMUKO_System* sys, size_t byte_idx, int cubit_idx, Cubit* out);
+void mmuko_print_cubit_state(MMUKO_System* sys, size_t byte_idx, int cubit_idx);
+
+// FNV-1a over a layout-independent encoding of all derived state, so
+// layouts and execution modes can be compared for identical results
+uint64_t mmuko_state_digest(const MMUKO_System* sys);
+
+// The same digest in pieces: fold in each booted system's bytes in memory
+// order, then the frame of reference. Systems booted over consecutive
+// slices of an input give the digest of booting the input whole
+#define MMUKO_DIGEST_INIT 0xCBF29CE484222325ull
+uint64_t mmuko_state_digest_update(const MMUKO_System* sys, uint64_t hash);
+uint64_t mmuko_state_digest_range(const MMUKO_System* sys, size_t begin, size_t end,
+                                  uint64_t hash);
+uint64_t mmuko_state_digest_final(uint64_t hash, Direction frame);
+
+// The per-byte state the digest hashes, in plane order: raw, state lo/hi,
+// superposed, direction bits 0..2, undefined mask, base index, and
+// primary | secondary << 4. A ring can be rebuilt from its record
+#define MMUKO_STATE_RECORD_SIZE 10
+void mmuko_state_record(const MMUKO_System* sys, size_t b, uint8_t rec[MMUKO_STATE_RECORD_SIZE]);
+void mmuko_ring_record(const MMUKO_Byte* byte, uint8_t rec[MMUKO_STATE_RECORD_SIZE]);
+void mmuko_ring_from_record(MMUKO_Byte* byte, const uint8_t rec[MMUKO_STATE_RECORD_SIZE]);
+
+// ─────────────────────────────────────────────
+// BIT-PLANE LAYOUT (mmuko-planes.c)
+// ─────────────────────────────────────────────
+
+extern const MMUKO_PhaseFn mmuko_plane_phases[MMUKO_PHASE_COUNT];
+
+bool mmuko_planes_alloc(MMUKO_Planes* planes, size_t size);
+void mmuko_planes_free(MMUKO_Planes* planes);
+
+uint8_t mmuko_plane_direction(const MMUKO_Planes* planes, size_t b, int i);
+State mmuko_plane_state(const MMUKO_Planes* planes, size_t b, int i);
+
+// Phase 2 and 3 plane kernels on bytes [begin, end). Entangle dispatches
+// to the widest kernel set the CPU supports (mmuko-simd.c); the _scalar
+// version is the portable reference. Entangle returns the number of
+// resolved pairs
+void mmuko_planes_align(MMUKO_Planes* planes, size_t begin, size_t end);
+size_t mmuko_planes_entangle(MMUKO_Planes* planes, size_t begin, size_t end);
+size_t mmuko_planes_entangle_scalar(MMUKO_Planes* planes, size_t begin, size_t end,
+                                    uint8_t first, uint8_t second);
+
+// Kernel set: "auto", "scalar", "avx2" or "avx512". False if unknown or
+// not supported by this CPU
+bool mmuko_simd_select(const char* name);
+const char* mmuko_simd_name(void);
+
+// Phases 1–6 on bytes [begin, end), with the phase 4/5 superposition
+// packed per base index. Adds resolved pairs; false on a rotation lock
+bool mmuko_planes_fused_range(MMUKO_Planes* planes, size_t begin, size_t end,
+                              const uint8_t superposition[13], size_t* resolved);
+
+// ─────────────────────────────────────────────
+// FLYWEIGHT LAYOUT (mmuko-flyweight.c)
+// ─────────────────────────────────────────────
+
+extern const MMUKO_PhaseFn mmuko_flyweight_phases[MMUKO_PHASE_COUNT];
+
+bool mmuko_flyweight_alloc(MMUKO_Flyweight* fw, size_t size);
+void mmuko_flyweight_free(MMUKO_Flyweight* fw);
+
+const MMUKO_Byte* mmuko_flyweight_ring(const MMUKO_Flyweight* fw, size_t b);
+
+// ─────────────────────────────────────────────
+// PARALLEL EXECUTION (mmuko-parallel.c)
+// ─────────────────────────────────────────────
+
+// Memory map bytes per chunk handed to one worker: about an L2 cache
+#define MMUKO_PARALLEL_CHUNK_BYTES (256 * 1024)
+
+extern const MMUKO_PhaseFn mmuko_parallel_phases[MMUKO_PHASE_COUNT];
+
+// Called with a byte range [begin, end) of the memory map
+typedef void (*MMUKO_ChunkFn)(MMUKO_System* sys, size_t begin, size_t end, void* ctx);
+
+MMUKO_Pool* mmuko_pool_create(int threads);   // threads <= 0: one per online CPU
+
+// Pinned threads, each with a fixed contiguous share of every job's chunks
+// instead of claiming chunks as it goes. The caller is pinned too until
+// the pool is destroyed
+MMUKO_Pool* mmuko_pool_create_local(int threads);
+void mmuko_pool_destroy(MMUKO_Pool* pool);
+int mmuko_pool_threads(const MMUKO_Pool* pool);
+
+// Run `fn` over [0, count) in `chunk`-sized ranges on every pool thread,
+// including the caller. Returns once all ranges are done
+void mmuko_pool_run(MMUKO_Pool* pool, MMUKO_System* sys, size_t count, size_t chunk,
+                    MMUKO_ChunkFn fn, void* ctx);
+
+// Rings per chunk in the parallel phases: MMUKO_PARALLEL_CHUNK_BYTES of map
+size_t mmuko_ring_chunk(void);
+
+// ─────────────────────────────────────────────
+// LARGE-MAP PLACEMENT (mmuko-memory.c)
+// ─────────────────────────────────────────────
+
+#define MMUKO_PLACE_HUGE  0x1   // Reserved huge pages, else transparent huge pages
+#define MMUKO_PLACE_LOCAL 0x2   // First touch by the pinned pool thread that boots each chunk
+
+// A ring-layout system with its map in an anonymous mapping. With
+// MMUKO_PLACE_LOCAL the system gets a local pool of `threads` threads
+// (0: one per online CPU), each writing the test pattern into its own
+// chunks so their pages land on its NUMA node; otherwise `threads` is as
+// in mmuko_system_set_threads. Replacing the pool afterwards loses the
+// placement
+MMUKO_System* mmuko_system_create_placed(size_t memory_size, int threads, unsigned placement);
+
+// Release memory_map however it was allocated
+void mmuko_rings_free(MMUKO_System* sys);
+
+// Bytes of memory_map currently on huge pages, from /proc/self/smaps for
+// transparent huge pages (0 where that is unavailable)
+size_t mmuko_huge_bytes(const MMUKO_System* sys);
+const char* mmuko_pages_name(MMUKO_Pages pages);
+
+// ─────────────────────────────────────────────
+// FUSED EXECUTION (mmuko-fused.c)
+// ─────────────────────────────────────────────
+
+// Phases 1–6 in one pass over the rings or planes layout, on the pool when
+// one is set. False if the layout has no fused kernel or the pass saw a
+// fault; the caller then runs the phased sequence
+bool mmuko_fused_phases(MMUKO_System* sys);
+
+// ─────────────────────────────────────────────
+// FILE AND DEVICE SCAN (mmuko-scan.c)
+// ─────────────────────────────────────────────
+
+// Derived state kept per window when no window size is given
+#define MMUKO_SCAN_STATE_BUDGET (256u * 1024 * 1024)
+
+typedef struct {
+    size_t bytes;               // Input size
+    size_t window;              // Bytes booted at a time
+    size_t windows;             // Windows booted, including those of a resumed run
+    size_t resumed_offset;      // Where a resumed scan started, else 0
+    BootStatus status;          // First failure, or BOOT_OK
+    size_t fault_offset;        // Input offset of the failing window
+    uint64_t digest;            // As mmuko_state_digest over the whole input
+} MMUKO_ScanResult;
+
+// Boot a file or block device, mapped read-only, one `window` of bytes at a
+// time (0: MMUKO_SCAN_STATE_BUDGET of derived state) so inputs larger than
+// memory can be scanned. `threads` and `fused` apply to every window. With
+// a `checkpoint` path the position is saved there after every window, and
+// `resume` continues from it if it was saved for the same, unchanged input.
+// False if the input cannot be opened or mapped
+bool mmuko_scan_file(const char* path, MMUKO_Layout layout, size_t window,
+                     int threads, bool fused, const char* checkpoint, bool resume,
+                     MMUKO_ScanResult* out);
+
+// ─────────────────────────────────────────────
+// STREAMING PIPELINE (mmuko-pipeline.c)
+// ─────────────────────────────────────────────
+
+// Derived state per worker system when no chunk size is given
+#define MMUKO_STREAM_CHUNK_STATE (32u * 1024 * 1024)
+
+// Chunks buffered between the reader and each worker, and between each
+// worker and the merge stage (a power of two)
+#define MMUKO_STREAM_QUEUE_DEPTH 4
+
+// Input bytes per stream digest block. Chunks are whole blocks, so the
+// blocks sit at the same input offsets whatever the chunk size
+#define MMUKO_STREAM_DIGEST_BLOCK (64u * 1024)
+
+typedef struct {
+    size_t bytes;               // Input bytes booted
+    size_t chunk;               // Bytes per chunk, a whole number of digest blocks
+    size_t chunks;
+    int workers;
+    BootStatus status;          // First failure in input order, or BOOT_OK
+    size_t fault_offset;        // Input offset of the failing chunk
+    uint64_t digest;            // FNV-1a over the digest block digests in order
+    size_t reader_stalls;       // Times the reader waited on a full queue
+} MMUKO_StreamResult;
+
+// Boot everything read from `fd` (a file or pipe) in `chunk`-byte chunks
+// (0: MMUKO_STREAM_CHUNK_STATE of derived state; rounded up to whole
+// digest blocks) on `workers` threads (<= 0: one per online CPU), with a
+// reader thread ahead of them and the merge stage on the caller. Each
+// chunk is booted as its own system. The digest combines the
+// mmuko_state_digest of every MMUKO_STREAM_DIGEST_BLOCK of input, so it
+// is the same for any layout, chunk size and worker count. Memory use is
+// fixed by the chunk size, worker count and queue depth. False on a read
+// or setup error
+bool mmuko_stream_fd(int fd, MMUKO_Layout layout, size_t chunk, int workers,
+                     bool fused, MMUKO_StreamResult* out);
+
+// ─────────────────────────────────────────────
+// PHASE CHECKPOINTS (mmuko-checkpoint.c)
+// ─────────────────────────────────────────────
+
+// Bytes per write() while a checkpoint streams to disk
+#define MMUKO_CHECKPOINT_WRITE_CHUNK (8u * 1024 * 1024)
+
+// Write a checkpoint to `path` after every phase of mmuko_boot(), on a
+// writer thread while the next phase runs. With `resume`, the next boot
+// first restores the last phase recorded in `path`, if it holds a valid
+// checkpoint of the same memory size, and runs only the phases after it.
+// Rings and planes layouts; false for flyweight or on allocation failure
+bool mmuko_system_set_checkpoint(MMUKO_System* sys, const char* path, bool resume);
+
+// Called by mmuko_boot(): phases already done (0 if nothing was restored)
+// and their status; queue the state after `phase`; wait for the writer
+int mmuko_checkpoint_restore(MMUKO_System* sys, BootStatus* status);
+void mmuko_checkpoint_save(MMUKO_System* sys, int phase, BootStatus status);
+void mmuko_checkpoint_finish(MMUKO_System* sys);
+void mmuko_checkpoint_close(MMUKO_Checkpoint* checkpoint);
+
+// Where a file or device scan stands: the input it read, identified by
+// size, inode and modification time, and a checksum of the last window
+// it booted, which also catches rewritten block devices
+typedef struct {
+    uint64_t input_size;
+    uint64_t inode;
+    int64_t mtime_sec;
+    int64_t mtime_nsec;
+    uint64_t offset;            // Input bytes [0, offset) are booted
+    uint64_t windows;
+    uint64_t hash;              // mmuko_state_digest_update state at `offset`
+    uint32_t frame;             // frame_of_reference of the last window
+    uint32_t reserved;
+    uint64_t sample_length;     // Last window: input [offset - sample_length, offset)
+    uint64_t sample;            // mmuko_checkpoint_checksum of it
+} MMUKO_ScanProgress;
+
+// Replace the scan checkpoint at `path`, as phase checkpoints are replaced.
+// Load returns NULL, or why `path` holds no usable scan checkpoint
+bool mmuko_scan_checkpoint_save(const char* path, const MMUKO_ScanProgress* progress);
+const char* mmuko_scan_checkpoint_load(const char* path, MMUKO_ScanProgress* progress);
+uint64_t mmuko_checkpoint_checksum(const uint8_t* data, size_t length);
+
+// ─────────────────────────────────────────────
+// COPY-ON-WRITE FORKS (mmuko-fork.c)
+// ─────────────────────────────────────────────
+
+#define MMUKO_NO_OVERRIDE SIZE_MAX
+
+// A byte written in a fork, with its state booted from the new value
+typedef struct {
+    size_t byte;                                // MMUKO_NO_OVERRIDE marks an empty slot
+    uint8_t record[MMUKO_STATE_RECORD_SIZE];    // As mmuko_state_record
+    BootStatus status;                          // Fault this byte alone would cause
+} MMUKO_ForkEntry;
+
+// What-if view of a booted system: reads fall through to the baseline
+// except for written bytes, which live in a small overlay. The baseline
+// is never written, so any number of forks can share it across threads
+typedef struct {
+    const MMUKO_System* base;
+    uint8_t superposition[13];  // Phase 4/5 result by base index: primary | secondary << 4
+    MMUKO_ForkEntry* entries;   // Open addressing on the byte index
+    size_t count;
+    size_t capacity;            // Power of two, 0 until the first write
+} MMUKO_Fork;
+
+// False if `base` has not booted successfully
+bool mmuko_fork_init(MMUKO_Fork* fk, const MMUKO_System* base);
+void mmuko_fork_free(MMUKO_Fork* fk);
+
+// Give byte `b` a new raw value and boot it (phases 1–6 touch only that
+// byte). False if `b` is out of range or the overlay cannot grow
+bool mmuko_fork_write(MMUKO_Fork* fk, size_t b, uint8_t value);
+
+void mmuko_fork_record(const MMUKO_Fork* fk, size_t b, uint8_t rec[MMUKO_STATE_RECORD_SIZE]);
+
+// Status a full boot of the fork's memory would return, with the byte it
+// would report in *fault_byte (SIZE_MAX when BOOT_OK)
+BootStatus mmuko_fork_status(const MMUKO_Fork* fk, size_t* fault_byte);
+
+// Written bytes whose booted state differs from the baseline
+size_t mmuko_fork_changed(const MMUKO_Fork* fk);
+
+// Heap bytes held by the overlay
+size_t mmuko_fork_bytes(const MMUKO_Fork* fk);
+
+// Bytes of state per digest tree leaf
+#define MMUKO_FORK_DIGEST_BLOCK 256
+
+// FNV-1a of each block's state records, as mmuko_state_digest hashes
+// them, combined pairwise up a binary tree (heap order, leaves at
+// [width, width + blocks), missing leaves 0). The root, finalized with
+// the frame of reference, digests the whole state
+typedef struct {
+    uint64_t* nodes;
+    size_t blocks;
+    size_t width;               // Power of two >= blocks
+    Direction frame;
+} MMUKO_DigestTree;
+
+// Build over a booted system; false on allocation failure
+bool mmuko_digest_tree_build(MMUKO_DigestTree* tree, const MMUKO_System* sys);
+void mmuko_digest_tree_free(MMUKO_DigestTree* tree);
+uint64_t mmuko_digest_tree_root(const MMUKO_DigestTree* tree);
+
+// Digest tree root a full boot of the fork's memory would have, when it
+// succeeds, from `tree` built over the fork's baseline: O(writes * (block
+// + log blocks)). False on allocation failure
+bool mmuko_fork_digest(const MMUKO_Fork* fk, const MMUKO_DigestTree* tree, uint64_t* digest);
+
+// ─────────────────────────────────────────────
+// BITMAP INDEXES (mmuko-index.c)
+// ─────────────────────────────────────────────
+
+// A bitmap compressed like EWAH into runs of 64-bit words. A fill
+// repeats a pattern of one word or a few, which need not be empty or
+// full: a word of a cubit bitmap holds the cubits of eight bytes, so
+// cubit attributes that repeat in every byte, such as the cubit
+// directions, fill as well as empty stretches do, and data that repeats
+// every few hundred bytes fills with that period. Words that fit no fill
+// are kept as literal runs of at most 1024 words, or, when they hold
+// fewer set bits than they cost in words, as array runs of the set
+// bits' offsets from the run's first word
+typedef enum {
+    MMUKO_RUN_FILL,     // A pattern of `length` words repeated
+    MMUKO_RUN_LITERAL,  // One word per position
+    MMUKO_RUN_ARRAY     // `length` sorted 16-bit offsets
+} MMUKO_RunKind;
+
+typedef struct {
+    size_t end;         // Word index just past the run
+    size_t word;        // Offset of the run's first word in `words`, or of
+                        // an array run's first offset in `offsets`
+    uint32_t length;    // Words of a fill's pattern, offsets of an array run
+    uint8_t kind;       // MMUKO_RunKind
+} MMUKO_BitmapRun;
+
+typedef struct {
+    MMUKO_BitmapRun* runs;
+    size_t run_count;
+    size_t run_capacity;
+    uint64_t* words;    // Fill words and literal words
+    size_t word_count;
+    size_t word_capacity;
+    uint16_t* offsets;  // Set bits of array runs
+    size_t offset_count;
+    size_t offset_capacity;
+} MMUKO_Bitmap;
+
+// Indexed attributes. Cubit attributes are indexed over cubit positions
+// (byte * 8 + cubit) and byte attributes over byte positions, one bit a
+// byte; a query expands each byte bit to the byte's eight cubits
+typedef enum {
+    MMUKO_INDEX_DIRECTION,      // Cubit direction, N..UNDEFINED_DIR
+    MMUKO_INDEX_STATE,          // Cubit state, UP..STRANGE
+    MMUKO_INDEX_SUPERPOSED,     // Cubit superposed flag, 0 or 1
+    MMUKO_INDEX_BASE,           // Byte base_index, 0..12
+    MMUKO_INDEX_PRIMARY,        // Byte primary superposition, N..UNDEFINED_DIR
+    MMUKO_INDEX_SECONDARY,      // Byte secondary superposition, N..UNDEFINED_DIR
+    MMUKO_INDEX_ATTRIBUTES
+} MMUKO_IndexAttribute;
+
+#define MMUKO_INDEX_VALUES 13   // Values of the widest attribute (base_index)
+
+// One bitmap per attribute value, built from a booted system and not
+// updated by later boots
+typedef struct {
+    size_t memory_size;
+    size_t cubit_words;         // Words in each uncompressed cubit bitmap
+    size_t byte_words;          // Words in each uncompressed byte bitmap
+    MMUKO_Bitmap bitmaps[MMUKO_INDEX_ATTRIBUTES][MMUKO_INDEX_VALUES];
+} MMUKO_Index;
+
+// attribute == value
+typedef struct {
+    MMUKO_IndexAttribute attribute;
+    int value;
+} MMUKO_IndexTerm;
+
+// False if `sys` has not booted successfully or memory runs out
+bool mmuko_index_build(MMUKO_Index* index, const MMUKO_System* sys);
+void mmuko_index_free(MMUKO_Index* index);
+
+// Values an attribute can take, and its bitmap for one of them
+int mmuko_index_values(MMUKO_IndexAttribute attribute);
+const MMUKO_Bitmap* mmuko_index_bitmap(const MMUKO_Index* index, MMUKO_IndexAttribute attribute,
+                                       int value);
+
+// Cubits of bytes [begin, end) matching every term, by ANDing the terms'
+// bitmaps run by run. No terms counts every cubit in the range
+size_t mmuko_index_count(const MMUKO_Index* index, const MMUKO_IndexTerm* terms, int term_count,
+                         size_t begin, size_t end);
+
+// Heap bytes held by the bitmaps
+size_t mmuko_index_bytes(const MMUKO_Index* index);
+size_t mmuko_index_runs(const MMUKO_Index* index);
+
+// "attribute=value", e.g. "state=STRANGE", "direction=SW", "base=6".
+// Directions and states take the names direction_to_string and
+// state_to_string print, or the enum names
+bool mmuko_index_parse_term(const char* text, MMUKO_IndexTerm* term);
+
+#endif // MMUKO_BOOT_H
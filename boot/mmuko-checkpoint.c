@@ -0,0 +1,459 @@
+// ============================================================
+// MMUKO-CHECKPOINT.C — Phase-Boundary Checkpoints and Resume
+// Project: OBINexus / OBIELF R&D
+// ============================================================
+//
+// After every phase the boot thread copies the derived state into
+// a snapshot buffer in the layout-independent record encoding,
+// stored plane-major: ten planes of memory_size bytes, the same
+// planes as the bit-plane layout. A writer thread streams it to a
+// temporary file in MMUKO_CHECKPOINT_WRITE_CHUNK pieces while the
+// next phase runs, checksumming as it goes, then writes the 64-byte
+// header, syncs and renames the file over the previous checkpoint.
+// A crash therefore leaves either the old checkpoint or the new
+// one, never a torn file. The boot waits for the writer only
+// before the next snapshot reuses the buffer.
+//
+// File: header, then plane k at offset 64 + k * memory_size, so the
+// planes can be mapped and used in place.
+//
+// File and device scans checkpoint their position instead: a header
+// alone with the input's identity, the offset every window before
+// which is booted, and the digest state there, replaced the same way
+// after every window.
+// ============================================================
+
+#define _GNU_SOURCE     // sync_file_range
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "mmuko-boot.h"
+
+#define CHECKPOINT_MAGIC "MMUKOCKP"
+#define SCAN_CHECKPOINT_MAGIC "MMUKOSCN"
+#define CHECKPOINT_VERSION 2       // 2: the checksum covers the header
+#define CHECKPOINT_HEADER 64
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t phase;             // Phases 1..phase have run
+    uint32_t status;            // BootStatus of the last of them
+    uint32_t frame;             // frame_of_reference
+    uint64_t memory_size;
+    uint64_t checksum;          // Over the planes, then this header with it zeroed
+    uint8_t reserved[CHECKPOINT_HEADER - 40];
+} CheckpointHeader;
+
+_Static_assert(sizeof(CheckpointHeader) == CHECKPOINT_HEADER, "checkpoint header is 64 bytes");
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved;
+    MMUKO_ScanProgress progress;
+    uint64_t checksum;          // Over everything before it
+} ScanCheckpointFile;
+
+struct MMUKO_Checkpoint {
+    char* path;
+    char* temp_path;            // path + ".tmp", renamed over path when complete
+    bool resume;                // Restore at the next boot, then cleared
+
+    uint8_t* snapshot;          // MMUKO_STATE_RECORD_SIZE planes of `size` bytes
+    size_t capacity;            // Bytes per plane the snapshot can hold
+    CheckpointHeader header;
+
+    pthread_t writer;
+    bool writing;               // A writer thread owns the snapshot
+    int error;                  // errno of the first failed write; stops checkpointing
+    int written;                // Checkpoints completed this boot
+    double waited;              // Seconds the boot spent waiting on the writer
+};
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+// 64-bit multiply-xorshift over whole words, then the tail bytes
+static uint64_t checksum_update(uint64_t hash, const uint8_t* data, size_t length) {
+    size_t i = 0;
+    for (; i + 8 <= length; i += 8) {
+        uint64_t word;
+        memcpy(&word, data + i, 8);
+        hash = (hash ^ word) * 0x9E3779B97F4A7C15ull;
+        hash ^= hash >> 29;
+    }
+    for (; i < length; i++) {
+        hash = (hash ^ data[i]) * 0x100000001B3ull;
+    }
+    return hash;
+}
+
+// Fold the header into the planes' hash, so a torn or edited header
+// cannot resume at the wrong phase, status or frame
+static uint64_t checksum_header(uint64_t hash, const CheckpointHeader* header) {
+    CheckpointHeader copy = *header;
+    copy.checksum = 0;
+    return checksum_update(hash, (const uint8_t*)&copy, sizeof(copy));
+}
+
+// ─────────────────────────────────────────────
+// ENCODING
+// ─────────────────────────────────────────────
+
+static void encode_state(const MMUKO_System* sys, uint8_t* planes) {
+    size_t size = sys->memory_size;
+
+    if (sys->layout == MMUKO_LAYOUT_PLANES) {
+        const MMUKO_Planes* p = &sys->planes;
+        const uint8_t* sources[MMUKO_STATE_RECORD_SIZE] = {
+            p->raw, p->state_lo, p->state_hi, p->superposed, p->direction[0],
+            p->direction[1], p->direction[2], p->undefined, p->base_index, p->superposition
+        };
+        for (int k = 0; k < MMUKO_STATE_RECORD_SIZE; k++) {
+            memcpy(planes + (size_t)k * size, sources[k], size);
+        }
+        return;
+    }
+
+    uint8_t rec[MMUKO_STATE_RECORD_SIZE];
+    for (size_t b = 0; b < size; b++) {
+        mmuko_state_record(sys, b, rec);
+        for (int k = 0; k < MMUKO_STATE_RECORD_SIZE; k++) {
+            planes[(size_t)k * size + b] = rec[k];
+        }
+    }
+}
+
+static void decode_state(MMUKO_System* sys, const uint8_t* planes) {
+    size_t size = sys->memory_size;
+
+    if (sys->layout == MMUKO_LAYOUT_PLANES) {
+        MMUKO_Planes* p = &sys->planes;
+        uint8_t* targets[MMUKO_STATE_RECORD_SIZE] = {
+            p->raw, p->state_lo, p->state_hi, p->superposed, p->direction[0],
+            p->direction[1], p->direction[2], p->undefined, p->base_index, p->superposition
+        };
+        for (int k = 0; k < MMUKO_STATE_RECORD_SIZE; k++) {
+            memcpy(targets[k], planes + (size_t)k * size, size);
+        }
+        return;
+    }
+
+    uint8_t rec[MMUKO_STATE_RECORD_SIZE];
+    for (size_t b = 0; b < size; b++) {
+        for (int k = 0; k < MMUKO_STATE_RECORD_SIZE; k++) {
+            rec[k] = planes[(size_t)k * size + b];
+        }
+        mmuko_ring_from_record(&sys->memory_map[b], rec);
+    }
+}
+
+// ─────────────────────────────────────────────
+// WRITER
+// ─────────────────────────────────────────────
+
+static bool write_all(int fd, const uint8_t* data, size_t length, off_t offset) {
+    while (length > 0) {
+        ssize_t n = pwrite(fd, data, length, offset);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data += n;
+        length -= (size_t)n;
+        offset += n;
+    }
+    return true;
+}
+
+// Stream the snapshot out a chunk at a time. Writeback of each chunk is
+// started at once; the chunk before it is then waited for and dropped
+// from the page cache, so a large checkpoint does not evict the map
+static bool write_planes(MMUKO_Checkpoint* cp, int fd, size_t length) {
+    uint64_t hash = 0xCBF29CE484222325ull;
+    off_t previous = -1;
+
+    for (size_t done = 0; done < length; done += MMUKO_CHECKPOINT_WRITE_CHUNK) {
+        size_t piece = length - done < MMUKO_CHECKPOINT_WRITE_CHUNK ? length - done
+                                                                    : MMUKO_CHECKPOINT_WRITE_CHUNK;
+        off_t offset = CHECKPOINT_HEADER + (off_t)done;
+        hash = checksum_update(hash, cp->snapshot + done, piece);
+        if (!write_all(fd, cp->snapshot + done, piece, offset)) return false;
+
+#ifdef SYNC_FILE_RANGE_WRITE
+        sync_file_range(fd, offset, (off_t)piece, SYNC_FILE_RANGE_WRITE);
+        if (previous >= 0) {
+            sync_file_range(fd, previous, MMUKO_CHECKPOINT_WRITE_CHUNK,
+                            SYNC_FILE_RANGE_WAIT_BEFORE | SYNC_FILE_RANGE_WRITE |
+                            SYNC_FILE_RANGE_WAIT_AFTER);
+            posix_fadvise(fd, previous, MMUKO_CHECKPOINT_WRITE_CHUNK, POSIX_FADV_DONTNEED);
+        }
+#endif
+        previous = offset;
+    }
+
+    cp->header.checksum = checksum_header(hash, &cp->header);
+    return true;
+}
+
+static void* writer_main(void* arg) {
+    MMUKO_Checkpoint* cp = (MMUKO_Checkpoint*)arg;
+    size_t length = (size_t)cp->header.memory_size * MMUKO_STATE_RECORD_SIZE;
+
+    int fd = open(cp->temp_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    bool ok = fd >= 0 && write_planes(cp, fd, length) &&
+              write_all(fd, (const uint8_t*)&cp->header, sizeof(cp->header), 0) &&
+              fdatasync(fd) == 0;
+    if (!ok) cp->error = errno ? errno : EIO;
+    if (fd >= 0 && close(fd) != 0 && ok) {
+        cp->error = errno;
+        ok = false;
+    }
+
+    if (ok && rename(cp->temp_path, cp->path) != 0) {
+        cp->error = errno;
+        ok = false;
+    }
+    if (!ok) {
+        unlink(cp->temp_path);
+    } else {
+        cp->written++;
+    }
+    return NULL;
+}
+
+static void report_error(const MMUKO_Checkpoint* cp) {
+    if (cp->error) {
+        printf("[CHECKPOINT] Writing %s failed: %s; no further checkpoints\n",
+               cp->path, strerror(cp->error));
+    }
+}
+
+static void wait_writer(MMUKO_Checkpoint* cp) {
+    if (!cp->writing) return;
+
+    double start = now_seconds();
+    pthread_join(cp->writer, NULL);
+    cp->waited += now_seconds() - start;
+    cp->writing = false;
+    report_error(cp);
+}
+
+// ─────────────────────────────────────────────
+// BOOT HOOKS
+// ─────────────────────────────────────────────
+
+void mmuko_checkpoint_save(MMUKO_System* sys, int phase, BootStatus status) {
+    MMUKO_Checkpoint* cp = sys->checkpoint;
+    wait_writer(cp);
+    if (cp->error) return;
+
+    if (sys->memory_size > cp->capacity) {
+        uint8_t* snapshot = (uint8_t*)realloc(cp->snapshot, sys->memory_size * MMUKO_STATE_RECORD_SIZE);
+        if (!snapshot) {
+            printf("[CHECKPOINT] Out of memory for a %zu-byte snapshot; no further checkpoints\n",
+                   sys->memory_size * MMUKO_STATE_RECORD_SIZE);
+            cp->error = ENOMEM;
+            return;
+        }
+        cp->snapshot = snapshot;
+        cp->capacity = sys->memory_size;
+    }
+
+    encode_state(sys, cp->snapshot);
+    memset(&cp->header, 0, sizeof(cp->header));
+    memcpy(cp->header.magic, CHECKPOINT_MAGIC, sizeof(cp->header.magic));
+    cp->header.version = CHECKPOINT_VERSION;
+    cp->header.phase = (uint32_t)phase;
+    cp->header.status = (uint32_t)status;
+    cp->header.frame = (uint32_t)sys->frame_of_reference;
+    cp->header.memory_size = sys->memory_size;
+
+    // The next phase runs while this one is written
+    printf("[CHECKPOINT] Phase %d state queued for %s\n", phase, cp->path);
+    cp->writing = pthread_create(&cp->writer, NULL, writer_main, cp) == 0;
+    if (!cp->writing) {
+        writer_main(cp);
+        report_error(cp);
+    }
+}
+
+void mmuko_checkpoint_finish(MMUKO_System* sys) {
+    MMUKO_Checkpoint* cp = sys->checkpoint;
+    wait_writer(cp);
+    printf("[CHECKPOINT] %d checkpoints written, boot waited %.3f s on the writer\n",
+           cp->written, cp->waited);
+    cp->written = 0;
+    cp->waited = 0.0;
+}
+
+// Why `map` cannot be resumed into `sys`, or NULL if it can
+static const char* checkpoint_problem(const MMUKO_System* sys, const uint8_t* map, size_t length) {
+    const CheckpointHeader* header = (const CheckpointHeader*)map;
+
+    if (length < CHECKPOINT_HEADER || memcmp(header->magic, CHECKPOINT_MAGIC, 8) != 0) {
+        return "not a checkpoint";
+    }
+    if (header->version != CHECKPOINT_VERSION) return "unsupported version";
+    if (header->memory_size != sys->memory_size) return "different memory size";
+    if (length != CHECKPOINT_HEADER + sys->memory_size * MMUKO_STATE_RECORD_SIZE) return "truncated";
+    if (header->phase < 1 || header->phase > MMUKO_PHASE_COUNT) return "bad phase";
+
+    uint64_t hash = checksum_update(0xCBF29CE484222325ull, map + CHECKPOINT_HEADER,
+                                    length - CHECKPOINT_HEADER);
+    return checksum_header(hash, header) == header->checksum ? NULL : "checksum mismatch";
+}
+
+int mmuko_checkpoint_restore(MMUKO_System* sys, BootStatus* status) {
+    MMUKO_Checkpoint* cp = sys->checkpoint;
+    *status = BOOT_OK;
+    if (!cp->resume) return 0;
+    cp->resume = false;
+
+    int fd = open(cp->path, O_RDONLY);
+    if (fd < 0) {
+        printf("[CHECKPOINT] No checkpoint at %s, booting from phase 1\n", cp->path);
+        return 0;
+    }
+    struct stat st;
+    void* map = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+        map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if (map == MAP_FAILED) {
+        printf("[CHECKPOINT] Cannot map %s, booting from phase 1\n", cp->path);
+        return 0;
+    }
+
+    const uint8_t* data = (const uint8_t*)map;
+    const char* problem = checkpoint_problem(sys, data, (size_t)st.st_size);
+    if (problem) {
+        printf("[CHECKPOINT] Ignoring %s (%s), booting from phase 1\n", cp->path, problem);
+        munmap(map, (size_t)st.st_size);
+        return 0;
+    }
+
+    const CheckpointHeader* header = (const CheckpointHeader*)data;
+    int phase = (int)header->phase;
+    madvise(map, (size_t)st.st_size, MADV_SEQUENTIAL);
+    decode_state(sys, data + CHECKPOINT_HEADER);
+    sys->frame_of_reference = (Direction)header->frame;
+    *status = (BootStatus)header->status;
+    munmap(map, (size_t)st.st_size);
+
+    if (*status != BOOT_OK) {
+        printf("[CHECKPOINT] %s records phase %d failing with status %d\n",
+               cp->path, phase, *status);
+    } else {
+        printf("[CHECKPOINT] Resumed after phase %d from %s\n", phase, cp->path);
+    }
+    return phase;
+}
+
+// ─────────────────────────────────────────────
+// SCAN PROGRESS
+// ─────────────────────────────────────────────
+
+uint64_t mmuko_checkpoint_checksum(const uint8_t* data, size_t length) {
+    return checksum_update(0xCBF29CE484222325ull, data, length);
+}
+
+bool mmuko_scan_checkpoint_save(const char* path, const MMUKO_ScanProgress* progress) {
+    ScanCheckpointFile file;
+    memset(&file, 0, sizeof(file));
+    memcpy(file.magic, SCAN_CHECKPOINT_MAGIC, sizeof(file.magic));
+    file.version = CHECKPOINT_VERSION;
+    file.progress = *progress;
+    file.checksum = mmuko_checkpoint_checksum((const uint8_t*)&file, offsetof(ScanCheckpointFile, checksum));
+
+    size_t length = strlen(path);
+    char* temp_path = (char*)malloc(length + sizeof(".tmp"));
+    if (!temp_path) return false;
+    memcpy(temp_path, path, length);
+    memcpy(temp_path + length, ".tmp", sizeof(".tmp"));
+
+    int fd = open(temp_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    bool ok = fd >= 0 && write_all(fd, (const uint8_t*)&file, sizeof(file), 0) && fdatasync(fd) == 0;
+    if (fd >= 0 && close(fd) != 0) ok = false;
+    ok = ok && rename(temp_path, path) == 0;
+    if (!ok) {
+        int error = errno;
+        unlink(temp_path);
+        errno = error;
+    }
+    free(temp_path);
+    return ok;
+}
+
+const char* mmuko_scan_checkpoint_load(const char* path, MMUKO_ScanProgress* progress) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return "no checkpoint";
+
+    ScanCheckpointFile file;
+    ssize_t n = pread(fd, &file, sizeof(file), 0);
+    close(fd);
+    if (n != (ssize_t)sizeof(file) || memcmp(file.magic, SCAN_CHECKPOINT_MAGIC, 8) != 0) {
+        return "not a scan checkpoint";
+    }
+    if (file.version != CHECKPOINT_VERSION) return "unsupported version";
+    if (mmuko_checkpoint_checksum((const uint8_t*)&file, offsetof(ScanCheckpointFile, checksum)) !=
+        file.checksum) {
+        return "checksum mismatch";
+    }
+    *progress = file.progress;
+    return NULL;
+}
+
+// ─────────────────────────────────────────────
+// SETUP
+// ─────────────────────────────────────────────
+
+bool mmuko_system_set_checkpoint(MMUKO_System* sys, const char* path, bool resume) {
+    if (sys->layout == MMUKO_LAYOUT_FLYWEIGHT) return false;
+
+    MMUKO_Checkpoint* cp = (MMUKO_Checkpoint*)calloc(1, sizeof(MMUKO_Checkpoint));
+    if (!cp) return false;
+    size_t length = strlen(path);
+    cp->path = (char*)malloc(length + 1);
+    cp->temp_path = (char*)malloc(length + sizeof(".tmp"));
+    if (!cp->path || !cp->temp_path) {
+        mmuko_checkpoint_close(cp);
+        return false;
+    }
+    memcpy(cp->path, path, length + 1);
+    memcpy(cp->temp_path, path, length);
+    memcpy(cp->temp_path + length, ".tmp", sizeof(".tmp"));
+    cp->resume = resume;
+
+    mmuko_checkpoint_close(sys->checkpoint);
+    sys->checkpoint = cp;
+    return true;
+}
+
+void mmuko_checkpoint_close(MMUKO_Checkpoint* checkpoint) {
+    if (!checkpoint) return;
+    if (checkpoint->writing) pthread_join(checkpoint->writer, NULL);
+    free(checkpoint->snapshot);
+    free(checkpoint->path);
+    free(checkpoint->temp_path);
+    free(checkpoint);
+}
+
+// ============================================================
+// END OF MMUKO-CHECKPOINT.C
+// ============================================================
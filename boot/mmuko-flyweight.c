@@ -0,0 +1,194 @@
+// ============================================================
+// MMUKO-FLYWEIGHT.C — Shared-Ring Layout for the MMUKO Memory Map
+// Project: OBINexus / OBIELF R&D
+// ============================================================
+//
+// Every phase is a per-ring function of the ring's own contents,
+// and phase 1 derives a ring from raw_value alone, so bytes with the
+// same raw value stay identical through the whole boot. The flyweight
+// layout stores one ring per raw value (starting from the compile-time
+// canonical table) and runs phases 2–6 on those 256 rings. Phase 1 is
+// a histogram pass over the raw bytes.
+// ============================================================
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "mmuko-boot.h"
+
+// ─────────────────────────────────────────────
+// STORAGE
+// ─────────────────────────────────────────────
+
+bool mmuko_flyweight_alloc(MMUKO_Flyweight* fw, size_t size) {
+    memset(fw, 0, sizeof(*fw));
+    fw->raw = (uint8_t*)calloc(size ? size : 1, 1);
+    return fw->raw != NULL;
+}
+
+void mmuko_flyweight_free(MMUKO_Flyweight* fw) {
+    free(fw->raw);
+    fw->raw = NULL;
+}
+
+const MMUKO_Byte* mmuko_flyweight_ring(const MMUKO_Flyweight* fw, size_t b) {
+    return &fw->classes[fw->raw[b]];
+}
+
+// ─────────────────────────────────────────────
+// FAULT LOCATION
+// ─────────────────────────────────────────────
+
+// A phase step that reports a cubit (or -1) for one ring
+typedef int (*RingCheck)(MMUKO_Byte* ring);
+
+// Run `check` once on every class. If any populated class faults, find
+// the first byte in memory order that uses a faulting class, matching
+// what the byte-by-byte reference loop would report
+static bool apply_check(MMUKO_System* sys, RingCheck check, size_t* fault_byte, int* fault_cubit) {
+    MMUKO_Flyweight* fw = &sys->flyweight;
+    int class_fault[256];
+    bool any = false;
+
+    for (int v = 0; v < 256; v++) {
+        class_fault[v] = check(&fw->classes[v]);
+        any |= class_fault[v] >= 0 && fw->population[v] > 0;
+    }
+    if (!any) return false;
+
+    for (size_t b = 0; b < sys->memory_size; b++) {
+        int cubit = class_fault[fw->raw[b]];
+        if (cubit >= 0) {
+            *fault_byte = b;
+            *fault_cubit = cubit;
+            return true;
+        }
+    }
+    return false;
+}
+
+static int rotation_check(MMUKO_Byte* ring) {
+    return mmuko_ring_rotation_lock(ring);
+}
+
+// ─────────────────────────────────────────────
+// PHASES
+// ─────────────────────────────────────────────
+
+static BootStatus flyweight_phase1_cubit_init(MMUKO_System* sys) {
+    MMUKO_LOG(sys, "[PHASE 1] Initializing cubit rings (flyweight)...\n");
+
+    MMUKO_Flyweight* fw = &sys->flyweight;
+    memcpy(fw->classes, mmuko_canonical_rings, sizeof(fw->classes));
+    memset(fw->population, 0, sizeof(fw->population));
+
+    for (size_t b = 0; b < sys->memory_size; b++) {
+        fw->population[fw->raw[b]]++;
+    }
+
+    int distinct = 0;
+    for (int v = 0; v < 256; v++) {
+        distinct += fw->population[v] > 0;
+    }
+    MMUKO_LOG(sys, "[PHASE 1] Initialized %zu cubit rings (%d distinct)\n", sys->memory_size, distinct);
+    return BOOT_OK;
+}
+
+static BootStatus flyweight_phase2_compass_alignment(MMUKO_System* sys) {
+    MMUKO_LOG(sys, "[PHASE 2] Compass alignment...\n");
+
+    size_t byte;
+    int cubit;
+    if (apply_check(sys, mmuko_ring_align, &byte, &cubit)) {
+        MMUKO_LOG(sys, "[ERROR] Boot lock detected at byte %zu, cubit %d\n", byte, cubit);
+        return BOOT_LOCK_DETECTED;
+    }
+
+    MMUKO_LOG(sys, "[PHASE 2] All cubits aligned to compass directions\n");
+    return BOOT_OK;
+}
+
+static BootStatus flyweight_phase3_superposition_entanglement(MMUKO_System* sys) {
+    MMUKO_LOG(sys, "[PHASE 3] Entangling superposition pairs...\n");
+
+    MMUKO_Flyweight* fw = &sys->flyweight;
+    size_t resolved = 0;
+
+    for (int v = 0; v < 256; v++) {
+        uint8_t pairs = mmuko_ring_entangle(&fw->classes[v]);
+        resolved += (size_t)__builtin_popcount(pairs) * fw->population[v];
+    }
+
+    MMUKO_LOG(sys, "[PHASE 3] Resolved interference in %zu pairs\n", resolved);
+    MMUKO_LOG(sys, "[PHASE 3] Superposition entanglement complete\n");
+    return BOOT_OK;
+}
+
+static void set_superposition(MMUKO_Byte* ring, Direction primary, Direction secondary) {
+    ring->primary_superposition = primary;
+    ring->secondary_superposition = secondary;
+}
+
+static BootStatus flyweight_phase4_frame_centering(MMUKO_System* sys) {
+    MMUKO_LOG(sys, "[PHASE 4] Frame of reference centering...\n");
+
+    MMUKO_Flyweight* fw = &sys->flyweight;
+    Direction primary, secondary;
+    lookup_superposition(get_middle_base(), &primary, &secondary);
+    set_frame_of_reference(sys, primary);
+
+    for (int v = 0; v < 256; v++) {
+        set_superposition(&fw->classes[v], primary, secondary);
+    }
+
+    return BOOT_OK;
+}
+
+static BootStatus flyweight_phase5_nonlinear_resolution(MMUKO_System* sys) {
+    MMUKO_LOG(sys, "[PHASE 5] Nonlinear index resolution (diamond table)...\n");
+
+    MMUKO_Flyweight* fw = &sys->flyweight;
+    for (int d = 0; d < MMUKO_DIAMOND_SIZE; d++) {
+        int base = mmuko_diamond_order[d];
+        Direction primary, secondary;
+        lookup_superposition(base, &primary, &secondary);
+
+        for (int v = 0; v < 256; v++) {
+            if (fw->classes[v].base_index == base) {
+                set_superposition(&fw->classes[v], primary, secondary);
+            }
+        }
+        MMUKO_LOG(sys, "[PHASE 5] Base %d resolved → %s/%s\n",
+               base, direction_to_string(primary), direction_to_string(secondary));
+    }
+
+    return BOOT_OK;
+}
+
+static BootStatus flyweight_phase6_rotation_verification(MMUKO_System* sys) {
+    MMUKO_LOG(sys, "[PHASE 6] Rotation freedom check...\n");
+
+    size_t byte;
+    int cubit;
+    if (apply_check(sys, rotation_check, &byte, &cubit)) {
+        MMUKO_LOG(sys, "[ERROR] Rotation lock at byte %zu, cubit %d\n", byte, cubit);
+        return BOOT_ROTATION_LOCK;
+    }
+
+    MMUKO_LOG(sys, "[PHASE 6] All cubits rotate freely (360° verified)\n");
+    return BOOT_OK;
+}
+
+const MMUKO_PhaseFn mmuko_flyweight_phases[MMUKO_PHASE_COUNT] = {
+    flyweight_phase1_cubit_init,
+    flyweight_phase2_compass_alignment,
+    flyweight_phase3_superposition_entanglement,
+    flyweight_phase4_frame_centering,
+    flyweight_phase5_nonlinear_resolution,
+    flyweight_phase6_rotation_verification
+};
+
+// ============================================================
+// END OF MMUKO-FLYWEIGHT.C
+// ============================================================
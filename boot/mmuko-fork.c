@@ -0,0 +1,305 @@
+// ============================================================
+// MMUKO-FORK.C — Copy-on-Write What-If Boots
+// Project: OBINexus / OBIELF R&D
+// ============================================================
+//
+// Phases 1–6 are per-byte functions of the byte's raw value and the
+// fixed phase 4/5 superposition table, so changing a byte of a booted
+// system changes that byte's state and nothing else. A fork is
+// therefore an overlay on a shared baseline: each written byte is
+// booted on its own into a state record, kept in an open-addressing
+// table, and every other read falls through to the baseline. A fork
+// costs memory for the bytes it writes rather than for pages, and
+// forks never write the baseline, so many of them can be evaluated at
+// once on different threads.
+//
+// Fork digests come from a digest tree over fixed blocks of state,
+// built once for the baseline: a fork rehashes only the blocks it
+// wrote and their paths to the root, so its digest costs time for
+// its writes rather than for the memory size.
+// ============================================================
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "mmuko-boot.h"
+
+// ─────────────────────────────────────────────
+// OVERLAY
+// ─────────────────────────────────────────────
+
+static size_t entry_slot(const MMUKO_Fork* fk, size_t b) {
+    size_t mask = fk->capacity - 1;
+    size_t slot = (size_t)((b * 0x9E3779B97F4A7C15ull) >> 20) & mask;
+    while (fk->entries[slot].byte != MMUKO_NO_OVERRIDE && fk->entries[slot].byte != b) {
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+static const MMUKO_ForkEntry* find_entry(const MMUKO_Fork* fk, size_t b) {
+    if (fk->count == 0) return NULL;
+    const MMUKO_ForkEntry* entry = &fk->entries[entry_slot(fk, b)];
+    return entry->byte == b ? entry : NULL;
+}
+
+static bool grow_entries(MMUKO_Fork* fk) {
+    size_t capacity = fk->capacity ? fk->capacity * 2 : 16;
+    MMUKO_ForkEntry* old = fk->entries;
+    size_t old_capacity = fk->capacity;
+
+    fk->entries = (MMUKO_ForkEntry*)malloc(capacity * sizeof(MMUKO_ForkEntry));
+    if (!fk->entries) {
+        fk->entries = old;
+        return false;
+    }
+    for (size_t i = 0; i < capacity; i++) {
+        fk->entries[i].byte = MMUKO_NO_OVERRIDE;
+    }
+    fk->capacity = capacity;
+
+    for (size_t i = 0; i < old_capacity; i++) {
+        if (old[i].byte != MMUKO_NO_OVERRIDE) {
+            fk->entries[entry_slot(fk, old[i].byte)] = old[i];
+        }
+    }
+    free(old);
+    return true;
+}
+
+bool mmuko_fork_init(MMUKO_Fork* fk, const MMUKO_System* base) {
+    memset(fk, 0, sizeof(*fk));
+    if (!base->boot_complete) return false;
+    fk->base = base;
+
+    // Phase 4 centres every base; phase 5 then overrides the diamond bases
+    Direction primary, secondary;
+    lookup_superposition(get_middle_base(), &primary, &secondary);
+    for (int base_index = 0; base_index < 13; base_index++) {
+        fk->superposition[base_index] = (uint8_t)(primary | (secondary << 4));
+    }
+    for (int i = 0; i < MMUKO_DIAMOND_SIZE; i++) {
+        int base_index = mmuko_diamond_order[i];
+        lookup_superposition(base_index, &primary, &secondary);
+        fk->superposition[base_index] = (uint8_t)(primary | (secondary << 4));
+    }
+    return true;
+}
+
+void mmuko_fork_free(MMUKO_Fork* fk) {
+    free(fk->entries);
+    fk->entries = NULL;
+    fk->count = 0;
+    fk->capacity = 0;
+}
+
+// ─────────────────────────────────────────────
+// WRITES AND READS
+// ─────────────────────────────────────────────
+
+// Phases 1–6 for one byte, as every layout runs them
+static BootStatus boot_value(const MMUKO_Fork* fk, uint8_t value, uint8_t rec[MMUKO_STATE_RECORD_SIZE]) {
+    MMUKO_Byte ring = mmuko_canonical_rings[value];
+    BootStatus status = BOOT_OK;
+
+    if (mmuko_ring_align(&ring) >= 0) status = BOOT_LOCK_DETECTED;
+    mmuko_ring_entangle(&ring);
+    ring.primary_superposition = (Direction)(fk->superposition[ring.base_index] & 0x0F);
+    ring.secondary_superposition = (Direction)(fk->superposition[ring.base_index] >> 4);
+    if (status == BOOT_OK && mmuko_ring_rotation_lock(&ring) >= 0) status = BOOT_ROTATION_LOCK;
+
+    mmuko_ring_record(&ring, rec);
+    return status;
+}
+
+bool mmuko_fork_write(MMUKO_Fork* fk, size_t b, uint8_t value) {
+    if (b >= fk->base->memory_size) return false;
+
+    MMUKO_ForkEntry* entry = (MMUKO_ForkEntry*)find_entry(fk, b);
+    if (!entry) {
+        // Keep the table at most 3/4 full
+        if ((fk->count + 1) * 4 > fk->capacity * 3 && !grow_entries(fk)) return false;
+        entry = &fk->entries[entry_slot(fk, b)];
+        entry->byte = b;
+        fk->count++;
+    }
+    entry->status = boot_value(fk, value, entry->record);
+    return true;
+}
+
+void mmuko_fork_record(const MMUKO_Fork* fk, size_t b, uint8_t rec[MMUKO_STATE_RECORD_SIZE]) {
+    const MMUKO_ForkEntry* entry = find_entry(fk, b);
+    if (entry) {
+        memcpy(rec, entry->record, MMUKO_STATE_RECORD_SIZE);
+    } else {
+        mmuko_state_record(fk->base, b, rec);
+    }
+}
+
+// ─────────────────────────────────────────────
+// RESULTS
+// ─────────────────────────────────────────────
+
+// The baseline passed every phase, so only written bytes can fault. A
+// full boot stops in the earliest failing phase (BootStatus values are in
+// phase order) at the lowest failing byte
+BootStatus mmuko_fork_status(const MMUKO_Fork* fk, size_t* fault_byte) {
+    BootStatus status = BOOT_OK;
+    *fault_byte = SIZE_MAX;
+
+    for (size_t i = 0; i < fk->capacity; i++) {
+        const MMUKO_ForkEntry* entry = &fk->entries[i];
+        if (entry->byte == MMUKO_NO_OVERRIDE || entry->status == BOOT_OK) continue;
+        if (status == BOOT_OK || entry->status < status ||
+            (entry->status == status && entry->byte < *fault_byte)) {
+            status = entry->status;
+            *fault_byte = entry->byte;
+        }
+    }
+    return status;
+}
+
+size_t mmuko_fork_changed(const MMUKO_Fork* fk) {
+    uint8_t rec[MMUKO_STATE_RECORD_SIZE];
+    size_t changed = 0;
+
+    for (size_t i = 0; i < fk->capacity; i++) {
+        const MMUKO_ForkEntry* entry = &fk->entries[i];
+        if (entry->byte == MMUKO_NO_OVERRIDE) continue;
+        mmuko_state_record(fk->base, entry->byte, rec);
+        changed += memcmp(rec, entry->record, MMUKO_STATE_RECORD_SIZE) != 0;
+    }
+    return changed;
+}
+
+size_t mmuko_fork_bytes(const MMUKO_Fork* fk) {
+    return fk->capacity * sizeof(MMUKO_ForkEntry);
+}
+
+// ─────────────────────────────────────────────
+// DIGEST TREE
+// ─────────────────────────────────────────────
+
+static uint64_t digest_node(uint64_t left, uint64_t right) {
+    uint64_t hash = MMUKO_DIGEST_INIT;
+    for (int i = 0; i < 8; i++) hash = (hash ^ ((left >> (8 * i)) & 0xFF)) * 0x100000001B3ull;
+    for (int i = 0; i < 8; i++) hash = (hash ^ ((right >> (8 * i)) & 0xFF)) * 0x100000001B3ull;
+    return hash;
+}
+
+static size_t block_end(size_t memory_size, size_t block) {
+    size_t end = (block + 1) * MMUKO_FORK_DIGEST_BLOCK;
+    return end < memory_size ? end : memory_size;
+}
+
+bool mmuko_digest_tree_build(MMUKO_DigestTree* tree, const MMUKO_System* sys) {
+    tree->blocks = (sys->memory_size + MMUKO_FORK_DIGEST_BLOCK - 1) / MMUKO_FORK_DIGEST_BLOCK;
+    tree->width = 1;
+    while (tree->width < tree->blocks) tree->width <<= 1;
+    tree->frame = sys->frame_of_reference;
+    tree->nodes = (uint64_t*)calloc(2 * tree->width, sizeof(uint64_t));
+    if (!tree->nodes) return false;
+
+    // Leaves past the last block stay 0
+    for (size_t block = 0; block < tree->blocks; block++) {
+        tree->nodes[tree->width + block] = mmuko_state_digest_range(
+            sys, block * MMUKO_FORK_DIGEST_BLOCK, block_end(sys->memory_size, block), MMUKO_DIGEST_INIT);
+    }
+    for (size_t node = tree->width - 1; node >= 1; node--) {
+        tree->nodes[node] = digest_node(tree->nodes[2 * node], tree->nodes[2 * node + 1]);
+    }
+    return true;
+}
+
+void mmuko_digest_tree_free(MMUKO_DigestTree* tree) {
+    free(tree->nodes);
+    tree->nodes = NULL;
+}
+
+uint64_t mmuko_digest_tree_root(const MMUKO_DigestTree* tree) {
+    return mmuko_state_digest_final(tree->nodes[1], tree->frame);
+}
+
+typedef struct {
+    size_t node;
+    uint64_t digest;
+} TreeNode;
+
+static int compare_nodes(const void* a, const void* b) {
+    size_t x = ((const TreeNode*)a)->node;
+    size_t y = ((const TreeNode*)b)->node;
+    return (x > y) - (x < y);
+}
+
+static uint64_t fork_leaf(const MMUKO_Fork* fk, size_t block) {
+    uint64_t hash = MMUKO_DIGEST_INIT;
+    uint8_t rec[MMUKO_STATE_RECORD_SIZE];
+
+    for (size_t b = block * MMUKO_FORK_DIGEST_BLOCK; b < block_end(fk->base->memory_size, block); b++) {
+        mmuko_fork_record(fk, b, rec);
+        for (int i = 0; i < MMUKO_STATE_RECORD_SIZE; i++) {
+            hash = (hash ^ rec[i]) * 0x100000001B3ull;
+        }
+    }
+    return hash;
+}
+
+bool mmuko_fork_digest(const MMUKO_Fork* fk, const MMUKO_DigestTree* tree, uint64_t* digest) {
+    if (fk->count == 0) {
+        *digest = mmuko_digest_tree_root(tree);
+        return true;
+    }
+
+    TreeNode* level = (TreeNode*)malloc(fk->count * sizeof(TreeNode));
+    if (!level) return false;
+
+    // The written blocks, once each, in order
+    size_t n = 0;
+    for (size_t i = 0; i < fk->capacity; i++) {
+        if (fk->entries[i].byte == MMUKO_NO_OVERRIDE) continue;
+        level[n++].node = tree->width + fk->entries[i].byte / MMUKO_FORK_DIGEST_BLOCK;
+    }
+    qsort(level, n, sizeof(TreeNode), compare_nodes);
+    size_t unique = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (unique == 0 || level[unique - 1].node != level[i].node) level[unique++] = level[i];
+    }
+    n = unique;
+    for (size_t i = 0; i < n; i++) {
+        level[i].digest = fork_leaf(fk, level[i].node - tree->width);
+    }
+
+    // One level at a time; a sibling the fork did not touch comes from the
+    // baseline tree. Parents are written behind the children being read
+    while (level[0].node > 1) {
+        size_t parents = 0;
+        for (size_t i = 0; i < n; i++) {
+            size_t node = level[i].node;
+            uint64_t left, right;
+            if (node & 1) {
+                left = tree->nodes[node ^ 1];
+                right = level[i].digest;
+            } else {
+                left = level[i].digest;
+                if (i + 1 < n && level[i + 1].node == (node | 1)) {
+                    right = level[++i].digest;
+                } else {
+                    right = tree->nodes[node | 1];
+                }
+            }
+            level[parents].node = node >> 1;
+            level[parents].digest = digest_node(left, right);
+            parents++;
+        }
+        n = parents;
+    }
+
+    *digest = mmuko_state_digest_final(level[0].digest, tree->frame);
+    free(level);
+    return true;
+}
+
+// ============================================================
+// END OF MMUKO-FORK.C
+// ============================================================
@@ -0,0 +1,515 @@
+// ============================================================
+// MMUKO-INDEX.C — Bitmap Indexes over Booted Cubit State
+// Project: OBINexus / OBIELF R&D
+// ============================================================
+//
+// One bitmap per value of each cubit attribute (direction, state,
+// superposed) and byte attribute (base index, primary and secondary
+// superposition), over cubit positions byte * 8 + cubit. A query is
+// a conjunction of attribute = value terms in a byte range, answered
+// by ANDing the terms' bitmaps and counting bits.
+//
+// Bitmaps are compressed like EWAH, but a fill run repeats any short
+// pattern of 64-bit words, not only an empty or full word. A word of a
+// cubit bitmap spans eight bytes, and after boot every byte shares the
+// same cubit directions and superposed flags, so those bitmaps stay a
+// run or two long whatever the memory size; data that repeats every few
+// hundred bytes, like the test pattern, fills with that period. Byte
+// attributes are the same for all eight cubits of a byte, so their
+// bitmaps keep one bit a byte and a query widens each bit to eight as
+// it ANDs them with cubit bitmaps. Words that fit no fill are kept as
+// literal runs at one word each, or as the offsets of their set bits
+// where those are sparse. A query walks the runs of its bitmaps together
+// and counts a one-word fill with one popcount.
+// ============================================================
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "mmuko-boot.h"
+
+static const int attribute_values[MMUKO_INDEX_ATTRIBUTES] = {9, 4, 2, 13, 9, 9};
+
+static const char* const attribute_names[MMUKO_INDEX_ATTRIBUTES] = {
+    "direction", "state", "superposed", "base", "primary", "secondary"
+};
+
+static const char* const direction_enum_names[9] = {
+    "N", "NE", "E", "SE", "S", "SW", "W", "NW", "UNDEFINED_DIR"
+};
+
+// ─────────────────────────────────────────────
+// BITMAPS
+// ─────────────────────────────────────────────
+
+#define FILL_MIN 4          // Repeats of a pattern before it is kept as a fill
+#define PERIOD_MAX 64       // Longest fill pattern, in words
+#define LITERAL_MAX 1024    // Longest literal run, so array offsets fit 16 bits
+
+// First word of run `r`
+static size_t run_start(const MMUKO_Bitmap* bm, size_t r) {
+    return r > 0 ? bm->runs[r - 1].end : 0;
+}
+
+static bool reserve_words(MMUKO_Bitmap* bm) {
+    if (bm->word_count < bm->word_capacity) return true;
+    size_t capacity = bm->word_capacity ? bm->word_capacity * 2 : 16;
+    uint64_t* words = (uint64_t*)realloc(bm->words, capacity * sizeof(uint64_t));
+    if (!words) return false;
+    bm->words = words;
+    bm->word_capacity = capacity;
+    return true;
+}
+
+static MMUKO_BitmapRun* push_run(MMUKO_Bitmap* bm) {
+    if (bm->run_count == bm->run_capacity) {
+        size_t capacity = bm->run_capacity ? bm->run_capacity * 2 : 16;
+        MMUKO_BitmapRun* runs = (MMUKO_BitmapRun*)realloc(bm->runs, capacity * sizeof(MMUKO_BitmapRun));
+        if (!runs) return NULL;
+        bm->runs = runs;
+        bm->run_capacity = capacity;
+    }
+    return &bm->runs[bm->run_count++];
+}
+
+// Shortest period of `words`, or 0 if none up to PERIOD_MAX repeats
+// FILL_MIN times
+static size_t words_period(const uint64_t* words, size_t length) {
+    for (size_t period = 1; period <= PERIOD_MAX && period * FILL_MIN <= length; period++) {
+        if (memcmp(words, words + period, (length - period) * sizeof(uint64_t)) == 0) return period;
+    }
+    return 0;
+}
+
+// Turn the last run, a literal one, into a fill if its words repeat a
+// short pattern, else into an array run if the offsets of its set bits
+// take less memory than its words. Its words are the last in `words`. A
+// literal run is as good an answer, so an array that cannot be allocated
+// leaves the run as it is
+static void bitmap_seal(MMUKO_Bitmap* bm) {
+    MMUKO_BitmapRun* last = &bm->runs[bm->run_count - 1];
+    size_t length = last->end - run_start(bm, bm->run_count - 1);
+    const uint64_t* words = &bm->words[last->word];
+
+    size_t period = words_period(words, length);
+    if (period > 0) {
+        bm->word_count -= length - period;
+        last->length = (uint32_t)period;
+        last->kind = MMUKO_RUN_FILL;
+        return;
+    }
+
+    size_t bits = 0;
+    for (size_t i = 0; i < length; i++) bits += (size_t)__builtin_popcountll(words[i]);
+    if (bits * sizeof(uint16_t) >= length * sizeof(uint64_t)) return;
+
+    if (bm->offset_count + bits > bm->offset_capacity) {
+        size_t capacity = bm->offset_capacity ? bm->offset_capacity * 2 : 64;
+        while (capacity < bm->offset_count + bits) capacity *= 2;
+        uint16_t* offsets = (uint16_t*)realloc(bm->offsets, capacity * sizeof(uint16_t));
+        if (!offsets) return;
+        bm->offsets = offsets;
+        bm->offset_capacity = capacity;
+    }
+
+    size_t first = bm->offset_count;
+    for (size_t i = 0; i < length; i++) {
+        for (uint64_t word = words[i]; word; word &= word - 1) {
+            bm->offsets[bm->offset_count++] = (uint16_t)(i * 64 + (size_t)__builtin_ctzll(word));
+        }
+    }
+    bm->word_count -= length;
+    last->word = first;
+    last->length = (uint32_t)bits;
+    last->kind = MMUKO_RUN_ARRAY;
+}
+
+// Append word `w` of the uncompressed bitmap. A word that continues the
+// pattern of the fill before it extends the fill. Once the last FILL_MIN - 1
+// literal words and this one are equal, they leave their literal run for a
+// new fill; shorter fills would cost more in runs than they save in words.
+// Longer patterns are found when a literal run is sealed
+static bool bitmap_push(MMUKO_Bitmap* bm, size_t w, uint64_t word) {
+    MMUKO_BitmapRun* last = bm->run_count ? &bm->runs[bm->run_count - 1] : NULL;
+
+    if (last && last->kind == MMUKO_RUN_FILL &&
+        bm->words[last->word + (w - run_start(bm, bm->run_count - 1)) % last->length] == word) {
+        last->end = w + 1;
+        return true;
+    }
+
+    bool literal = last && last->kind == MMUKO_RUN_LITERAL;
+    size_t length = literal ? last->end - run_start(bm, bm->run_count - 1) : 0;
+    if (length >= FILL_MIN - 1) {
+        const uint64_t* tail = &bm->words[bm->word_count - (FILL_MIN - 1)];
+        bool repeats = true;
+        for (int i = 0; i < FILL_MIN - 1; i++) repeats = repeats && tail[i] == word;
+        if (repeats) {
+            bm->word_count -= FILL_MIN - 1;
+            last->end -= FILL_MIN - 1;
+            if (length > FILL_MIN - 1) {
+                bitmap_seal(bm);
+            } else {
+                bm->run_count--;
+            }
+            if (!reserve_words(bm) || !(last = push_run(bm))) return false;
+            last->word = bm->word_count;
+            last->kind = MMUKO_RUN_FILL;
+            last->length = 1;
+            last->end = w + 1;
+            bm->words[bm->word_count++] = word;
+            return true;
+        }
+    }
+
+    if (literal && length == LITERAL_MAX) {
+        // A run sealed into a fill may go on with this word
+        bitmap_seal(bm);
+        if (bm->runs[bm->run_count - 1].kind == MMUKO_RUN_FILL) return bitmap_push(bm, w, word);
+        literal = false;
+    }
+    if (!reserve_words(bm)) return false;
+    if (!literal) {
+        if (!(last = push_run(bm))) return false;
+        last->word = bm->word_count;
+        last->kind = MMUKO_RUN_LITERAL;
+    }
+    bm->words[bm->word_count++] = word;
+    last->end = w + 1;
+    return true;
+}
+
+// Seal the last literal run and give back the slack of the doubling
+// growth once a bitmap is complete
+static void bitmap_trim(MMUKO_Bitmap* bm) {
+    if (bm->run_count > 0 && bm->runs[bm->run_count - 1].kind == MMUKO_RUN_LITERAL) bitmap_seal(bm);
+
+    if (bm->run_count > 0 && bm->run_count < bm->run_capacity) {
+        MMUKO_BitmapRun* runs = (MMUKO_BitmapRun*)realloc(bm->runs, bm->run_count * sizeof(MMUKO_BitmapRun));
+        if (runs) {
+            bm->runs = runs;
+            bm->run_capacity = bm->run_count;
+        }
+    }
+    if (bm->word_count > 0 && bm->word_count < bm->word_capacity) {
+        uint64_t* words = (uint64_t*)realloc(bm->words, bm->word_count * sizeof(uint64_t));
+        if (words) {
+            bm->words = words;
+            bm->word_capacity = bm->word_count;
+        }
+    }
+    if (bm->offset_count > 0 && bm->offset_count < bm->offset_capacity) {
+        uint16_t* offsets = (uint16_t*)realloc(bm->offsets, bm->offset_count * sizeof(uint16_t));
+        if (offsets) {
+            bm->offsets = offsets;
+            bm->offset_capacity = bm->offset_count;
+        }
+    }
+}
+
+// First run that ends after word `w`
+static size_t bitmap_seek(const MMUKO_Bitmap* bm, size_t w) {
+    size_t lo = 0, hi = bm->run_count;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (bm->runs[mid].end > w) {
+            hi = mid;
+        } else {
+            lo = mid + 1;
+        }
+    }
+    return lo;
+}
+
+// Word `w` of run `r`, and in *next the first word after `w` that may differ
+static uint64_t bitmap_word(const MMUKO_Bitmap* bm, size_t r, size_t w, size_t* next) {
+    const MMUKO_BitmapRun* run = &bm->runs[r];
+    size_t start = run_start(bm, r);
+    if (run->kind == MMUKO_RUN_FILL) {
+        *next = run->length == 1 ? run->end : w + 1;
+        return bm->words[run->word + (w - start) % run->length];
+    }
+    if (run->kind == MMUKO_RUN_LITERAL) {
+        *next = w + 1;
+        return bm->words[run->word + (w - start)];
+    }
+
+    // First offset in word `w` or after it; the words before it are empty
+    const uint16_t* offsets = &bm->offsets[run->word];
+    size_t lo = 0, hi = run->length;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (offsets[mid] / 64 < w - start) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    if (lo == run->length || start + offsets[lo] / 64 > w) {
+        *next = lo == run->length ? run->end : start + offsets[lo] / 64;
+        return 0;
+    }
+
+    uint64_t word = 0;
+    for (; lo < run->length && start + offsets[lo] / 64 == w; lo++) word |= 1ull << (offsets[lo] % 64);
+    *next = w + 1;
+    return word;
+}
+
+// ─────────────────────────────────────────────
+// BUILD
+// ─────────────────────────────────────────────
+
+// Byte attributes are indexed one bit a byte, cubit attributes one bit a cubit
+static bool byte_attribute(int attribute) {
+    return attribute >= MMUKO_INDEX_BASE;
+}
+
+// Cubit masks of one byte's record for every cubit attribute value, and
+// the byte's bit for every byte attribute value
+static void record_masks(const uint8_t rec[MMUKO_STATE_RECORD_SIZE],
+                         uint8_t masks[MMUKO_INDEX_ATTRIBUTES][MMUKO_INDEX_VALUES]) {
+    uint8_t undefined = rec[7];
+    for (int d = 0; d < 8; d++) {
+        masks[MMUKO_INDEX_DIRECTION][d] = (uint8_t)((d & 1 ? rec[4] : ~rec[4]) &
+                                                    (d & 2 ? rec[5] : ~rec[5]) &
+                                                    (d & 4 ? rec[6] : ~rec[6]) & ~undefined);
+    }
+    masks[MMUKO_INDEX_DIRECTION][UNDEFINED_DIR] = undefined;
+
+    for (int s = 0; s < 4; s++) {
+        masks[MMUKO_INDEX_STATE][s] = (uint8_t)((s & 1 ? rec[1] : ~rec[1]) &
+                                                (s & 2 ? rec[2] : ~rec[2]));
+    }
+    masks[MMUKO_INDEX_SUPERPOSED][0] = (uint8_t)~rec[3];
+    masks[MMUKO_INDEX_SUPERPOSED][1] = rec[3];
+
+    for (int v = 0; v < MMUKO_INDEX_VALUES; v++) {
+        masks[MMUKO_INDEX_BASE][v] = rec[8] == v;
+        masks[MMUKO_INDEX_PRIMARY][v] = (rec[9] & 0x0F) == v;
+        masks[MMUKO_INDEX_SECONDARY][v] = (rec[9] >> 4) == v;
+    }
+}
+
+// Push the words of one granularity's attributes and clear them
+static bool push_words(MMUKO_Index* index, bool bytes, size_t w,
+                       uint64_t words[MMUKO_INDEX_ATTRIBUTES][MMUKO_INDEX_VALUES]) {
+    for (int a = 0; a < MMUKO_INDEX_ATTRIBUTES; a++) {
+        if (byte_attribute(a) != bytes) continue;
+        for (int v = 0; v < attribute_values[a]; v++) {
+            if (!bitmap_push(&index->bitmaps[a][v], w, words[a][v])) return false;
+            words[a][v] = 0;
+        }
+    }
+    return true;
+}
+
+bool mmuko_index_build(MMUKO_Index* index, const MMUKO_System* sys) {
+    memset(index, 0, sizeof(*index));
+    if (!sys->boot_complete) return false;
+
+    index->memory_size = sys->memory_size;
+    index->cubit_words = (sys->memory_size + 7) / 8;
+    index->byte_words = (sys->memory_size + 63) / 64;
+
+    uint8_t rec[MMUKO_STATE_RECORD_SIZE];
+    uint8_t masks[MMUKO_INDEX_ATTRIBUTES][MMUKO_INDEX_VALUES];
+    uint64_t words[MMUKO_INDEX_ATTRIBUTES][MMUKO_INDEX_VALUES];
+    memset(words, 0, sizeof(words));
+
+    for (size_t b = 0; b < sys->memory_size; b++) {
+        mmuko_state_record(sys, b, rec);
+        record_masks(rec, masks);
+        for (int a = 0; a < MMUKO_INDEX_ATTRIBUTES; a++) {
+            int shift = byte_attribute(a) ? (int)(b % 64) : (int)(b % 8) * 8;
+            for (int v = 0; v < attribute_values[a]; v++) words[a][v] |= (uint64_t)masks[a][v] << shift;
+        }
+
+        bool last = b + 1 == sys->memory_size;
+        if (((b % 8 == 7 || last) && !push_words(index, false, b / 8, words)) ||
+            ((b % 64 == 63 || last) && !push_words(index, true, b / 64, words))) {
+            mmuko_index_free(index);
+            return false;
+        }
+    }
+
+    for (int a = 0; a < MMUKO_INDEX_ATTRIBUTES; a++) {
+        for (int v = 0; v < attribute_values[a]; v++) bitmap_trim(&index->bitmaps[a][v]);
+    }
+    return true;
+}
+
+void mmuko_index_free(MMUKO_Index* index) {
+    for (int a = 0; a < MMUKO_INDEX_ATTRIBUTES; a++) {
+        for (int v = 0; v < MMUKO_INDEX_VALUES; v++) {
+            free(index->bitmaps[a][v].runs);
+            free(index->bitmaps[a][v].words);
+            free(index->bitmaps[a][v].offsets);
+        }
+    }
+    memset(index, 0, sizeof(*index));
+}
+
+// ─────────────────────────────────────────────
+// QUERIES
+// ─────────────────────────────────────────────
+
+int mmuko_index_values(MMUKO_IndexAttribute attribute) {
+    if (attribute < 0 || attribute >= MMUKO_INDEX_ATTRIBUTES) return 0;
+    return attribute_values[attribute];
+}
+
+const MMUKO_Bitmap* mmuko_index_bitmap(const MMUKO_Index* index, MMUKO_IndexAttribute attribute,
+                                       int value) {
+    if (value < 0 || value >= mmuko_index_values(attribute)) return NULL;
+    return &index->bitmaps[attribute][value];
+}
+
+// Bits of word `w` inside the bit range [first, last)
+static uint64_t range_mask(size_t w, size_t first, size_t last) {
+    uint64_t mask = ~0ull;
+    if (w * 64 < first) mask &= ~0ull << (first - w * 64);
+    if (w * 64 + 64 > last) mask &= ~0ull >> (w * 64 + 64 - last);
+    return mask;
+}
+
+// Eight byte bits, one per byte, widened to the bytes' 64 cubit bits
+static uint64_t widen_bytes(uint64_t bits) {
+    bits = (bits | bits << 28) & 0x0000000F0000000Full;
+    bits = (bits | bits << 14) & 0x0003000300030003ull;
+    bits = (bits | bits << 7) & 0x0101010101010101ull;
+    return bits * 0xFF;
+}
+
+size_t mmuko_index_count(const MMUKO_Index* index, const MMUKO_IndexTerm* terms, int term_count,
+                         size_t begin, size_t end) {
+    // At most one bitmap per attribute: two values of one attribute never
+    // match together, and a repeated term changes nothing
+    const MMUKO_Bitmap* maps[MMUKO_INDEX_ATTRIBUTES];
+    bool bytes[MMUKO_INDEX_ATTRIBUTES];
+    int wanted[MMUKO_INDEX_ATTRIBUTES];
+    int map_count = 0;
+
+    for (int a = 0; a < MMUKO_INDEX_ATTRIBUTES; a++) wanted[a] = -1;
+    for (int t = 0; t < term_count; t++) {
+        MMUKO_IndexAttribute attribute = terms[t].attribute;
+        if (!mmuko_index_bitmap(index, attribute, terms[t].value)) return 0;
+        if (wanted[attribute] >= 0 && wanted[attribute] != terms[t].value) return 0;
+        if (wanted[attribute] < 0) {
+            bytes[map_count] = byte_attribute(attribute);
+            maps[map_count++] = &index->bitmaps[attribute][terms[t].value];
+        }
+        wanted[attribute] = terms[t].value;
+    }
+
+    if (end > index->memory_size) end = index->memory_size;
+    if (begin >= end) return 0;
+
+    // w walks cubit words; a byte bitmap's word w / 8 covers cubit words
+    // w / 8 * 8 onwards, eight bits of it to each
+    size_t first = begin * 8, last = end * 8;
+    size_t w = first / 64, w_end = (last + 63) / 64;
+    size_t runs[MMUKO_INDEX_ATTRIBUTES];
+    for (int m = 0; m < map_count; m++) runs[m] = bitmap_seek(maps[m], bytes[m] ? w / 8 : w);
+
+    size_t count = 0;
+    while (w < w_end) {
+        // AND every bitmap's word at w, which holds up to the nearest change
+        uint64_t word = ~0ull;
+        size_t next = w_end;
+        for (int m = 0; m < map_count; m++) {
+            size_t until;
+            if (bytes[m]) {
+                // Widened words repeat while the byte word does, if its
+                // eight bytes are equal
+                uint64_t bits = bitmap_word(maps[m], runs[m], w / 8, &until);
+                word &= widen_bytes((bits >> (w % 8 * 8)) & 0xFF);
+                until = bits == (bits & 0xFF) * 0x0101010101010101ull ? until * 8 : w + 1;
+            } else {
+                word &= bitmap_word(maps[m], runs[m], w, &until);
+            }
+            if (until < next) next = until;
+        }
+
+        // Only the range's first and last words can be partial
+        count += (size_t)__builtin_popcountll(word & range_mask(w, first, last));
+        if (next - w >= 2) {
+            count += (size_t)__builtin_popcountll(word & range_mask(next - 1, first, last));
+        }
+        if (next - w >= 3) count += (size_t)__builtin_popcountll(word) * (next - w - 2);
+
+        w = next;
+        for (int m = 0; m < map_count; m++) {
+            size_t position = bytes[m] ? w / 8 : w;
+            while (runs[m] < maps[m]->run_count && maps[m]->runs[runs[m]].end <= position) runs[m]++;
+        }
+    }
+    return count;
+}
+
+size_t mmuko_index_bytes(const MMUKO_Index* index) {
+    size_t bytes = 0;
+    for (int a = 0; a < MMUKO_INDEX_ATTRIBUTES; a++) {
+        for (int v = 0; v < MMUKO_INDEX_VALUES; v++) {
+            const MMUKO_Bitmap* bm = &index->bitmaps[a][v];
+            bytes += bm->run_capacity * sizeof(MMUKO_BitmapRun) + bm->word_capacity * sizeof(uint64_t) +
+                     bm->offset_capacity * sizeof(uint16_t);
+        }
+    }
+    return bytes;
+}
+
+size_t mmuko_index_runs(const MMUKO_Index* index) {
+    size_t runs = 0;
+    for (int a = 0; a < MMUKO_INDEX_ATTRIBUTES; a++) {
+        for (int v = 0; v < MMUKO_INDEX_VALUES; v++) {
+            runs += index->bitmaps[a][v].run_count;
+        }
+    }
+    return runs;
+}
+
+// ─────────────────────────────────────────────
+// QUERY TERMS
+// ─────────────────────────────────────────────
+
+static int parse_value(MMUKO_IndexAttribute attribute, const char* text) {
+    char* end;
+    long number = strtol(text, &end, 10);
+    if (end != text && *end == '\0') return (int)number;
+
+    if (attribute == MMUKO_INDEX_STATE) {
+        for (int s = 0; s < 4; s++) {
+            if (strcmp(text, state_to_string((State)s)) == 0) return s;
+        }
+    } else if (attribute == MMUKO_INDEX_DIRECTION || attribute == MMUKO_INDEX_PRIMARY ||
+               attribute == MMUKO_INDEX_SECONDARY) {
+        for (int d = 0; d < 9; d++) {
+            if (strcmp(text, direction_to_string((Direction)d)) == 0 ||
+                strcmp(text, direction_enum_names[d]) == 0) {
+                return d;
+            }
+        }
+    }
+    return -1;
+}
+
+bool mmuko_index_parse_term(const char* text, MMUKO_IndexTerm* term) {
+    const char* equals = strchr(text, '=');
+    if (!equals) return false;
+
+    size_t length = (size_t)(equals - text);
+    for (int a = 0; a < MMUKO_INDEX_ATTRIBUTES; a++) {
+        if (strlen(attribute_names[a]) == length && strncmp(text, attribute_names[a], length) == 0) {
+            term->attribute = (MMUKO_IndexAttribute)a;
+            term->value = parse_value(term->attribute, equals + 1);
+            return term->value >= 0 && term->value < attribute_values[a];
+        }
+    }
+    return false;
+}
+
+// ============================================================
+// END OF MMUKO-INDEX.C
+// ============================================================
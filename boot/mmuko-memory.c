@@ -0,0 +1,175 @@
+// ============================================================
+// MMUKO-MEMORY.C — Huge-Page and NUMA-Local Ring Memory Maps
+// Project: OBINexus / OBIELF R&D
+// ============================================================
+//
+// A ring-layout map takes sizeof(MMUKO_Byte) bytes per modelled
+// byte, so a multi-gigabyte map spans hundreds of thousands of
+// base pages and the phase loops miss the TLB on most rings.
+// MMUKO_PLACE_HUGE maps it on reserved huge pages when the system
+// has them, and otherwise on a 2 MiB-aligned mapping advised for
+// transparent huge pages. MMUKO_PLACE_LOCAL hands the system a
+// local pool and has each pinned thread write the test pattern
+// into the chunks it will boot. The mapping is untouched until
+// then, so first touch puts every chunk's pages on the NUMA node
+// of the thread that works on it.
+// ============================================================
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <sys/mman.h>
+
+#include "mmuko-boot.h"
+
+#define HUGE_PAGE_BYTES ((size_t)2 * 1024 * 1024)
+
+// ─────────────────────────────────────────────
+// MAPPING
+// ─────────────────────────────────────────────
+
+static size_t round_up(size_t value, size_t unit) {
+    return (value + unit - 1) / unit * unit;
+}
+
+static void* map_anonymous(size_t bytes, int extra_flags) {
+    void* data = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | extra_flags,
+                      -1, 0);
+    return data == MAP_FAILED ? NULL : data;
+}
+
+// Zero-filled and not yet touched. Sets the backing and mapped length
+static void* map_rings(size_t bytes, bool huge, MMUKO_Pages* pages, size_t* mapped) {
+    if (!huge) {
+        *pages = MMUKO_PAGES_BASE;
+        *mapped = bytes;
+        return map_anonymous(bytes, 0);
+    }
+
+    size_t length = round_up(bytes, HUGE_PAGE_BYTES);
+    *mapped = length;
+#ifdef MAP_HUGETLB
+    void* reserved = map_anonymous(length, MAP_HUGETLB);
+    if (reserved) {
+        *pages = MMUKO_PAGES_HUGETLB;
+        return reserved;
+    }
+#endif
+
+    // No reserved pages: map one huge page extra and trim it, so the map
+    // starts on a huge-page boundary and every 2 MiB of it can be promoted
+    uint8_t* raw = (uint8_t*)map_anonymous(length + HUGE_PAGE_BYTES, 0);
+    if (!raw) return NULL;
+    uint8_t* data = (uint8_t*)round_up((uintptr_t)raw, HUGE_PAGE_BYTES);
+    size_t head = (size_t)(data - raw);
+    if (head > 0) munmap(raw, head);
+    munmap(data + length, HUGE_PAGE_BYTES - head);
+
+    *pages = MMUKO_PAGES_BASE;
+#ifdef MADV_HUGEPAGE
+    if (madvise(data, length, MADV_HUGEPAGE) == 0) *pages = MMUKO_PAGES_THP;
+#endif
+    return data;
+}
+
+void mmuko_rings_free(MMUKO_System* sys) {
+    if (!sys->memory_map) return;
+    if (sys->pages == MMUKO_PAGES_HEAP) {
+        free(sys->memory_map);
+    } else {
+        munmap(sys->memory_map, sys->mapped_bytes);
+    }
+    sys->memory_map = NULL;
+}
+
+// ─────────────────────────────────────────────
+// PLACED SYSTEMS
+// ─────────────────────────────────────────────
+
+static void touch_chunk(MMUKO_System* sys, size_t begin, size_t end, void* ctx) {
+    (void)ctx;
+    for (size_t b = begin; b < end; b++) {
+        sys->memory_map[b].raw_value = MMUKO_TEST_PATTERN(b);
+    }
+}
+
+MMUKO_System* mmuko_system_create_placed(size_t memory_size, int threads, unsigned placement) {
+    MMUKO_System* sys = (MMUKO_System*)calloc(1, sizeof(MMUKO_System));
+    if (!sys) return NULL;
+
+    sys->layout = MMUKO_LAYOUT_RINGS;
+    sys->memory_map = (MMUKO_Byte*)map_rings(memory_size * sizeof(MMUKO_Byte),
+                                             (placement & MMUKO_PLACE_HUGE) != 0,
+                                             &sys->pages, &sys->mapped_bytes);
+    if (!sys->memory_map) {
+        free(sys);
+        return NULL;
+    }
+
+    sys->memory_size = memory_size;
+    sys->memory_capacity = memory_size;
+    sys->frame_of_reference = N;
+    sys->boot_complete = false;
+
+    if (placement & MMUKO_PLACE_LOCAL) {
+        sys->pool = mmuko_pool_create_local(threads);
+    } else if (threads != 1) {
+        sys->pool = mmuko_pool_create(threads);
+    }
+    if (!sys->pool && ((placement & MMUKO_PLACE_LOCAL) || threads != 1)) {
+        mmuko_system_destroy(sys);
+        return NULL;
+    }
+
+    // First touch, in the chunks the parallel phases will use
+    if (sys->pool) {
+        mmuko_pool_run(sys->pool, sys, memory_size, mmuko_ring_chunk(), touch_chunk, NULL);
+    } else {
+        touch_chunk(sys, 0, memory_size, NULL);
+    }
+    return sys;
+}
+
+// ─────────────────────────────────────────────
+// REPORTING
+// ─────────────────────────────────────────────
+
+// Sum AnonHugePages over the smaps entries overlapping the map
+size_t mmuko_huge_bytes(const MMUKO_System* sys) {
+    if (!sys->memory_map) return 0;
+    if (sys->pages == MMUKO_PAGES_HUGETLB) return sys->mapped_bytes;
+
+    FILE* smaps = fopen("/proc/self/smaps", "r");
+    if (!smaps) return 0;
+
+    uintptr_t first = (uintptr_t)sys->memory_map;
+    uintptr_t last = first + sys->memory_size * sizeof(MMUKO_Byte);
+    bool inside = false;
+    size_t total = 0;
+    char line[256];
+    while (fgets(line, sizeof(line), smaps)) {
+        unsigned long start, end, kib;
+        if (sscanf(line, "%lx-%lx ", &start, &end) == 2) {
+            inside = start < last && end > first;
+        } else if (inside && sscanf(line, "AnonHugePages: %lu kB", &kib) == 1) {
+            total += (size_t)kib * 1024;
+        }
+    }
+    fclose(smaps);
+    return total;
+}
+
+const char* mmuko_pages_name(MMUKO_Pages pages) {
+    switch (pages) {
+        case MMUKO_PAGES_HEAP: return "heap";
+        case MMUKO_PAGES_HUGETLB: return "hugetlb";
+        case MMUKO_PAGES_THP: return "thp";
+        case MMUKO_PAGES_BASE: return "base pages";
+        default: return "unknown";
+    }
+}
+
+// ============================================================
+// END OF MMUKO-MEMORY.C
+// ============================================================
@@ -0,0 +1,470 @@
+// ============================================================
+// MMUKO-PARALLEL.C — Multi-Threaded Phases for the Ring Layout
+// Project: OBINexus / OBIELF R&D
+// ============================================================
+//
+// Phases 1–6 of mmuko-boot.c with the memory map split into
+// cache-sized chunks that a pthread pool works through. Each phase
+// is a barrier: mmuko_pool_run() returns only once every chunk is
+// done. Failing phases report the lowest failing byte, and phase 3
+// logs its per-byte lines in memory order, so the output matches
+// the single-threaded reference. After a fault, bytes past the
+// failing one may already have been processed by other chunks.
+//
+// A local pool (mmuko_pool_create_local) pins each thread to a CPU
+// and gives it the same contiguous run of chunks in every job, so
+// the pages a thread touched first stay the pages it works on.
+// ============================================================
+
+#define _GNU_SOURCE     // pthread_setaffinity_np, CPU_SET
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+
+#include "mmuko-boot.h"
+
+// ─────────────────────────────────────────────
+// THREAD POOL
+// ─────────────────────────────────────────────
+
+struct MMUKO_Pool {
+    pthread_t* workers;
+    int thread_count;               // Workers plus the calling thread
+    atomic_int next_id;             // Thread ids: the caller is 0
+
+    // Local pools: thread id t runs on cpus[t] and owns a fixed chunk range
+    bool local;
+    int* cpus;
+#ifdef __linux__
+    cpu_set_t caller_mask;          // Restored when the pool is destroyed
+#endif
+
+    pthread_mutex_t lock;
+    pthread_cond_t start;
+    pthread_cond_t finished;
+    unsigned long generation;       // Bumped for every job
+    int busy;                       // Workers still on the current job
+    bool stopping;
+
+    // Current job
+    MMUKO_System* sys;
+    MMUKO_ChunkFn fn;
+    void* ctx;
+    size_t count;
+    size_t chunk;
+    atomic_size_t next;
+};
+
+// Claim chunks until none are left. Threads of a local pool take their
+// own contiguous share instead, the same one in every job
+static void pool_work(MMUKO_Pool* pool, int id) {
+    if (pool->local) {
+        size_t chunks = (pool->count + pool->chunk - 1) / pool->chunk;
+        size_t first = chunks * (size_t)id / (size_t)pool->thread_count;
+        size_t last = chunks * (size_t)(id + 1) / (size_t)pool->thread_count;
+        for (size_t k = first; k < last; k++) {
+            size_t begin = k * pool->chunk;
+            size_t end = begin + pool->chunk < pool->count ? begin + pool->chunk : pool->count;
+            pool->fn(pool->sys, begin, end, pool->ctx);
+        }
+        return;
+    }
+
+    for (;;) {
+        size_t begin = atomic_fetch_add(&pool->next, pool->chunk);
+        if (begin >= pool->count) return;
+        size_t end = begin + pool->chunk < pool->count ? begin + pool->chunk : pool->count;
+        pool->fn(pool->sys, begin, end, pool->ctx);
+    }
+}
+
+// Pin the calling thread to the CPU for thread `id`; best effort
+static void pin_thread(MMUKO_Pool* pool, int id) {
+#ifdef __linux__
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    CPU_SET(pool->cpus[id], &mask);
+    pthread_setaffinity_np(pthread_self(), sizeof(mask), &mask);
+#else
+    (void)pool;
+    (void)id;
+#endif
+}
+
+static void* pool_worker(void* arg) {
+    MMUKO_Pool* pool = (MMUKO_Pool*)arg;
+    unsigned long seen = 0;
+    int id = atomic_fetch_add(&pool->next_id, 1);
+    if (pool->local) pin_thread(pool, id);
+
+    pthread_mutex_lock(&pool->lock);
+    for (;;) {
+        while (!pool->stopping && pool->generation == seen) {
+            pthread_cond_wait(&pool->start, &pool->lock);
+        }
+        if (pool->stopping) break;
+        seen = pool->generation;
+        pthread_mutex_unlock(&pool->lock);
+
+        pool_work(pool, id);
+
+        pthread_mutex_lock(&pool->lock);
+        if (--pool->busy == 0) pthread_cond_signal(&pool->finished);
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return NULL;
+}
+
+// CPUs this process may run on, in order, repeated to fill `threads`
+// entries. Without affinity support every thread maps to CPU 0
+static int* pool_cpus(int threads) {
+    int* cpus = (int*)calloc((size_t)threads, sizeof(int));
+    if (!cpus) return NULL;
+#ifdef __linux__
+    cpu_set_t mask;
+    int allowed[CPU_SETSIZE];
+    int count = 0;
+    if (sched_getaffinity(0, sizeof(mask), &mask) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+            if (CPU_ISSET(cpu, &mask)) allowed[count++] = cpu;
+        }
+    }
+    for (int t = 0; count > 0 && t < threads; t++) {
+        cpus[t] = allowed[t % count];
+    }
+#endif
+    return cpus;
+}
+
+static MMUKO_Pool* pool_create(int threads, bool local) {
+    if (threads <= 0) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = online > 0 ? (int)online : 1;
+    }
+
+    MMUKO_Pool* pool = (MMUKO_Pool*)calloc(1, sizeof(MMUKO_Pool));
+    if (!pool) return NULL;
+    pool->workers = (pthread_t*)calloc((size_t)threads, sizeof(pthread_t));
+    pool->cpus = local ? pool_cpus(threads) : NULL;
+    if (!pool->workers || (local && !pool->cpus)) {
+        free(pool->workers);
+        free(pool);
+        return NULL;
+    }
+
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->start, NULL);
+    pthread_cond_init(&pool->finished, NULL);
+    atomic_init(&pool->next, 0);
+    atomic_init(&pool->next_id, 1);
+
+    pool->local = local;
+    if (local) {
+#ifdef __linux__
+        pthread_getaffinity_np(pthread_self(), sizeof(pool->caller_mask), &pool->caller_mask);
+#endif
+        pin_thread(pool, 0);
+    }
+
+    // The calling thread is one of the workers
+    pool->thread_count = 1;
+    for (int t = 0; t < threads - 1; t++) {
+        if (pthread_create(&pool->workers[t], NULL, pool_worker, pool) != 0) break;
+        pool->thread_count++;
+    }
+    return pool;
+}
+
+MMUKO_Pool* mmuko_pool_create(int threads) {
+    return pool_create(threads, false);
+}
+
+MMUKO_Pool* mmuko_pool_create_local(int threads) {
+    return pool_create(threads, true);
+}
+
+void mmuko_pool_destroy(MMUKO_Pool* pool) {
+    if (!pool) return;
+
+    pthread_mutex_lock(&pool->lock);
+    pool->stopping = true;
+    pthread_cond_broadcast(&pool->start);
+    pthread_mutex_unlock(&pool->lock);
+
+    for (int t = 0; t < pool->thread_count - 1; t++) {
+        pthread_join(pool->workers[t], NULL);
+    }
+    pthread_cond_destroy(&pool->finished);
+    pthread_cond_destroy(&pool->start);
+    pthread_mutex_destroy(&pool->lock);
+#ifdef __linux__
+    if (pool->local) {
+        pthread_setaffinity_np(pthread_self(), sizeof(pool->caller_mask), &pool->caller_mask);
+    }
+#endif
+    free(pool->cpus);
+    free(pool->workers);
+    free(pool);
+}
+
+int mmuko_pool_threads(const MMUKO_Pool* pool) {
+    return pool->thread_count;
+}
+
+void mmuko_pool_run(MMUKO_Pool* pool, MMUKO_System* sys, size_t count, size_t chunk,
+                    MMUKO_ChunkFn fn, void* ctx) {
+    if (count == 0) return;
+    if (chunk == 0) chunk = 1;
+
+    pthread_mutex_lock(&pool->lock);
+    pool->sys = sys;
+    pool->fn = fn;
+    pool->ctx = ctx;
+    pool->count = count;
+    pool->chunk = chunk;
+    atomic_store(&pool->next, 0);
+    pool->busy = pool->thread_count - 1;
+    pool->generation++;
+    pthread_cond_broadcast(&pool->start);
+    pthread_mutex_unlock(&pool->lock);
+
+    pool_work(pool, 0);
+
+    // Barrier: every worker has finished its last chunk
+    pthread_mutex_lock(&pool->lock);
+    while (pool->busy > 0) {
+        pthread_cond_wait(&pool->finished, &pool->lock);
+    }
+    pthread_mutex_unlock(&pool->lock);
+}
+
+// ─────────────────────────────────────────────
+// CHUNKING AND FAULTS
+// ─────────────────────────────────────────────
+
+size_t mmuko_ring_chunk(void) {
+    size_t rings = MMUKO_PARALLEL_CHUNK_BYTES / sizeof(MMUKO_Byte);
+    return rings ? rings : 1;
+}
+
+// Lowest failing byte seen by any chunk. Chunks that start past it are
+// skipped, since they cannot lower it
+typedef struct {
+    atomic_size_t byte;             // SIZE_MAX until a fault
+    int cubit;
+    pthread_mutex_t lock;
+} ChunkFault;
+
+static void fault_init(ChunkFault* fault) {
+    atomic_init(&fault->byte, SIZE_MAX);
+    fault->cubit = -1;
+    pthread_mutex_init(&fault->lock, NULL);
+}
+
+static void fault_record(ChunkFault* fault, size_t b, int cubit) {
+    pthread_mutex_lock(&fault->lock);
+    if (b < atomic_load(&fault->byte)) {
+        atomic_store(&fault->byte, b);
+        fault->cubit = cubit;
+    }
+    pthread_mutex_unlock(&fault->lock);
+}
+
+static bool fault_found(ChunkFault* fault, size_t* byte, int* cubit) {
+    pthread_mutex_destroy(&fault->lock);
+    *byte = atomic_load(&fault->byte);
+    *cubit = fault->cubit;
+    return *byte != SIZE_MAX;
+}
+
+// ─────────────────────────────────────────────
+// PHASES
+// ─────────────────────────────────────────────
+
+static void init_chunk(MMUKO_System* sys, size_t begin, size_t end, void* ctx) {
+    (void)ctx;
+    for (size_t b = begin; b < end; b++) {
+        sys->memory_map[b] = mmuko_canonical_rings[sys->memory_map[b].raw_value];
+    }
+}
+
+static BootStatus parallel_phase1_cubit_init(MMUKO_System* sys) {
+    MMUKO_LOG(sys, "[PHASE 1] Initializing cubit rings...\n");
+    mmuko_pool_run(sys->pool, sys, sys->memory_size, mmuko_ring_chunk(), init_chunk, NULL);
+    MMUKO_LOG(sys, "[PHASE 1] Initialized %zu cubit rings\n", sys->memory_size);
+    return BOOT_OK;
+}
+
+static void align_chunk(MMUKO_System* sys, size_t begin, size_t end, void* ctx) {
+    ChunkFault* fault = (ChunkFault*)ctx;
+    if (begin > atomic_load(&fault->byte)) return;
+
+    for (size_t b = begin; b < end; b++) {
+        int cubit = mmuko_ring_align(&sys->memory_map[b]);
+        if (cubit >= 0) {
+            fault_record(fault, b, cubit);
+            return;
+        }
+    }
+}
+
+static BootStatus parallel_phase2_compass_alignment(MMUKO_System* sys) {
+    MMUKO_LOG(sys, "[PHASE 2] Compass alignment...\n");
+
+    ChunkFault fault;
+    fault_init(&fault);
+    mmuko_pool_run(sys->pool, sys, sys->memory_size, mmuko_ring_chunk(), align_chunk, &fault);
+
+    size_t byte;
+    int cubit;
+    if (fault_found(&fault, &byte, &cubit)) {
+        MMUKO_LOG(sys, "[ERROR] Boot lock detected at byte %zu, cubit %d\n", byte, cubit);
+        return BOOT_LOCK_DETECTED;
+    }
+
+    MMUKO_LOG(sys, "[PHASE 2] All cubits aligned to compass directions\n");
+    return BOOT_OK;
+}
+
+// Resolved-pair masks are collected per byte and logged after the barrier
+static void entangle_chunk(MMUKO_System* sys, size_t begin, size_t end, void* ctx) {
+    uint8_t* resolved = (uint8_t*)ctx;
+    for (size_t b = begin; b < end; b++) {
+        resolved[b] = mmuko_ring_entangle(&sys->memory_map[b]);
+    }
+}
+
+static BootStatus parallel_phase3_superposition_entanglement(MMUKO_System* sys) {
+    MMUKO_LOG(sys, "[PHASE 3] Entangling superposition pairs...\n");
+
+    uint8_t* resolved = (uint8_t*)malloc(sys->memory_size);
+    if (!resolved) {
+        MMUKO_LOG(sys, "[ERROR] Out of memory for phase 3 results\n");
+        return BOOT_FAILED;
+    }
+    mmuko_pool_run(sys->pool, sys, sys->memory_size, mmuko_ring_chunk(), entangle_chunk, resolved);
+
+    for (size_t b = 0; b < sys->memory_size; b++) {
+        uint8_t mask = resolved[b];
+        for (int i = 0; mask != 0; i++, mask >>= 1) {
+            if (mask & 1) {
+                MMUKO_LOG(sys, "[PHASE 3] Resolved interference at byte %zu, pair (%d, %d)\n",
+                       b, i, sys->memory_map[b].cubit_ring[i].entangled_with);
+            }
+        }
+    }
+    free(resolved);
+
+    MMUKO_LOG(sys, "[PHASE 3] Superposition entanglement complete\n");
+    return BOOT_OK;
+}
+
+typedef struct {
+    Direction primary[13];          // By base index; only bases in `apply` are written
+    Direction secondary[13];
+    bool apply[13];
+} Superpositions;
+
+static void superposition_chunk(MMUKO_System* sys, size_t begin, size_t end, void* ctx) {
+    const Superpositions* table = (const Superpositions*)ctx;
+    for (size_t b = begin; b < end; b++) {
+        MMUKO_Byte* byte = &sys->memory_map[b];
+        int base = byte->base_index;
+        if (base >= 0 && base <= 12 && table->apply[base]) {
+            byte->primary_superposition = table->primary[base];
+            byte->secondary_superposition = table->secondary[base];
+        }
+    }
+}
+
+static BootStatus parallel_phase4_frame_centering(MMUKO_System* sys) {
+    MMUKO_LOG(sys, "[PHASE 4] Frame of reference centering...\n");
+
+    Direction primary, secondary;
+    lookup_superposition(get_middle_base(), &primary, &secondary);
+    set_frame_of_reference(sys, primary);
+
+    // Every base gets the centre superposition
+    Superpositions table;
+    for (int base = 0; base <= 12; base++) {
+        table.primary[base] = primary;
+        table.secondary[base] = secondary;
+        table.apply[base] = true;
+    }
+    mmuko_pool_run(sys->pool, sys, sys->memory_size, mmuko_ring_chunk(), superposition_chunk, &table);
+
+    return BOOT_OK;
+}
+
+// The diamond bases are distinct, so their passes touch disjoint bytes
+// and one pass over memory applies all of them
+static BootStatus parallel_phase5_nonlinear_resolution(MMUKO_System* sys) {
+    MMUKO_LOG(sys, "[PHASE 5] Nonlinear index resolution (diamond table)...\n");
+
+    Superpositions table;
+    memset(&table, 0, sizeof(table));
+    for (int i = 0; i < MMUKO_DIAMOND_SIZE; i++) {
+        int base = mmuko_diamond_order[i];
+        lookup_superposition(base, &table.primary[base], &table.secondary[base]);
+        table.apply[base] = true;
+    }
+    mmuko_pool_run(sys->pool, sys, sys->memory_size, mmuko_ring_chunk(), superposition_chunk, &table);
+
+    for (int i = 0; i < MMUKO_DIAMOND_SIZE; i++) {
+        int base = mmuko_diamond_order[i];
+        MMUKO_LOG(sys, "[PHASE 5] Base %d resolved → %s/%s\n", base,
+               direction_to_string(table.primary[base]),
+               direction_to_string(table.secondary[base]));
+    }
+
+    return BOOT_OK;
+}
+
+static void rotation_chunk(MMUKO_System* sys, size_t begin, size_t end, void* ctx) {
+    ChunkFault* fault = (ChunkFault*)ctx;
+    if (begin > atomic_load(&fault->byte)) return;
+
+    for (size_t b = begin; b < end; b++) {
+        int cubit = mmuko_ring_rotation_lock(&sys->memory_map[b]);
+        if (cubit >= 0) {
+            fault_record(fault, b, cubit);
+            return;
+        }
+    }
+}
+
+static BootStatus parallel_phase6_rotation_verification(MMUKO_System* sys) {
+    MMUKO_LOG(sys, "[PHASE 6] Rotation freedom check...\n");
+
+    ChunkFault fault;
+    fault_init(&fault);
+    mmuko_pool_run(sys->pool, sys, sys->memory_size, mmuko_ring_chunk(), rotation_chunk, &fault);
+
+    size_t byte;
+    int cubit;
+    if (fault_found(&fault, &byte, &cubit)) {
+        MMUKO_LOG(sys, "[ERROR] Rotation lock at byte %zu, cubit %d\n", byte, cubit);
+        return BOOT_ROTATION_LOCK;
+    }
+
+    MMUKO_LOG(sys, "[PHASE 6] All cubits rotate freely (360° verified)\n");
+    return BOOT_OK;
+}
+
+const MMUKO_PhaseFn mmuko_parallel_phases[MMUKO_PHASE_COUNT] = {
+    parallel_phase1_cubit_init,
+    parallel_phase2_compass_alignment,
+    parallel_phase3_superposition_entanglement,
+    parallel_phase4_frame_centering,
+    parallel_phase5_nonlinear_resolution,
+    parallel_phase6_rotation_verification
+};
+
+// ============================================================
+// END OF MMUKO-PARALLEL.C
+// ============================================================
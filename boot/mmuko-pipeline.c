@@ -0,0 +1,393 @@
+// ============================================================
+// MMUKO-PIPELINE.C — Streaming Boot over Bounded Queues
+// Project: OBINexus / OBIELF R&D
+// ============================================================
+//
+// Three stages: a reader thread fills fixed-size chunks from a file
+// or pipe, worker threads boot each chunk as its own system, and the
+// calling thread merges per-chunk status and digests in input order.
+// Workers digest their chunk in MMUKO_STREAM_DIGEST_BLOCK pieces, so
+// the merged digest does not depend on where chunks start.
+// Chunk i goes to worker i % N, so every queue is single-producer,
+// single-consumer: a ring of MMUKO_STREAM_QUEUE_DEPTH slots with
+// atomic head and tail; a side that keeps finding its queue full
+// or empty sleeps until the other side moves. A full queue stalls
+// its producer, which bounds memory however long the input is, and
+// the reader fills the next chunks while the workers boot the
+// current ones. Input chunk slots own their buffers, so nothing is
+// allocated per chunk.
+// ============================================================
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+
+#include "mmuko-boot.h"
+
+#define QUEUE_MASK (MMUKO_STREAM_QUEUE_DEPTH - 1)
+
+_Static_assert((MMUKO_STREAM_QUEUE_DEPTH & QUEUE_MASK) == 0,
+               "MMUKO_STREAM_QUEUE_DEPTH must be a power of two");
+
+// ─────────────────────────────────────────────
+// SINGLE-PRODUCER, SINGLE-CONSUMER QUEUE
+// ─────────────────────────────────────────────
+
+// Waits spin this many times before sleeping on the condition variable
+#define QUEUE_SPINS 64
+
+// Counters only grow; slot = counter & QUEUE_MASK. The slots live next
+// to the queue in the owning stage. A side that has spun QUEUE_SPINS
+// times without progress counts itself in `sleepers` and sleeps on
+// `changed`; the other side only takes the lock to wake it when a
+// sleeper is counted, so a busy queue stays lock-free
+typedef struct {
+    _Alignas(64) atomic_size_t head;    // Next slot to consume
+    _Alignas(64) atomic_size_t tail;    // Next slot to fill
+    _Alignas(64) atomic_int sleepers;
+    pthread_mutex_t lock;
+    pthread_cond_t changed;
+} SpscQueue;
+
+static void queue_init(SpscQueue* q) {
+    atomic_init(&q->head, 0);
+    atomic_init(&q->tail, 0);
+    atomic_init(&q->sleepers, 0);
+    pthread_mutex_init(&q->lock, NULL);
+    pthread_cond_init(&q->changed, NULL);
+}
+
+static void queue_destroy(SpscQueue* q) {
+    pthread_cond_destroy(&q->changed);
+    pthread_mutex_destroy(&q->lock);
+}
+
+// Wait until `counter` moves away from `value`. The sleeper count and the
+// counters are sequentially consistent, so either the waiter sees the new
+// counter or the side that moved it sees the sleeper and wakes it
+static void queue_wait(SpscQueue* q, atomic_size_t* counter, size_t value) {
+    for (int spin = 0; spin < QUEUE_SPINS; spin++) {
+        if (atomic_load_explicit(counter, memory_order_acquire) != value) return;
+        sched_yield();
+    }
+    pthread_mutex_lock(&q->lock);
+    atomic_fetch_add(&q->sleepers, 1);
+    while (atomic_load(counter) == value) {
+        pthread_cond_wait(&q->changed, &q->lock);
+    }
+    atomic_fetch_sub(&q->sleepers, 1);
+    pthread_mutex_unlock(&q->lock);
+}
+
+static void queue_advance(SpscQueue* q, atomic_size_t* counter) {
+    atomic_fetch_add(counter, 1);
+    if (atomic_load(&q->sleepers) > 0) {
+        pthread_mutex_lock(&q->lock);
+        pthread_cond_broadcast(&q->changed);
+        pthread_mutex_unlock(&q->lock);
+    }
+}
+
+// Producer: wait for a free slot and return it. Sets *stalled if the
+// queue was full
+static size_t queue_reserve(SpscQueue* q, bool* stalled) {
+    size_t tail = atomic_load_explicit(&q->tail, memory_order_relaxed);
+    size_t head = atomic_load_explicit(&q->head, memory_order_acquire);
+    *stalled = tail - head == MMUKO_STREAM_QUEUE_DEPTH;
+    if (*stalled) queue_wait(q, &q->head, head);
+    return tail & QUEUE_MASK;
+}
+
+// Producer: hand the reserved slot to the consumer
+static void queue_publish(SpscQueue* q) {
+    queue_advance(q, &q->tail);
+}
+
+// Consumer: wait for a filled slot and return it
+static size_t queue_peek(SpscQueue* q) {
+    size_t head = atomic_load_explicit(&q->head, memory_order_relaxed);
+    if (atomic_load_explicit(&q->tail, memory_order_acquire) == head) {
+        queue_wait(q, &q->tail, head);
+    }
+    return head & QUEUE_MASK;
+}
+
+// Consumer: give the slot back to the producer
+static void queue_release(SpscQueue* q) {
+    queue_advance(q, &q->head);
+}
+
+// ─────────────────────────────────────────────
+// STAGES
+// ─────────────────────────────────────────────
+
+typedef struct {
+    uint8_t* data;              // MMUKO_Stream.chunk bytes, owned by the slot
+    size_t length;              // 0 marks the end of the stream
+    size_t offset;
+} ChunkSlot;
+
+typedef struct {
+    size_t offset;
+    size_t length;
+    BootStatus status;
+    uint64_t* digests;          // One per digest block, owned by the slot
+    size_t blocks;
+    bool end;
+} ResultSlot;
+
+typedef struct {
+    SpscQueue input;            // Reader → worker
+    ChunkSlot chunks[MMUKO_STREAM_QUEUE_DEPTH];
+    SpscQueue output;           // Worker → merge stage
+    ResultSlot results[MMUKO_STREAM_QUEUE_DEPTH];
+    MMUKO_System* sys;          // Sized for one chunk, reused for every chunk
+    pthread_t thread;
+} StreamWorker;
+
+typedef struct {
+    int fd;
+    size_t chunk;
+    int worker_count;
+    StreamWorker* workers;
+    atomic_bool stop;           // Set by the merge stage after a failure
+    int read_error;             // errno of a failed read, or 0
+    size_t reader_stalls;
+} MMUKO_Stream;
+
+// Queue an end marker for a worker; used by the reader, or by the caller
+// when the reader never started
+static void send_end(StreamWorker* worker, size_t offset) {
+    bool stalled;
+    ChunkSlot* slot = &worker->chunks[queue_reserve(&worker->input, &stalled)];
+    slot->length = 0;
+    slot->offset = offset;
+    queue_publish(&worker->input);
+}
+
+// Fill `buffer` unless the input ends first. Returns the bytes read
+static size_t read_chunk(int fd, uint8_t* buffer, size_t size, int* error) {
+    size_t filled = 0;
+    while (filled < size) {
+        ssize_t n = read(fd, buffer + filled, size - filled);
+        if (n > 0) {
+            filled += (size_t)n;
+        } else if (n == 0) {
+            break;
+        } else if (errno != EINTR) {
+            *error = errno;
+            break;
+        }
+    }
+    return filled;
+}
+
+static void* reader_main(void* arg) {
+    MMUKO_Stream* stream = (MMUKO_Stream*)arg;
+    size_t index = 0;
+    size_t offset = 0;
+    bool stalled;
+
+    // Data chunks, in turn to each worker, until the input runs out
+    for (;; index++) {
+        if (atomic_load_explicit(&stream->stop, memory_order_relaxed) || stream->read_error) break;
+
+        StreamWorker* worker = &stream->workers[index % (size_t)stream->worker_count];
+        ChunkSlot* slot = &worker->chunks[queue_reserve(&worker->input, &stalled)];
+        stream->reader_stalls += stalled;
+
+        size_t length = read_chunk(stream->fd, slot->data, stream->chunk, &stream->read_error);
+        if (length == 0) break;     // The slot stays free for the end marker
+
+        slot->length = length;
+        slot->offset = offset;
+        queue_publish(&worker->input);
+        offset += length;
+        if (length < stream->chunk) {
+            index++;
+            break;
+        }
+    }
+
+    // One end marker per worker, continuing the round robin so the merge
+    // stage meets the first one right after the last data chunk
+    for (int k = 0; k < stream->worker_count; k++) {
+        send_end(&stream->workers[(index + (size_t)k) % (size_t)stream->worker_count], offset);
+    }
+    return NULL;
+}
+
+static void* worker_main(void* arg) {
+    StreamWorker* worker = (StreamWorker*)arg;
+    bool stalled;
+
+    for (;;) {
+        ChunkSlot* chunk = &worker->chunks[queue_peek(&worker->input)];
+        ResultSlot* result = &worker->results[queue_reserve(&worker->output, &stalled)];
+        result->offset = chunk->offset;
+        result->length = chunk->length;
+        result->end = chunk->length == 0;
+
+        if (result->end) {
+            queue_release(&worker->input);
+            queue_publish(&worker->output);
+            return NULL;
+        }
+
+        // The system keeps its own copy, so the reader can refill the slot now
+        mmuko_system_load(worker->sys, chunk->data, chunk->length);
+        queue_release(&worker->input);
+
+        result->status = mmuko_boot_quiet(worker->sys);
+        result->blocks = 0;
+        for (size_t b = 0; result->status == BOOT_OK && b < result->length;
+             b += MMUKO_STREAM_DIGEST_BLOCK) {
+            size_t end = result->length - b < MMUKO_STREAM_DIGEST_BLOCK
+                       ? result->length : b + MMUKO_STREAM_DIGEST_BLOCK;
+            uint64_t hash = mmuko_state_digest_range(worker->sys, b, end, MMUKO_DIGEST_INIT);
+            result->digests[result->blocks++] =
+                mmuko_state_digest_final(hash, worker->sys->frame_of_reference);
+        }
+        queue_publish(&worker->output);
+    }
+}
+
+// ─────────────────────────────────────────────
+// SETUP AND MERGE STAGE
+// ─────────────────────────────────────────────
+
+static void free_workers(MMUKO_Stream* stream) {
+    for (int w = 0; w < stream->worker_count; w++) {
+        StreamWorker* worker = &stream->workers[w];
+        mmuko_system_destroy(worker->sys);
+        queue_destroy(&worker->input);
+        queue_destroy(&worker->output);
+        for (int s = 0; s < MMUKO_STREAM_QUEUE_DEPTH; s++) {
+            free(worker->chunks[s].data);
+            free(worker->results[s].digests);
+        }
+    }
+    free(stream->workers);
+}
+
+static bool alloc_workers(MMUKO_Stream* stream, MMUKO_Layout layout, bool fused) {
+    stream->workers = (StreamWorker*)calloc((size_t)stream->worker_count, sizeof(StreamWorker));
+    if (!stream->workers) return false;
+
+    // Every queue first, so free_workers can destroy them all
+    for (int w = 0; w < stream->worker_count; w++) {
+        queue_init(&stream->workers[w].input);
+        queue_init(&stream->workers[w].output);
+    }
+
+    for (int w = 0; w < stream->worker_count; w++) {
+        StreamWorker* worker = &stream->workers[w];
+        worker->sys = mmuko_system_create_layout(stream->chunk, layout);
+        if (!worker->sys) return false;
+        worker->sys->fused = fused;
+        for (int s = 0; s < MMUKO_STREAM_QUEUE_DEPTH; s++) {
+            worker->chunks[s].data = (uint8_t*)malloc(stream->chunk);
+            worker->results[s].digests = (uint64_t*)malloc(
+                stream->chunk / MMUKO_STREAM_DIGEST_BLOCK * sizeof(uint64_t));
+            if (!worker->chunks[s].data || !worker->results[s].digests) return false;
+        }
+    }
+    return true;
+}
+
+bool mmuko_stream_fd(int fd, MMUKO_Layout layout, size_t chunk, int workers,
+                     bool fused, MMUKO_StreamResult* out) {
+    MMUKO_Stream stream;
+    memset(&stream, 0, sizeof(stream));
+    stream.fd = fd;
+    stream.chunk = chunk ? chunk : MMUKO_STREAM_CHUNK_STATE / mmuko_layout_state_bytes(layout);
+    stream.chunk = (stream.chunk + MMUKO_STREAM_DIGEST_BLOCK - 1) / MMUKO_STREAM_DIGEST_BLOCK
+                 * MMUKO_STREAM_DIGEST_BLOCK;
+    stream.worker_count = workers > 0 ? workers : (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (stream.worker_count < 1) stream.worker_count = 1;
+    atomic_init(&stream.stop, false);
+
+    if (!alloc_workers(&stream, layout, fused)) {
+        fprintf(stderr, "Failed to allocate %d stream workers of %zu bytes\n",
+                stream.worker_count, stream.chunk);
+        if (stream.workers) free_workers(&stream);
+        return false;
+    }
+
+    memset(out, 0, sizeof(*out));
+    out->chunk = stream.chunk;
+    out->workers = stream.worker_count;
+    out->status = BOOT_OK;
+
+    // Workers first: until the reader runs, this thread can still end them
+    int started = 0;
+    while (started < stream.worker_count &&
+           pthread_create(&stream.workers[started].thread, NULL, worker_main,
+                          &stream.workers[started]) == 0) {
+        started++;
+    }
+    pthread_t reader;
+    bool threads_ok = started == stream.worker_count &&
+                      pthread_create(&reader, NULL, reader_main, &stream) == 0;
+
+    // Merge results in input order; after a failure keep draining so
+    // every stage reaches its end marker
+    uint64_t hash = MMUKO_DIGEST_INIT;
+    for (size_t index = 0; threads_ok; index++) {
+        StreamWorker* worker = &stream.workers[index % (size_t)stream.worker_count];
+        ResultSlot* result = &worker->results[queue_peek(&worker->output)];
+        bool end = result->end;
+
+        if (!end && out->status == BOOT_OK) {
+            if (result->status == BOOT_OK) {
+                for (size_t k = 0; k < result->blocks; k++) {
+                    for (int i = 0; i < 8; i++) {
+                        hash = (hash ^ ((result->digests[k] >> (8 * i)) & 0xFF)) * 0x100000001B3ull;
+                    }
+                }
+                out->bytes += result->length;
+                out->chunks++;
+            } else {
+                out->status = result->status;
+                out->fault_offset = result->offset;
+                atomic_store(&stream.stop, true);
+            }
+        }
+        queue_release(&worker->output);
+        if (end) break;
+    }
+
+    if (threads_ok) {
+        pthread_join(reader, NULL);
+    } else {
+        for (int w = 0; w < started; w++) {
+            send_end(&stream.workers[w], 0);
+        }
+    }
+    for (int w = 0; w < started; w++) {
+        pthread_join(stream.workers[w].thread, NULL);
+    }
+
+    out->digest = hash;
+    out->reader_stalls = stream.reader_stalls;
+    free_workers(&stream);
+
+    if (!threads_ok) {
+        fprintf(stderr, "Failed to start stream threads\n");
+        return false;
+    }
+    if (stream.read_error) {
+        fprintf(stderr, "Read failed after %zu bytes: %s\n", out->bytes, strerror(stream.read_error));
+        return false;
+    }
+    return true;
+}
+
+// ============================================================
+// END OF MMUKO-PIPELINE.C
+// ============================================================
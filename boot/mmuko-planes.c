@@ -0,0 +1,366 @@
+// ============================================================
+// MMUKO-PLANES.C — Bit-Plane Layout for the MMUKO Memory Map
+// Project: OBINexus / OBIELF R&D
+// ============================================================
+//
+// The boot phases of mmuko-boot.c, run directly on MMUKO_Planes.
+// Bit i of every plane byte belongs to cubit i, so one byte-wide
+// operation updates all eight cubits of a ring. Final state matches
+// the ring layout exactly (compare with mmuko_state_digest); phase 3
+// logs a resolved-pair count instead of one line per byte.
+// ============================================================
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "mmuko-boot.h"
+
+// Direction i of a freshly initialized ring is i itself
+#define DIRECTION_BITS_0 0xAA
+#define DIRECTION_BITS_1 0xCC
+#define DIRECTION_BITS_2 0xF0
+
+// ─────────────────────────────────────────────
+// PLANE STORAGE
+// ─────────────────────────────────────────────
+
+bool mmuko_planes_alloc(MMUKO_Planes* planes, size_t size) {
+    memset(planes, 0, sizeof(*planes));
+
+    // One block; the planes are consecutive slices of it
+    uint8_t* block = (uint8_t*)calloc(MMUKO_PLANE_COUNT, size);
+    if (!block) return false;
+
+    planes->raw = block;
+    planes->state_lo = block + size;
+    planes->state_hi = block + 2 * size;
+    planes->superposed = block + 3 * size;
+    planes->direction[0] = block + 4 * size;
+    planes->direction[1] = block + 5 * size;
+    planes->direction[2] = block + 6 * size;
+    planes->undefined = block + 7 * size;
+    planes->base_index = block + 8 * size;
+    planes->superposition = block + 9 * size;
+    planes->size = size;
+    return true;
+}
+
+void mmuko_planes_free(MMUKO_Planes* planes) {
+    free(planes->raw);
+    memset(planes, 0, sizeof(*planes));
+}
+
+uint8_t mmuko_plane_direction(const MMUKO_Planes* planes, size_t b, int i) {
+    if ((planes->undefined[b] >> i) & 1) return UNDEFINED_DIR;
+    return (uint8_t)(((planes->direction[0][b] >> i) & 1) |
+                     (((planes->direction[1][b] >> i) & 1) << 1) |
+                     (((planes->direction[2][b] >> i) & 1) << 2));
+}
+
+State mmuko_plane_state(const MMUKO_Planes* planes, size_t b, int i) {
+    return (State)(((planes->state_lo[b] >> i) & 1) | (((planes->state_hi[b] >> i) & 1) << 1));
+}
+
+static void set_plane_direction(MMUKO_Planes* planes, size_t b, int i, Direction dir) {
+    uint8_t bit = (uint8_t)(1u << i);
+    for (int k = 0; k < 3; k++) {
+        planes->direction[k][b] = (uint8_t)((planes->direction[k][b] & ~bit) |
+                                            (((dir >> k) & 1) ? bit : 0));
+    }
+    planes->undefined[b] &= (uint8_t)~bit;
+}
+
+static uint8_t pack_superposition(Direction primary, Direction secondary) {
+    return (uint8_t)(primary | (secondary << 4));
+}
+
+// Superposed cubits that have an entanglement partner
+static uint8_t entangled_mask(void) {
+    uint8_t mask = 0;
+    for (int i = 0; i < 8; i++) {
+        if (mmuko_entangled_pairs[i] != -1) mask |= (uint8_t)(1u << i);
+    }
+    return mask;
+}
+
+// Without -mpopcnt __builtin_popcount is a libgcc call; this inlines
+static inline int popcount8(uint8_t x) {
+    x = (uint8_t)(x - ((x >> 1) & 0x55));
+    x = (uint8_t)((x & 0x33) + ((x >> 2) & 0x33));
+    return (x + (x >> 4)) & 0x0F;
+}
+
+// Bit-reversed value of every byte, two bits at a time
+#define REVERSE2(n)     (n), (n) + 2 * 64, (n) + 1 * 64, (n) + 3 * 64
+#define REVERSE4(n)     REVERSE2(n), REVERSE2((n) + 2 * 16), REVERSE2((n) + 1 * 16), \
+                        REVERSE2((n) + 3 * 16)
+#define REVERSE6(n)     REVERSE4(n), REVERSE4((n) + 2 * 4), REVERSE4((n) + 1 * 4), \
+                        REVERSE4((n) + 3 * 4)
+
+static const uint8_t reversed_bytes[256] = {
+    REVERSE6(0), REVERSE6(2), REVERSE6(1), REVERSE6(3)
+};
+
+static inline uint8_t reverse_bits(uint8_t x) {
+    return reversed_bytes[x];
+}
+
+// ─────────────────────────────────────────────
+// PHASE 1: CUBIT PLANE INITIALIZATION
+// ─────────────────────────────────────────────
+
+// Per-raw-value planes of a freshly initialized ring. UP = 11, CHARM = 10,
+// STRANGE = 01, DOWN = 00 (bit, neighbor), where the neighbor of bit i is
+// bit i+1 (rotate_bits(v, 1)). The remaining planes are the same for every
+// byte. Same source as mmuko_canonical_rings
+typedef struct {
+    uint8_t state_lo;
+    uint8_t state_hi;
+    uint8_t base_index;
+    uint8_t superposition;
+} PlaneClass;
+
+#define PLANE_ROTATE1(v)    ((uint8_t)(((v) >> 1) | ((v) << 7)))
+#define PLANE_CLASS(v) \
+    { (uint8_t)~(v), (uint8_t)((v) ^ PLANE_ROTATE1(v)), MMUKO_RING_BASE(v), \
+      (uint8_t)(MMUKO_BASE_PRIMARY(MMUKO_RING_BASE(v)) | \
+                (MMUKO_BASE_SECONDARY(MMUKO_RING_BASE(v)) << 4)) }
+#define PLANE_CLASS4(v)     PLANE_CLASS(v), PLANE_CLASS((v) + 1), \
+                            PLANE_CLASS((v) + 2), PLANE_CLASS((v) + 3)
+#define PLANE_CLASS16(v)    PLANE_CLASS4(v), PLANE_CLASS4((v) + 4), \
+                            PLANE_CLASS4((v) + 8), PLANE_CLASS4((v) + 12)
+#define PLANE_CLASS64(v)    PLANE_CLASS16(v), PLANE_CLASS16((v) + 16), \
+                            PLANE_CLASS16((v) + 32), PLANE_CLASS16((v) + 48)
+
+static const PlaneClass plane_classes[256] = {
+    PLANE_CLASS64(0), PLANE_CLASS64(64), PLANE_CLASS64(128), PLANE_CLASS64(192)
+};
+
+static BootStatus planes_phase1_cubit_init(MMUKO_System* sys) {
+    MMUKO_LOG(sys, "[PHASE 1] Initializing cubit planes...\n");
+
+    MMUKO_Planes* planes = &sys->planes;
+    memset(planes->superposed, entangled_mask(), planes->size);
+    memset(planes->direction[0], DIRECTION_BITS_0, planes->size);
+    memset(planes->direction[1], DIRECTION_BITS_1, planes->size);
+    memset(planes->direction[2], DIRECTION_BITS_2, planes->size);
+    memset(planes->undefined, 0, planes->size);
+
+    for (size_t b = 0; b < planes->size; b++) {
+        const PlaneClass* cls = &plane_classes[planes->raw[b]];
+        planes->state_lo[b] = cls->state_lo;
+        planes->state_hi[b] = cls->state_hi;
+        planes->base_index[b] = cls->base_index;
+        planes->superposition[b] = cls->superposition;
+    }
+
+    MMUKO_LOG(sys, "[PHASE 1] Initialized %zu cubit rings\n", planes->size);
+    return BOOT_OK;
+}
+
+// ─────────────────────────────────────────────
+// PHASE 2: COMPASS ALIGNMENT
+// ─────────────────────────────────────────────
+
+// Same rule as resolve_direction_from_neighbors: the left neighbor's
+// direction if defined, else the right neighbor's, else NORTH
+static Direction plane_neighbor_direction(const MMUKO_Planes* planes, size_t b, int i) {
+    uint8_t left = mmuko_plane_direction(planes, b, (i + 7) % 8);
+    if (left != UNDEFINED_DIR) return (Direction)left;
+    uint8_t right = mmuko_plane_direction(planes, b, (i + 1) % 8);
+    if (right != UNDEFINED_DIR) return (Direction)right;
+    return N;
+}
+
+// Scalar only: planes phase 1 defines every direction, so this loop only
+// skips and a vector version would never run
+void mmuko_planes_align(MMUKO_Planes* planes, size_t begin, size_t end) {
+    for (size_t b = begin; b < end; b++) {
+        if (planes->undefined[b] == 0) continue;
+
+        // In cubit order, so a resolved cubit counts for the next one
+        for (int i = 0; i < 8; i++) {
+            if (!((planes->undefined[b] >> i) & 1)) continue;
+            set_plane_direction(planes, b, i, plane_neighbor_direction(planes, b, i));
+        }
+    }
+}
+
+// The rule always yields a direction (NORTH at worst), so planes never lock
+static BootStatus planes_phase2_compass_alignment(MMUKO_System* sys) {
+    MMUKO_LOG(sys, "[PHASE 2] Compass alignment...\n");
+
+    mmuko_planes_align(&sys->planes, 0, sys->planes.size);
+
+    MMUKO_LOG(sys, "[PHASE 2] All cubits aligned to compass directions\n");
+    return BOOT_OK;
+}
+
+// ─────────────────────────────────────────────
+// PHASE 3: SUPERPOSITION ENTANGLEMENT
+// ─────────────────────────────────────────────
+
+// Partners are mirror indices (i <-> 7 - i), so bit-reversing a plane lines
+// each cubit up with its partner. The reference loop visits cubits 0..7 in
+// order; cubits 0–2 flip partners 5–7 first, then 5–7 see the result and
+// may flip 0–2. flip_state toggles state bit 0 (UP<->DOWN, CHARM<->STRANGE).
+// Scalar kernel behind mmuko_planes_entangle (mmuko-simd.c)
+size_t mmuko_planes_entangle_scalar(MMUKO_Planes* planes, size_t begin, size_t end,
+                                    uint8_t first, uint8_t second) {
+    size_t resolved = 0;
+
+    for (size_t b = begin; b < end; b++) {
+        uint8_t lo = planes->state_lo[b];
+        uint8_t hi = planes->state_hi[b];
+        uint8_t active = planes->superposed[b];
+
+        uint8_t equal = (uint8_t)~((lo ^ reverse_bits(lo)) | (hi ^ reverse_bits(hi)));
+        uint8_t flips = active & equal & first;
+        lo ^= reverse_bits(flips);
+
+        equal = (uint8_t)~((lo ^ reverse_bits(lo)) | (hi ^ reverse_bits(hi)));
+        uint8_t flips2 = active & equal & second;
+        lo ^= reverse_bits(flips2);
+
+        planes->state_lo[b] = lo;
+        resolved += (size_t)popcount8((uint8_t)(flips | flips2));
+    }
+
+    return resolved;
+}
+
+static BootStatus planes_phase3_superposition_entanglement(MMUKO_System* sys) {
+    MMUKO_LOG(sys, "[PHASE 3] Entangling superposition pairs...\n");
+
+    size_t resolved = mmuko_planes_entangle(&sys->planes, 0, sys->planes.size);
+
+    MMUKO_LOG(sys, "[PHASE 3] Resolved interference in %zu pairs\n", resolved);
+    MMUKO_LOG(sys, "[PHASE 3] Superposition entanglement complete\n");
+    return BOOT_OK;
+}
+
+// ─────────────────────────────────────────────
+// PHASE 4: FRAME OF REFERENCE CENTERING
+// ─────────────────────────────────────────────
+
+static BootStatus planes_phase4_frame_centering(MMUKO_System* sys) {
+    MMUKO_LOG(sys, "[PHASE 4] Frame of reference centering...\n");
+
+    int center_base = get_middle_base();
+    Direction primary, secondary;
+    lookup_superposition(center_base, &primary, &secondary);
+
+    set_frame_of_reference(sys, primary);
+    memset(sys->planes.superposition, pack_superposition(primary, secondary), sys->planes.size);
+
+    return BOOT_OK;
+}
+
+// ─────────────────────────────────────────────
+// PHASE 5: NONLINEAR INDEX RESOLUTION
+// ─────────────────────────────────────────────
+
+static BootStatus planes_phase5_nonlinear_resolution(MMUKO_System* sys) {
+    MMUKO_LOG(sys, "[PHASE 5] Nonlinear index resolution (diamond table)...\n");
+
+    MMUKO_Planes* planes = &sys->planes;
+
+    for (int i = 0; i < MMUKO_DIAMOND_SIZE; i++) {
+        int base = mmuko_diamond_order[i];
+        Direction primary, secondary;
+        lookup_superposition(base, &primary, &secondary);
+        uint8_t packed = pack_superposition(primary, secondary);
+
+        for (size_t b = 0; b < planes->size; b++) {
+            if (planes->base_index[b] == base) planes->superposition[b] = packed;
+        }
+        MMUKO_LOG(sys, "[PHASE 5] Base %d resolved → %s/%s\n",
+               base, direction_to_string(primary), direction_to_string(secondary));
+    }
+
+    return BOOT_OK;
+}
+
+// ─────────────────────────────────────────────
+// PHASE 6: ROTATION VERIFICATION
+// ─────────────────────────────────────────────
+
+static BootStatus planes_phase6_rotation_verification(MMUKO_System* sys) {
+    MMUKO_LOG(sys, "[PHASE 6] Rotation freedom check...\n");
+
+    // A cubit value is 0 or 1, so two outcomes cover every cubit
+    const bool zero_free = rotate_bits(rotate_bits(0, 4), 4) == 0;
+    const bool one_free = rotate_bits(rotate_bits(1, 4), 4) == 1;
+    MMUKO_Planes* planes = &sys->planes;
+
+    for (size_t b = 0; b < planes->size; b++) {
+        uint8_t v = planes->raw[b];
+        uint8_t locked = (uint8_t)((one_free ? 0 : v) | (zero_free ? 0 : ~v));
+        if (locked != 0) {
+            MMUKO_LOG(sys, "[ERROR] Rotation lock at byte %zu, cubit %d\n", b, __builtin_ctz(locked));
+            return BOOT_ROTATION_LOCK;
+        }
+    }
+
+    MMUKO_LOG(sys, "[PHASE 6] All cubits rotate freely (360° verified)\n");
+    return BOOT_OK;
+}
+
+// ─────────────────────────────────────────────
+// FUSED PHASES 1–6 (driven by mmuko-fused.c)
+// ─────────────────────────────────────────────
+
+// Phases 1, 4, 5 and 6 in registers for each byte of the range, then the
+// phase 3 kernel while the range is still in cache. Phase 2 has nothing
+// to resolve on freshly initialized planes; phases 4 and 5 collapse to
+// `superposition[base]`
+bool mmuko_planes_fused_range(MMUKO_Planes* planes, size_t begin, size_t end,
+                              const uint8_t superposition[13], size_t* resolved) {
+    const uint8_t entangled = entangled_mask();
+    const bool zero_free = rotate_bits(rotate_bits(0, 4), 4) == 0;
+    const bool one_free = rotate_bits(rotate_bits(1, 4), 4) == 1;
+    size_t count = end - begin;
+
+    // Plane stores are uint8_t and may alias *planes, so keep the pointers local
+    const uint8_t* raw = planes->raw;
+    uint8_t* state_lo = planes->state_lo;
+    uint8_t* state_hi = planes->state_hi;
+    uint8_t* base_index = planes->base_index;
+    uint8_t* packed = planes->superposition;
+    const uint8_t locked_if_one = one_free ? 0 : 0xFF;
+    const uint8_t locked_if_zero = zero_free ? 0 : 0xFF;
+    uint8_t locked = 0;
+
+    memset(planes->superposed + begin, entangled, count);
+    memset(planes->direction[0] + begin, DIRECTION_BITS_0, count);
+    memset(planes->direction[1] + begin, DIRECTION_BITS_1, count);
+    memset(planes->direction[2] + begin, DIRECTION_BITS_2, count);
+    memset(planes->undefined + begin, 0, count);
+
+    for (size_t b = begin; b < end; b++) {
+        uint8_t v = raw[b];
+        const PlaneClass* cls = &plane_classes[v];
+        state_lo[b] = cls->state_lo;
+        state_hi[b] = cls->state_hi;
+        base_index[b] = cls->base_index;
+        packed[b] = superposition[cls->base_index];
+        locked |= (uint8_t)((v & locked_if_one) | (~v & locked_if_zero));
+    }
+
+    *resolved += mmuko_planes_entangle(planes, begin, end);
+    return locked == 0;
+}
+
+const MMUKO_PhaseFn mmuko_plane_phases[MMUKO_PHASE_COUNT] = {
+    planes_phase1_cubit_init,
+    planes_phase2_compass_alignment,
+    planes_phase3_superposition_entanglement,
+    planes_phase4_frame_centering,
+    planes_phase5_nonlinear_resolution,
+    planes_phase6_rotation_verification
+};
+
+// ============================================================
+// END OF MMUKO-PLANES.C
+// ============================================================
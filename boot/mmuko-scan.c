@@ -0,0 +1,210 @@
+// ============================================================
+// MMUKO-SCAN.C — Booting Files and Block Devices as MMUKO Memory
+// Project: OBINexus / OBIELF R&D
+// ============================================================
+//
+// The input is mapped read-only and booted one window at a time on
+// a single system sized for the window, so derived state stays
+// bounded however large the input is. Every phase step depends
+// only on its own byte (phases 4 and 5 on the fixed base table),
+// so booting consecutive windows gives the same state, byte for
+// byte, as booting the input whole, and the digest is continued
+// across windows to match. The kernel is told the map is read
+// sequentially, asked to read ahead one window, and told to drop
+// each window once it is booted. With a checkpoint, the position
+// and digest state are saved after every window, and a resumed scan
+// of the same input starts at the first window not yet booted.
+// ============================================================
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "mmuko-boot.h"
+
+// ─────────────────────────────────────────────
+// INPUT MAPPING
+// ─────────────────────────────────────────────
+
+typedef struct {
+    const uint8_t* data;
+    size_t size;
+    uint64_t inode;
+    int64_t mtime_sec;
+    int64_t mtime_nsec;
+} ScanInput;
+
+static bool map_input(const char* path, ScanInput* input) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        fprintf(stderr, "Cannot open %s: %s\n", path, strerror(errno));
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || !(S_ISREG(st.st_mode) || S_ISBLK(st.st_mode))) {
+        fprintf(stderr, "%s is not a regular file or block device\n", path);
+        close(fd);
+        return false;
+    }
+
+    // st_size is 0 for block devices; the end offset is the device size
+    off_t end = lseek(fd, 0, SEEK_END);
+    if (end <= 0) {
+        fprintf(stderr, "%s is empty or its size is unknown\n", path);
+        close(fd);
+        return false;
+    }
+
+    void* data = mmap(NULL, (size_t)end, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);      // The mapping keeps its own reference
+    if (data == MAP_FAILED) {
+        fprintf(stderr, "Cannot map %s: %s\n", path, strerror(errno));
+        return false;
+    }
+
+    madvise(data, (size_t)end, MADV_SEQUENTIAL);
+    input->data = (const uint8_t*)data;
+    input->size = (size_t)end;
+    input->inode = (uint64_t)st.st_ino;
+    input->mtime_sec = (int64_t)st.st_mtim.tv_sec;
+    input->mtime_nsec = (int64_t)st.st_mtim.tv_nsec;
+    return true;
+}
+
+// Window in input bytes, a whole number of pages so madvise ranges align
+static size_t scan_window(MMUKO_Layout layout, size_t requested, size_t input_size) {
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    size_t window = requested;
+
+    if (window == 0) {
+        window = MMUKO_SCAN_STATE_BUDGET / mmuko_layout_state_bytes(layout);
+    }
+    window = (window + page - 1) / page * page;
+    return window < input_size ? window : input_size;
+}
+
+// ─────────────────────────────────────────────
+// CHECKPOINTS
+// ─────────────────────────────────────────────
+
+// Why `progress` cannot continue a scan of `input`, or NULL if it can
+static const char* resume_problem(const ScanInput* input, const MMUKO_ScanProgress* progress) {
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+
+    if (progress->input_size != input->size || progress->inode != input->inode ||
+        progress->mtime_sec != input->mtime_sec || progress->mtime_nsec != input->mtime_nsec) {
+        return "a different input";
+    }
+    if (progress->offset > input->size || progress->sample_length > progress->offset ||
+        (progress->offset % page != 0 && progress->offset != input->size)) {
+        return "bad offset";
+    }
+    const uint8_t* last = input->data + progress->offset - progress->sample_length;
+    if (mmuko_checkpoint_checksum(last, progress->sample_length) != progress->sample) {
+        return "input changed";
+    }
+    return NULL;
+}
+
+// The saved position, or a fresh one for `input`
+static void start_progress(const ScanInput* input, const char* checkpoint, bool resume,
+                           MMUKO_ScanProgress* progress) {
+    if (resume) {
+        const char* problem = mmuko_scan_checkpoint_load(checkpoint, progress);
+        if (!problem) problem = resume_problem(input, progress);
+        if (!problem) {
+            printf("[SCAN] Resumed at offset %llu from %s\n",
+                   (unsigned long long)progress->offset, checkpoint);
+            return;
+        }
+        printf("[SCAN] Ignoring %s (%s), scanning from offset 0\n", checkpoint, problem);
+    }
+
+    memset(progress, 0, sizeof(*progress));
+    progress->input_size = input->size;
+    progress->inode = input->inode;
+    progress->mtime_sec = input->mtime_sec;
+    progress->mtime_nsec = input->mtime_nsec;
+    progress->hash = MMUKO_DIGEST_INIT;
+}
+
+// ─────────────────────────────────────────────
+// WINDOWED BOOT
+// ─────────────────────────────────────────────
+
+bool mmuko_scan_file(const char* path, MMUKO_Layout layout, size_t window,
+                     int threads, bool fused, const char* checkpoint, bool resume,
+                     MMUKO_ScanResult* out) {
+    ScanInput input;
+    if (!map_input(path, &input)) return false;
+
+    memset(out, 0, sizeof(*out));
+    out->bytes = input.size;
+    out->window = scan_window(layout, window, input.size);
+    out->status = BOOT_OK;
+
+    MMUKO_ScanProgress progress;
+    start_progress(&input, checkpoint, checkpoint && resume, &progress);
+    out->resumed_offset = (size_t)progress.offset;
+
+    MMUKO_System* sys = mmuko_system_create_layout(out->window, layout);
+    if (!sys || !mmuko_system_set_threads(sys, threads)) {
+        fprintf(stderr, "Failed to create a %zu-byte MMUKO system\n", out->window);
+        mmuko_system_destroy(sys);
+        munmap((void*)input.data, input.size);
+        return false;
+    }
+    sys->fused = fused;
+
+    for (size_t offset = (size_t)progress.offset; offset < input.size; offset += out->window) {
+        size_t length = input.size - offset < out->window ? input.size - offset : out->window;
+        size_t next = offset + length;
+        if (next < input.size) {
+            size_t ahead = input.size - next < out->window ? input.size - next : out->window;
+            madvise((void*)(input.data + next), ahead, MADV_WILLNEED);
+        }
+
+        mmuko_system_load(sys, input.data + offset, length);
+        BootStatus status = mmuko_boot_quiet(sys);
+        if (status != BOOT_OK) {
+            // Boot the window again with its log, so the failing byte is reported
+            printf("[SCAN] Window at offset %zu failed (bytes below are window-relative)\n", offset);
+            mmuko_system_load(sys, input.data + offset, length);
+            mmuko_boot(sys);
+            out->status = status;
+            out->fault_offset = offset;
+            break;
+        }
+
+        progress.hash = mmuko_state_digest_update(sys, progress.hash);
+        progress.offset = next;
+        progress.windows++;
+        progress.frame = (uint32_t)sys->frame_of_reference;
+        if (checkpoint) {
+            progress.sample_length = length;
+            progress.sample = mmuko_checkpoint_checksum(input.data + offset, length);
+            if (!mmuko_scan_checkpoint_save(checkpoint, &progress)) {
+                printf("[SCAN] Writing %s failed: %s; no further checkpoints\n",
+                       checkpoint, strerror(errno));
+                checkpoint = NULL;
+            }
+        }
+        madvise((void*)(input.data + offset), length, MADV_DONTNEED);
+    }
+
+    out->windows = (size_t)progress.windows;
+    out->digest = mmuko_state_digest_final(progress.hash, (Direction)progress.frame);
+    mmuko_system_destroy(sys);
+    munmap((void*)input.data, input.size);
+    return true;
+}
+
+// ============================================================
+// END OF MMUKO-SCAN.C
+// ============================================================
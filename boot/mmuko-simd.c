@@ -0,0 +1,250 @@
+// ============================================================
+// MMUKO-SIMD.C — Vector Kernels for the Bit-Plane Phases
+// Project: OBINexus / OBIELF R&D
+// ============================================================
+//
+// AVX2 and AVX-512 versions of the phase 3 plane kernel (partner
+// flip), covering 32 or 64 rings per instruction. The kernel set
+// is picked at runtime from what the CPU supports; the scalar
+// kernel in mmuko-planes.c handles range tails, other
+// architectures, and `--simd scalar`. Phase 2 stays scalar: planes
+// phase 1 defines every direction, so its loop only ever skips.
+// ============================================================
+
+#include <string.h>
+#include <stdatomic.h>
+
+#include "mmuko-boot.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define MMUKO_SIMD_X86 1
+#else
+#define MMUKO_SIMD_X86 0
+#endif
+
+typedef size_t (*EntangleKernel)(MMUKO_Planes* planes, size_t begin, size_t end,
+                                 uint8_t first, uint8_t second);
+
+typedef struct {
+    const char* name;
+    EntangleKernel entangle;
+} SimdKernels;
+
+// Bit reversal within a byte is two nibble lookups: the reversed low nibble
+// becomes the high nibble and vice versa
+#define REVERSED_NIBBLES        0x0, 0x8, 0x4, 0xC, 0x2, 0xA, 0x6, 0xE, \
+                                0x1, 0x9, 0x5, 0xD, 0x3, 0xB, 0x7, 0xF
+#define REVERSED_NIBBLES_HIGH   0x00, 0x80, 0x40, 0xC0, 0x20, 0xA0, 0x60, 0xE0, \
+                                0x10, 0x90, 0x50, 0xD0, 0x30, 0xB0, 0x70, 0xF0
+#define NIBBLE_POPCOUNTS        0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4
+
+#if MMUKO_SIMD_X86
+
+// ─────────────────────────────────────────────
+// AVX2 (32 rings per vector)
+// ─────────────────────────────────────────────
+
+#define AVX2 __attribute__((target("avx2")))
+
+static AVX2 inline __m256i avx2_lut(const int8_t table[16]) {
+    return _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)table));
+}
+
+static AVX2 inline __m256i avx2_high_nibbles(__m256i x, __m256i low_mask) {
+    return _mm256_and_si256(_mm256_srli_epi16(x, 4), low_mask);
+}
+
+static AVX2 inline __m256i avx2_reverse(__m256i x, __m256i to_high, __m256i to_low,
+                                       __m256i low_mask) {
+    __m256i low = _mm256_shuffle_epi8(to_high, _mm256_and_si256(x, low_mask));
+    __m256i high = _mm256_shuffle_epi8(to_low, avx2_high_nibbles(x, low_mask));
+    return _mm256_or_si256(low, high);
+}
+
+static AVX2 size_t entangle_avx2(MMUKO_Planes* planes, size_t begin, size_t end,
+                                 uint8_t first, uint8_t second) {
+    static const int8_t to_high[16] = { REVERSED_NIBBLES_HIGH };
+    static const int8_t to_low[16] = { REVERSED_NIBBLES };
+    static const int8_t popcounts[16] = { NIBBLE_POPCOUNTS };
+
+    const __m256i high_lut = avx2_lut(to_high);
+    const __m256i low_lut = avx2_lut(to_low);
+    const __m256i pop_lut = avx2_lut(popcounts);
+    const __m256i low_mask = _mm256_set1_epi8(0x0F);
+    const __m256i first_mask = _mm256_set1_epi8((char)first);
+    const __m256i second_mask = _mm256_set1_epi8((char)second);
+    __m256i totals = _mm256_setzero_si256();
+    size_t b = begin;
+
+    for (; b + 32 <= end; b += 32) {
+        __m256i lo = _mm256_loadu_si256((const __m256i*)(planes->state_lo + b));
+        __m256i hi = _mm256_loadu_si256((const __m256i*)(planes->state_hi + b));
+        __m256i active = _mm256_loadu_si256((const __m256i*)(planes->superposed + b));
+        __m256i hi_diff = _mm256_xor_si256(hi, avx2_reverse(hi, high_lut, low_lut, low_mask));
+
+        // ~(lo ^ rev(lo) | hi ^ rev(hi)) & active & first, as andnot
+        __m256i diff = _mm256_or_si256(_mm256_xor_si256(lo, avx2_reverse(lo, high_lut, low_lut, low_mask)),
+                                       hi_diff);
+        __m256i flips = _mm256_andnot_si256(diff, _mm256_and_si256(active, first_mask));
+        lo = _mm256_xor_si256(lo, avx2_reverse(flips, high_lut, low_lut, low_mask));
+
+        diff = _mm256_or_si256(_mm256_xor_si256(lo, avx2_reverse(lo, high_lut, low_lut, low_mask)),
+                               hi_diff);
+        __m256i flips2 = _mm256_andnot_si256(diff, _mm256_and_si256(active, second_mask));
+        lo = _mm256_xor_si256(lo, avx2_reverse(flips2, high_lut, low_lut, low_mask));
+
+        _mm256_storeu_si256((__m256i*)(planes->state_lo + b), lo);
+
+        __m256i all = _mm256_or_si256(flips, flips2);
+        __m256i counts = _mm256_add_epi8(_mm256_shuffle_epi8(pop_lut, _mm256_and_si256(all, low_mask)),
+                                         _mm256_shuffle_epi8(pop_lut, avx2_high_nibbles(all, low_mask)));
+        totals = _mm256_add_epi64(totals, _mm256_sad_epu8(counts, _mm256_setzero_si256()));
+    }
+
+    uint64_t lanes[4];
+    _mm256_storeu_si256((__m256i*)lanes, totals);
+    size_t resolved = (size_t)(lanes[0] + lanes[1] + lanes[2] + lanes[3]);
+    return resolved + mmuko_planes_entangle_scalar(planes, b, end, first, second);
+}
+
+// ─────────────────────────────────────────────
+// AVX-512 (64 rings per vector; needs AVX512BW for byte shuffles)
+// ─────────────────────────────────────────────
+
+#define AVX512 __attribute__((target("avx512f,avx512bw")))
+
+static AVX512 inline __m512i avx512_lut(const int8_t table[16]) {
+    return _mm512_broadcast_i32x4(_mm_loadu_si128((const __m128i*)table));
+}
+
+static AVX512 inline __m512i avx512_high_nibbles(__m512i x, __m512i low_mask) {
+    return _mm512_and_si512(_mm512_srli_epi16(x, 4), low_mask);
+}
+
+static AVX512 inline __m512i avx512_reverse(__m512i x, __m512i to_high, __m512i to_low,
+                                           __m512i low_mask) {
+    __m512i low = _mm512_shuffle_epi8(to_high, _mm512_and_si512(x, low_mask));
+    __m512i high = _mm512_shuffle_epi8(to_low, avx512_high_nibbles(x, low_mask));
+    return _mm512_or_si512(low, high);
+}
+
+static AVX512 size_t entangle_avx512(MMUKO_Planes* planes, size_t begin, size_t end,
+                                     uint8_t first, uint8_t second) {
+    static const int8_t to_high[16] = { REVERSED_NIBBLES_HIGH };
+    static const int8_t to_low[16] = { REVERSED_NIBBLES };
+    static const int8_t popcounts[16] = { NIBBLE_POPCOUNTS };
+
+    const __m512i high_lut = avx512_lut(to_high);
+    const __m512i low_lut = avx512_lut(to_low);
+    const __m512i pop_lut = avx512_lut(popcounts);
+    const __m512i low_mask = _mm512_set1_epi8(0x0F);
+    const __m512i first_mask = _mm512_set1_epi8((char)first);
+    const __m512i second_mask = _mm512_set1_epi8((char)second);
+    __m512i totals = _mm512_setzero_si512();
+    size_t b = begin;
+
+    for (; b + 64 <= end; b += 64) {
+        __m512i lo = _mm512_loadu_si512(planes->state_lo + b);
+        __m512i hi = _mm512_loadu_si512(planes->state_hi + b);
+        __m512i active = _mm512_loadu_si512(planes->superposed + b);
+        __m512i hi_diff = _mm512_xor_si512(hi, avx512_reverse(hi, high_lut, low_lut, low_mask));
+
+        __m512i diff = _mm512_or_si512(_mm512_xor_si512(lo, avx512_reverse(lo, high_lut, low_lut, low_mask)),
+                                       hi_diff);
+        __m512i flips = _mm512_andnot_si512(diff, _mm512_and_si512(active, first_mask));
+        lo = _mm512_xor_si512(lo, avx512_reverse(flips, high_lut, low_lut, low_mask));
+
+        diff = _mm512_or_si512(_mm512_xor_si512(lo, avx512_reverse(lo, high_lut, low_lut, low_mask)),
+                               hi_diff);
+        __m512i flips2 = _mm512_andnot_si512(diff, _mm512_and_si512(active, second_mask));
+        lo = _mm512_xor_si512(lo, avx512_reverse(flips2, high_lut, low_lut, low_mask));
+
+        _mm512_storeu_si512(planes->state_lo + b, lo);
+
+        __m512i all = _mm512_or_si512(flips, flips2);
+        __m512i counts = _mm512_add_epi8(_mm512_shuffle_epi8(pop_lut, _mm512_and_si512(all, low_mask)),
+                                         _mm512_shuffle_epi8(pop_lut, avx512_high_nibbles(all, low_mask)));
+        totals = _mm512_add_epi64(totals, _mm512_sad_epu8(counts, _mm512_setzero_si512()));
+    }
+
+    size_t resolved = (size_t)_mm512_reduce_add_epi64(totals);
+    return resolved + mmuko_planes_entangle_scalar(planes, b, end, first, second);
+}
+
+#endif // MMUKO_SIMD_X86
+
+// ─────────────────────────────────────────────
+// DISPATCH
+// ─────────────────────────────────────────────
+
+// Widest last
+static const SimdKernels kernel_sets[] = {
+    { "scalar", mmuko_planes_entangle_scalar },
+#if MMUKO_SIMD_X86
+    { "avx2", entangle_avx2 },
+    { "avx512", entangle_avx512 },
+#endif
+};
+#define KERNEL_SET_COUNT (sizeof(kernel_sets) / sizeof(kernel_sets[0]))
+
+// Resolved on first use, possibly from several pool threads at once;
+// they all store the same pointer
+static _Atomic(const SimdKernels*) active_kernels;
+
+static bool kernels_supported(const SimdKernels* kernels) {
+#if MMUKO_SIMD_X86
+    if (strcmp(kernels->name, "avx2") == 0) return __builtin_cpu_supports("avx2");
+    if (strcmp(kernels->name, "avx512") == 0) {
+        return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw");
+    }
+#endif
+    return strcmp(kernels->name, "scalar") == 0;
+}
+
+static const SimdKernels* best_kernels(void) {
+    for (size_t k = KERNEL_SET_COUNT; k-- > 1;) {
+        if (kernels_supported(&kernel_sets[k])) return &kernel_sets[k];
+    }
+    return &kernel_sets[0];
+}
+
+static const SimdKernels* kernels(void) {
+    const SimdKernels* current = atomic_load_explicit(&active_kernels, memory_order_acquire);
+    if (!current) {
+        current = best_kernels();
+        atomic_store_explicit(&active_kernels, current, memory_order_release);
+    }
+    return current;
+}
+
+bool mmuko_simd_select(const char* name) {
+    if (strcmp(name, "auto") == 0) {
+        atomic_store(&active_kernels, best_kernels());
+        return true;
+    }
+    for (size_t k = 0; k < KERNEL_SET_COUNT; k++) {
+        if (strcmp(kernel_sets[k].name, name) == 0) {
+            if (!kernels_supported(&kernel_sets[k])) return false;
+            atomic_store(&active_kernels, &kernel_sets[k]);
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* mmuko_simd_name(void) {
+    return kernels()->name;
+}
+
+size_t mmuko_planes_entangle(MMUKO_Planes* planes, size_t begin, size_t end) {
+    uint8_t entangled = 0;
+    for (int i = 0; i < 8; i++) {
+        if (mmuko_entangled_pairs[i] != -1) entangled |= (uint8_t)(1u << i);
+    }
+    return kernels()->entangle(planes, begin, end, entangled & 0x0F, entangled & 0xF0);
+}
+
+// ============================================================
+// END OF MMUKO-SIMD.C
+// ============================================================
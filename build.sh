@@ -132,6 +132,10 @@ fi
 # ============================================================================
 print_status 4 6 "Assembling boot sector..."
 
+# Replace rather than overwrite: `make img` may have left a hard link into
+# the artifact cache at this path
+rm -f "${IMG_PATH}"
+
 if command -v ${ASM} &> /dev/null; then
     # Use NASM for proper assembly
     ${ASM} ${ASMFLAGS} -o ${IMG_PATH} ${SRC_DIR}/boot_sector.asm 2>/dev/null || {
@@ -271,6 +275,14 @@ if command -v ${CXX} &> /dev/null; then
     } || {
         print_warning "C++ RiftBridge compilation skipped"
     }
+    ${CXX} ${CXXFLAGS} -o ${BUILD_DIR}/rifttool \
+        ${CPP_DIR}/riftbridge.cpp ${CPP_DIR}/riftcrc.cpp ${CPP_DIR}/riftcache.cpp \
+        ${CPP_DIR}/riftio.cpp ${CPP_DIR}/riftaudit.cpp ${CPP_DIR}/riftscan.cpp ${CPP_DIR}/riftvm.cpp \
+        ${CPP_DIR}/riftfleet.cpp ${CPP_DIR}/riftstore.cpp ${CPP_DIR}/rifttool.cpp -pthread 2>/dev/null && {
+        print_success "C++ rifttool built (${BUILD_DIR}/rifttool)"
+    } || {
+        print_warning "C++ rifttool build skipped"
+    }
 else
     print_warning "C++ compiler not found"
 fi
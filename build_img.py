@@ -7,8 +7,79 @@ Creates a 512-byte bootable image with RIFT header and NSIGII verification
 import os
 import struct
 
-def create_boot_image(output_path="img/mmuko-os.img"):
-    """Create 512-byte boot sector image"""
+import rift_cache
+
+BUILDER_VERSION = "build_img.py/1"
+
+HEADER_FLAGS = 0x01
+
+LOAD_ADDRESS = 0x7C00
+BOOT_CODE_OFFSET = 8
+MSG_OFFSET = 0x60       # Boot message; `mov si` below is derived from it
+MSG_LIMIT = 0x1A0       # Device record, integrity record and partition table follow
+
+MSG_ADDRESS = LOAD_ADDRESS + MSG_OFFSET
+
+def rel8(source_end, target):
+    """Short-jump displacement from the end of the jump to target"""
+    displacement = target - source_end
+    assert -128 <= displacement <= 127, "short jump out of range"
+    return displacement & 0xFF
+
+# x86 Boot Code at offset 8, in pieces so the jumps below are derived
+SETUP = bytes([
+    0xFA,                   # cli
+    0x31, 0xC0,             # xor ax, ax
+    0x8E, 0xD8,             # mov ds, ax
+    0x8E, 0xC0,             # mov es, ax
+    0xBC, 0x00, 0x7C,       # mov sp, 0x7C00
+    # Print message
+    0xBE, MSG_ADDRESS & 0xFF, MSG_ADDRESS >> 8,     # mov si, msg
+])
+PRINT_TEST = bytes([
+    0xB4, 0x0E,             # mov ah, 0x0E (teletype)
+    0xAC,                   # lodsb
+    0x08, 0xC0,             # or al, al
+])
+PRINT_CHAR = bytes([
+    0xCD, 0x10,             # int 0x10
+])
+DONE = bytes([
+    # Done - NSIGII_YES
+    0xB0, 0x55,             # mov al, 0x55 (NSIGII_YES)
+    0xF4,                   # hlt
+    0xEB, 0xFE              # jmp $ (safety)
+])
+
+PRINT_LOOP = len(SETUP)                                 # label: print loop
+JZ_END = PRINT_LOOP + len(PRINT_TEST) + 2
+JMP_END = JZ_END + len(PRINT_CHAR) + 2
+DONE_LABEL = JMP_END                                    # label: done
+
+BOOT_CODE = (SETUP
+             + PRINT_TEST + bytes([0x74, rel8(JZ_END, DONE_LABEL)])     # jz done
+             + PRINT_CHAR + bytes([0xEB, rel8(JMP_END, PRINT_LOOP)])    # jmp loop
+             + DONE)
+
+# Boot message at MSG_OFFSET
+BOOT_MESSAGE = (b"=== MMUKO-OS RINGBOOT ===\r\n"
+                b"OBINEXUS NSIGII Verify\r\n"
+                b"[Phase 1] SPARSE\r\n"
+                b"[Phase 2] REMEMBER\r\n"
+                b"[Phase 3] ACTIVE\r\n"
+                b"[Phase 4] VERIFY\r\n\n"
+                b"NSIGII_VERIFIED\r\n"
+                b"BOOT_SUCCESS\r\n\x00")
+
+assert BOOT_CODE_OFFSET + len(BOOT_CODE) <= MSG_OFFSET, "boot code overlaps the message"
+assert MSG_OFFSET + len(BOOT_MESSAGE) <= MSG_LIMIT, "boot message overlaps the device record"
+
+def image_cache_key():
+    """Cache key over everything that shapes the sector"""
+    return rift_cache.cache_key(BUILDER_VERSION, BOOT_CODE, BOOT_MESSAGE, HEADER_FLAGS)
+
+def build_sector():
+    """Assemble the 512-byte boot sector"""
     
     # Initialize 512-byte sector
     sector = bytearray(512)
@@ -18,56 +89,42 @@ def create_boot_image(output_path="img/mmuko-os.img"):
     sector[4] = 0x01            # Version
     sector[5] = 0x00            # Reserved
     sector[6] = 0xFE            # Checksum
-    sector[7] = 0x01            # Flags
-    
-    # x86 Boot Code at offset 8
-    boot_code = bytes([
-        0xFA,                   # cli
-        0x31, 0xC0,             # xor ax, ax
-        0x8E, 0xD8,             # mov ds, ax
-        0x8E, 0xC0,             # mov es, ax
-        0xBC, 0x00, 0x7C,       # mov sp, 0x7C00
-        # Print message
-        0xBE, 0x60, 0x7C,       # mov si, msg (0x7C60)
-        0xB4, 0x0E,             # mov ah, 0x0E (teletype)
-        # Print loop
-        0xAC,                   # lodsb
-        0x08, 0xC0,             # or al, al
-        0x74, 0x04,             # jz done
-        0xCD, 0x10,             # int 0x10
-        0xEB, 0xF5,             # jmp loop
-        # Done - NSIGII_YES
-        0xB0, 0x55,             # mov al, 0x55 (NSIGII_YES)
-        0xF4,                   # hlt
-        0xEB, 0xFE              # jmp $ (safety)
-    ])
-    
-    sector[8:8+len(boot_code)] = boot_code
-    
-    # Boot message at offset 0x60 (96)
-    msg = (b"=== MMUKO-OS RINGBOOT ===\r\n"
-           b"OBINEXUS NSIGII Verify\r\n"
-           b"[Phase 1] SPARSE\r\n"
-           b"[Phase 2] REMEMBER\r\n"
-           b"[Phase 3] ACTIVE\r\n"
-           b"[Phase 4] VERIFY\r\n\n"
-           b"NSIGII_VERIFIED\r\n"
-           b"BOOT_SUCCESS\r\n\x00")
-    
-    sector[0x60:0x60+len(msg)] = msg
+    sector[7] = HEADER_FLAGS    # Flags
+    
+    sector[BOOT_CODE_OFFSET:BOOT_CODE_OFFSET+len(BOOT_CODE)] = BOOT_CODE
+    sector[MSG_OFFSET:MSG_OFFSET+len(BOOT_MESSAGE)] = BOOT_MESSAGE
     
     # Boot signature at offset 510
     sector[510] = 0x55
     sector[511] = 0xAA
     
+    return sector
+
+def create_boot_image(output_path="img/mmuko-os.img", cache_dir=None):
+    """Create 512-byte boot sector image, reusing a cached one when possible
+    
+    Returns (path, cache_hit).
+    """
+    
     # Create output directory
-    os.makedirs(os.path.dirname(output_path), exist_ok=True)
+    os.makedirs(os.path.dirname(output_path) or ".", exist_ok=True)
+    
+    key = image_cache_key()
+    if cache_dir and rift_cache.fetch(cache_dir, key, output_path):
+        return output_path, True
+    
+    # Replace rather than truncate: the old file may link into the cache
+    if os.path.exists(output_path):
+        os.unlink(output_path)
     
     # Write image
     with open(output_path, 'wb') as f:
-        f.write(sector)
+        f.write(build_sector())
+    
+    if cache_dir:
+        rift_cache.store(cache_dir, key, output_path)
     
-    return output_path
+    return output_path, False
 
 def verify_image(path):
     """Verify boot image integrity"""
@@ -105,24 +162,35 @@ def print_info(path):
     print(f"Checksum: 0x{data[6]:02X}")
     print(f"Boot Signature: 0x{data[510]:02X}{data[511]:02X}")
     
-    # Extract message
-    msg_end = data.find(b'\x00', 0x60)
-    if msg_end > 0x60:
-        msg = data[0x60:msg_end].decode('ascii', errors='replace')
-        print(f"\nBoot Message:\n{msg}")
+    # Extract message from wherever the `mov si, imm16` (0xBE) points
+    mov_si = data.find(b'\xBE', BOOT_CODE_OFFSET)
+    if 0 <= mov_si < len(data) - 2:
+        msg_start = (data[mov_si+1] | data[mov_si+2] << 8) - LOAD_ADDRESS
+        msg_end = data.find(b'\x00', msg_start)
+        if 0 <= msg_start < msg_end:
+            msg = data[msg_start:msg_end].decode('ascii', errors='replace')
+            print(f"\nBoot Message:\n{msg}")
 
 if __name__ == "__main__":
+    import argparse
     import sys
     
-    output = sys.argv[1] if len(sys.argv) > 1 else "img/mmuko-os.img"
+    parser = argparse.ArgumentParser(description="MMUKO-OS boot image generator")
+    parser.add_argument("output", nargs="?", default="img/mmuko-os.img")
+    parser.add_argument("--cache-dir", help="reuse/store images in this artifact cache")
+    args = parser.parse_args()
+    output = args.output
     
     print("=== MMUKO-OS Boot Image Generator ===")
     print(f"Creating: {output}")
     
-    create_boot_image(output)
+    _, cache_hit = create_boot_image(output, args.cache_dir)
     
     if verify_image(output):
-        print(f"✓ Boot image created successfully")
+        if cache_hit:
+            print(f"✓ Boot image reused from cache ({args.cache_dir})")
+        else:
+            print(f"✓ Boot image created successfully")
         print()
         print_info(output)
     else:
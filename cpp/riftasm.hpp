@@ -0,0 +1,201 @@
+/*
+ * riftasm.hpp - MMUKO-OS Compile-Time Real-Mode Assembler
+ *
+ * A constexpr assembler for the handful of 16-bit instructions the RIFT boot
+ * sector uses, with forward/backward label resolution. Programs assemble into
+ * a std::array during constant evaluation, so offsets and jump displacements
+ * are computed by the compiler and checked with static_assert
+ */
+
+#ifndef RIFTASM_HPP
+#define RIFTASM_HPP
+
+#include <array>
+#include <cstdint>
+#include <cstddef>
+
+namespace mmuko {
+namespace asm16 {
+
+// ============================================================================
+// Operands
+// ============================================================================
+
+enum class Reg8 : uint8_t { AL = 0, CL, DL, BL, AH, CH, DH, BH };
+enum class Reg16 : uint8_t { AX = 0, CX, DX, BX, SP, BP, SI, DI };
+enum class SReg : uint8_t { ES = 0, CS, SS, DS };
+
+using Label = uint8_t;
+
+// ============================================================================
+// Assembler
+// ============================================================================
+
+// N output bytes, loaded at `base` (0x7C00 for a boot sector). Errors (an
+// overflow, an undefined label, a short jump out of range, a label reference
+// cut off by the end of the output) set failed()
+// instead of throwing, so callers static_assert(!a.failed())
+template <size_t N, size_t MaxLabels = 16, size_t MaxFixups = 32>
+class Assembler {
+public:
+    constexpr explicit Assembler(uint16_t base = 0x7C00) : base_(base) {}
+
+    // ------------------------------------------------------------------------
+    // Layout
+    // ------------------------------------------------------------------------
+
+    constexpr Assembler& label(Label id) {
+        if (id >= MaxLabels || defined_[id]) return fail();
+        labels_[id] = pos_;
+        defined_[id] = true;
+        return *this;
+    }
+
+    // Move to an absolute offset; moving backwards over code is an error
+    constexpr Assembler& org(size_t offset) {
+        if (offset < pos_ || offset > N) return fail();
+        pos_ = offset;
+        return *this;
+    }
+
+    constexpr Assembler& db(uint8_t byte) {
+        if (pos_ >= N) return fail();
+        out_[pos_++] = byte;
+        return *this;
+    }
+
+    constexpr Assembler& dw(uint16_t word) {
+        return db(static_cast<uint8_t>(word)).db(static_cast<uint8_t>(word >> 8));
+    }
+
+    // NUL-terminated string
+    constexpr Assembler& asciz(const char* text) {
+        while (*text != '\0') db(static_cast<uint8_t>(*text++));
+        return db(0x00);
+    }
+
+    // ------------------------------------------------------------------------
+    // Instructions
+    // ------------------------------------------------------------------------
+
+    constexpr Assembler& cli() { return db(0xFA); }
+    constexpr Assembler& hlt() { return db(0xF4); }
+    constexpr Assembler& lodsb() { return db(0xAC); }
+
+    // xor r/m16, r16
+    constexpr Assembler& xor_(Reg16 dst, Reg16 src) { return db(0x31).db(modrm(src, dst)); }
+
+    // or r/m8, r8
+    constexpr Assembler& or_(Reg8 dst, Reg8 src) { return db(0x08).db(modrm(src, dst)); }
+
+    // mov sreg, r/m16
+    constexpr Assembler& mov(SReg dst, Reg16 src) { return db(0x8E).db(modrm(dst, src)); }
+
+    // mov r8, imm8 / mov r16, imm16
+    constexpr Assembler& mov(Reg8 dst, uint8_t imm) {
+        return db(static_cast<uint8_t>(0xB0 + static_cast<uint8_t>(dst))).db(imm);
+    }
+    constexpr Assembler& mov(Reg16 dst, uint16_t imm) {
+        return db(static_cast<uint8_t>(0xB8 + static_cast<uint8_t>(dst))).dw(imm);
+    }
+
+    // mov r16, <address of label>
+    constexpr Assembler& movAddress(Reg16 dst, Label target) {
+        db(static_cast<uint8_t>(0xB8 + static_cast<uint8_t>(dst)));
+        addFixup(target, Fixup::ABS16);
+        return dw(0);
+    }
+
+    constexpr Assembler& int_(uint8_t vector) { return db(0xCD).db(vector); }
+
+    // Short jumps (rel8)
+    constexpr Assembler& jmp(Label target) { return jumpShort(0xEB, target); }
+    constexpr Assembler& jz(Label target) { return jumpShort(0x74, target); }
+    constexpr Assembler& jnz(Label target) { return jumpShort(0x75, target); }
+
+    // ------------------------------------------------------------------------
+    // Results
+    // ------------------------------------------------------------------------
+
+    // Resolve every label reference; call once after the last instruction
+    constexpr std::array<uint8_t, N> finish() {
+        for (size_t i = 0; i < fixup_count_; i++) {
+            const Fixup& f = fixups_[i];
+            if (!defined_[f.target]) {
+                fail();
+                continue;
+            }
+            // A reference emitted past the end has no bytes to patch
+            if (f.at + (f.kind == Fixup::ABS16 ? 2 : 1) > N) {
+                fail();
+                continue;
+            }
+            size_t target = labels_[f.target];
+            if (f.kind == Fixup::ABS16) {
+                size_t address = base_ + target;
+                if (address > 0xFFFF) fail();
+                out_[f.at] = static_cast<uint8_t>(address);
+                out_[f.at + 1] = static_cast<uint8_t>(address >> 8);
+            } else {
+                long rel = static_cast<long>(target) - static_cast<long>(f.at + 1);
+                if (rel < -128 || rel > 127) fail();
+                out_[f.at] = static_cast<uint8_t>(rel & 0xFF);
+            }
+        }
+        return out_;
+    }
+
+    constexpr bool failed() const { return failed_; }
+    constexpr size_t position() const { return pos_; }
+
+    // Offset of a defined label (N if undefined)
+    constexpr size_t offsetOf(Label id) const {
+        return id < MaxLabels && defined_[id] ? labels_[id] : N;
+    }
+
+private:
+    struct Fixup {
+        enum Kind : uint8_t { REL8, ABS16 };
+        size_t at;
+        Label target;
+        Kind kind;
+    };
+
+    std::array<uint8_t, N> out_{};
+    std::array<size_t, MaxLabels> labels_{};
+    std::array<bool, MaxLabels> defined_{};
+    std::array<Fixup, MaxFixups> fixups_{};
+    size_t fixup_count_ = 0;
+    size_t pos_ = 0;
+    uint16_t base_;
+    bool failed_ = false;
+
+    template <typename Reg, typename RM>
+    static constexpr uint8_t modrm(Reg reg, RM rm) {
+        return static_cast<uint8_t>(0xC0 | static_cast<uint8_t>(reg) << 3 | static_cast<uint8_t>(rm));
+    }
+
+    constexpr Assembler& fail() {
+        failed_ = true;
+        return *this;
+    }
+
+    constexpr void addFixup(Label target, typename Fixup::Kind kind) {
+        if (target >= MaxLabels || fixup_count_ >= MaxFixups) {
+            fail();
+            return;
+        }
+        fixups_[fixup_count_++] = Fixup{pos_, target, kind};
+    }
+
+    constexpr Assembler& jumpShort(uint8_t opcode, Label target) {
+        db(opcode);
+        addFixup(target, Fixup::REL8);
+        return db(0);
+    }
+};
+
+} // namespace asm16
+} // namespace mmuko
+
+#endif // RIFTASM_HPP
@@ -0,0 +1,154 @@
+/*
+ * riftaudit.cpp - MMUKO-OS Fleet Image Auditor Implementation
+ */
+
+#include "riftaudit.hpp"
+#include <algorithm>
+#include <filesystem>
+#include <mutex>
+#include <system_error>
+
+namespace mmuko {
+
+namespace {
+
+// Volumes are split into batches this large so workers can drop pages behind them
+constexpr size_t VOLUME_BATCH_BYTES = 8u << 20;
+constexpr size_t FILE_BATCH = 64;
+
+void mergeReport(AuditReport& into, const AuditReport& from) {
+    into.images_checked += from.images_checked;
+    into.bytes_scanned += from.bytes_scanned;
+    into.bad.insert(into.bad.end(), from.bad.begin(), from.bad.end());
+}
+
+// Bytes inspect() reads from an image of `len` bytes: the sector, plus the
+// payload sectors it checksums when they are all there
+uint64_t inspectedBytes(const uint8_t* image, size_t len) {
+    if (len < BootImage::SECTOR_SIZE) return 0;
+    size_t need = BootImage::imageLength(image);
+    return need <= len ? need : BootImage::SECTOR_SIZE;
+}
+
+void sortFindings(AuditReport& report) {
+    std::sort(report.bad.begin(), report.bad.end(),
+              [](const AuditFinding& a, const AuditFinding& b) {
+                  return a.path != b.path ? a.path < b.path : a.offset < b.offset;
+              });
+}
+
+} // namespace
+
+// ============================================================================
+// FleetAuditor Implementation
+// ============================================================================
+
+FleetAuditor::FleetAuditor(unsigned threads)
+    : pool_(threads) {
+}
+
+AuditReport FleetAuditor::auditFiles(const std::vector<std::string>& paths) {
+    AuditReport report;
+    std::mutex merge_mutex;
+
+    pool_.parallelFor(paths.size(), FILE_BATCH, [&](size_t begin, size_t end) {
+        AuditReport local;
+        MappedFile file;
+
+        for (size_t i = begin; i < end; i++) {
+            local.images_checked++;
+
+            if (!file.open(paths[i], MappedFile::Access::RANDOM)) {
+                local.bad.push_back({paths[i], 0, AuditError::UNREADABLE, ImageStatus::OK});
+                continue;
+            }
+
+            ImageStatus status = BootImage::inspect(file.data(), file.size());
+            local.bytes_scanned += inspectedBytes(file.data(), file.size());
+            if (status != ImageStatus::OK) {
+                local.bad.push_back({paths[i], 0, AuditError::NONE, status});
+            }
+            file.close();
+        }
+
+        std::lock_guard<std::mutex> lock(merge_mutex);
+        mergeReport(report, local);
+    });
+
+    sortFindings(report);
+    return report;
+}
+
+AuditReport FleetAuditor::auditVolume(const std::string& path, size_t stride) {
+    AuditReport report;
+
+    if (stride < BootImage::SECTOR_SIZE) {
+        report.bad.push_back({path, 0, AuditError::BAD_STRIDE, ImageStatus::OK});
+        return report;
+    }
+
+    MappedFile volume;
+    if (!volume.open(path, MappedFile::Access::SEQUENTIAL)) {
+        report.bad.push_back({path, 0, AuditError::UNREADABLE, ImageStatus::OK});
+        return report;
+    }
+
+    const uint8_t* base = volume.data();
+    size_t images = volume.size() / stride;
+    size_t per_batch = std::max<size_t>(1, VOLUME_BATCH_BYTES / stride);
+    std::mutex merge_mutex;
+
+    pool_.parallelFor(images, per_batch, [&](size_t begin, size_t end) {
+        AuditReport local;
+
+        for (size_t i = begin; i < end; i++) {
+            uint64_t offset = static_cast<uint64_t>(i) * stride;
+            ImageStatus status = BootImage::inspect(base + offset, stride);
+            local.bytes_scanned += inspectedBytes(base + offset, stride);
+            if (status != ImageStatus::OK) {
+                local.bad.push_back({path, offset, AuditError::NONE, status});
+            }
+        }
+        local.images_checked = end - begin;
+
+        // Checked pages will not be revisited; keep the resident set bounded
+        volume.release(begin * stride, (end - begin) * stride);
+
+        std::lock_guard<std::mutex> lock(merge_mutex);
+        mergeReport(report, local);
+    });
+
+    // A partial image at the end of the volume cannot be valid
+    size_t tail = volume.size() % stride;
+    if (tail != 0) {
+        report.images_checked++;
+        report.bad.push_back({path, static_cast<uint64_t>(images) * stride, AuditError::NONE,
+                              ImageStatus::TRUNCATED});
+    }
+
+    sortFindings(report);
+    return report;
+}
+
+std::vector<std::string> FleetAuditor::collectImages(const std::vector<std::string>& roots) {
+    namespace fs = std::filesystem;
+    std::vector<std::string> files;
+
+    for (const auto& root : roots) {
+        std::error_code ec;
+        if (!fs::is_directory(root, ec)) {
+            files.push_back(root);
+            continue;
+        }
+
+        for (fs::recursive_directory_iterator it(root, ec), end; !ec && it != end; it.increment(ec)) {
+            if (it->is_regular_file(ec)) {
+                files.push_back(it->path().string());
+            }
+        }
+    }
+
+    return files;
+}
+
+} // namespace mmuko
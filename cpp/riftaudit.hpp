@@ -0,0 +1,71 @@
+/*
+ * riftaudit.hpp - MMUKO-OS Fleet Image Auditor
+ *
+ * Bulk BootImage verification over image stores and concatenated volumes:
+ * files are mmap'd instead of copied through std::ifstream, and checks run
+ * on a thread pool
+ */
+
+#ifndef RIFTAUDIT_HPP
+#define RIFTAUDIT_HPP
+
+#include "riftbridge.hpp"
+#include "riftio.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace mmuko {
+
+// ============================================================================
+// Audit Results
+// ============================================================================
+
+enum class AuditError : uint8_t {
+    NONE            = 0,    // The image was inspected and failed with `status`
+    UNREADABLE      = 1,    // The file or device could not be opened or mapped
+    BAD_STRIDE      = 2     // Volume stride shorter than one sector
+};
+
+struct AuditFinding {
+    std::string path;
+    uint64_t offset;            // Image start within the file (volumes)
+    AuditError error;
+    ImageStatus status;         // Meaningful when error is NONE
+};
+
+struct AuditReport {
+    uint64_t images_checked;
+    uint64_t bytes_scanned;     // Read and checked: sectors and checksummed payloads
+    std::vector<AuditFinding> bad;
+
+    AuditReport() : images_checked(0), bytes_scanned(0) {}
+};
+
+// ============================================================================
+// Fleet Auditor
+// ============================================================================
+
+class FleetAuditor {
+public:
+    // threads == 0 selects one worker per hardware thread
+    explicit FleetAuditor(unsigned threads = 0);
+
+    // One boot image per file
+    AuditReport auditFiles(const std::vector<std::string>& paths);
+
+    // One file holding back-to-back images of `stride` bytes each
+    AuditReport auditVolume(const std::string& path, size_t stride = BootImage::SECTOR_SIZE);
+
+    // Expand directories (recursively) into the regular files below them
+    static std::vector<std::string> collectImages(const std::vector<std::string>& roots);
+
+    unsigned getThreadCount() const { return pool_.size(); }
+
+private:
+    ThreadPool pool_;
+};
+
+} // namespace mmuko
+
+#endif // RIFTAUDIT_HPP
@@ -5,9 +5,19 @@
  */
 
 #include "riftbridge.hpp"
+#include "riftcrc.hpp"
+#include "riftcache.hpp"
+#include "riftasm.hpp"
+#include "riftio.hpp"
 #include <iostream>
 #include <fstream>
 #include <cstring>
+#include <cstdlib>
+#include <algorithm>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
 
 namespace mmuko {
 
@@ -218,88 +228,388 @@ NSIGIIState RingBootMachine::verify(const std::vector<Qubit>& qubits) {
 }
 
 // ============================================================================
-// RIFT Header Implementation
+// BootImage Implementation
 // ============================================================================
 
-RIFTHeader::RIFTHeader() {
-    magic[0] = 'R';
-    magic[1] = 'I';
-    magic[2] = 'F';
-    magic[3] = 'T';
-    version = 0x01;
-    reserved = 0x00;
-    checksum = 0xFE;
-    flags = 0x01;
+BootImage::BootImage()
+    : disk_size_(0),
+      custom_boot_sector_(false),
+      integrity_(false) {
+    data_.resize(SECTOR_SIZE, 0);
 }
 
-bool RIFTHeader::isValid() const {
-    return magic[0] == 'R' && magic[1] == 'I' &&
-           magic[2] == 'F' && magic[3] == 'T' &&
-           version == 0x01 && checksum == 0xFE;
-}
+namespace {
 
-uint8_t RIFTHeader::calculateChecksum() const {
-    return magic[0] ^ magic[1] ^ magic[2] ^ magic[3] ^ 
-           version ^ reserved ^ flags;
+// Hashed into every cache key. Bump it with every change to the image
+// format (boot code, integrity record, device record, disk layout), so
+// images cached by an older builder are never served
+constexpr const char* BUILDER_VERSION = "riftbridge/1";
+
+size_t sectorsFor(size_t bytes) {
+    return (bytes + BootImage::SECTOR_SIZE - 1) / BootImage::SECTOR_SIZE;
 }
 
 // ============================================================================
-// BootImage Implementation
+// Built-in Boot Sector (assembled at compile time)
 // ============================================================================
 
-BootImage::BootImage() {
-    data_.resize(SECTOR_SIZE, 0);
+constexpr const char* BOOT_MESSAGE = "MMUKO-OS RINGBOOT\r\nNSIGII_VERIFIED\r\n";
+
+enum BootLabel : asm16::Label { PRINT, DONE, HANG, MSG, MSG_END };
+
+struct AssembledSector {
+    std::array<uint8_t, BootImage::SECTOR_SIZE> bytes;
+    bool failed;
+    size_t message_offset;
+    size_t message_end;
+};
+
+constexpr AssembledSector assembleBootSector() {
+    using namespace asm16;
+    
+    constexpr RIFTHeader header;
+    Assembler<BootImage::SECTOR_SIZE> a;
+    
+    // RIFT header; executes as harmless code on the way into offset 8
+    a.db(header.magic[0]).db(header.magic[1]).db(header.magic[2]).db(header.magic[3])
+     .db(header.version).db(header.reserved).db(header.checksum).db(header.flags);
+    
+    a.cli()
+     .xor_(Reg16::AX, Reg16::AX)
+     .mov(SReg::DS, Reg16::AX)
+     .mov(SReg::ES, Reg16::AX)
+     .mov(Reg16::SP, 0x7C00)
+     .movAddress(Reg16::SI, MSG)
+    .label(PRINT)
+     .mov(Reg8::AH, 0x0E)               // BIOS teletype; reloaded per character
+     .lodsb()
+     .or_(Reg8::AL, Reg8::AL)
+     .jz(DONE)
+     .int_(0x10)
+     .jmp(PRINT)
+    .label(DONE)
+     .mov(Reg8::AL, 0x55)               // NSIGII_YES
+     .hlt()
+    .label(HANG)
+     .jmp(HANG)
+    .label(MSG)
+     .asciz(BOOT_MESSAGE)
+    .label(MSG_END)
+     .org(BootImage::BOOT_SIG_OFFSET)
+     .db(0x55).db(0xAA);
+    
+    AssembledSector sector{a.finish(), false, a.offsetOf(MSG), a.offsetOf(MSG_END)};
+    sector.failed = a.failed();
+    return sector;
+}
+
+constexpr AssembledSector BOOT_SECTOR = assembleBootSector();
+
+constexpr RIFTHeader headerOf(const std::array<uint8_t, BootImage::SECTOR_SIZE>& bytes) {
+    RIFTHeader header;
+    for (size_t i = 0; i < 4; i++) header.magic[i] = bytes[i];
+    header.version = bytes[4];
+    header.reserved = bytes[5];
+    header.checksum = bytes[6];
+    header.flags = bytes[7];
+    return header;
+}
+
+static_assert(!BOOT_SECTOR.failed, "boot sector failed to assemble");
+static_assert(BOOT_SECTOR.bytes.size() == BootImage::SECTOR_SIZE, "boot sector must be one sector");
+static_assert(BOOT_SECTOR.bytes[BootImage::BOOT_SIG_OFFSET] == 0x55 &&
+              BOOT_SECTOR.bytes[BootImage::BOOT_SIG_OFFSET + 1] == 0xAA,
+              "boot sector is missing the 0x55AA signature");
+static_assert(headerOf(BOOT_SECTOR.bytes).isValid(), "boot sector RIFT header is invalid");
+static_assert(RIFTHeader::executableFlags(headerOf(BOOT_SECTOR.bytes).flags) &&
+              RIFTHeader::executableFlags(headerOf(BOOT_SECTOR.bytes).flags | RIFTHeader::FLAG_CRC32C),
+              "header flags would not decode as a two-byte instruction");
+static_assert(BOOT_SECTOR.message_end <= BootImage::DEVICE_RECORD_OFFSET,
+              "boot message runs into the device record");
+
+} // namespace
+
+const std::array<uint8_t, BootImage::SECTOR_SIZE>& BootImage::bootSector() {
+    return BOOT_SECTOR.bytes;
+}
+
+void BootImage::writeBootSector() {
+    if (custom_boot_sector_) {
+        std::copy(boot_sector_.begin(), boot_sector_.end(), data_.begin());
+    } else {
+        std::copy(BOOT_SECTOR.bytes.begin(), BOOT_SECTOR.bytes.end(), data_.begin());
+    }
+}
+
+bool BootImage::hasCustomPartitionTable() const {
+    if (!custom_boot_sector_) return false;
+    
+    const uint8_t* table = boot_sector_.data() + PARTITION_TABLE_OFFSET;
+    return std::any_of(table, table + MAX_PARTITIONS * PartitionEntry::ENTRY_SIZE,
+                       [](uint8_t b) { return b != 0; });
 }
 
-void BootImage::writeRIFTHeader() {
+bool BootImage::hasCustomIntegrityArea() const {
+    if (!custom_boot_sector_) return false;
+    
     RIFTHeader header;
-    std::memcpy(data_.data(), &header, sizeof(header));
+    std::memcpy(&header, boot_sector_.data(), sizeof(header));
+    if (header.isValid() && (header.flags & RIFTHeader::FLAG_CRC32C) != 0) return false;
+    
+    const uint8_t* record = boot_sector_.data() + INTEGRITY_OFFSET;
+    return std::any_of(record, record + INTEGRITY_SIZE, [](uint8_t b) { return b != 0; });
+}
+
+bool BootImage::writePartitionTable() {
+    if (partitions_.empty()) return true;
+    if (hasCustomPartitionTable()) return false;
+    
+    uint8_t* table = data_.data() + PARTITION_TABLE_OFFSET;
+    std::memset(table, 0, MAX_PARTITIONS * PartitionEntry::ENTRY_SIZE);
+    
+    for (size_t i = 0; i < partitions_.size(); i++) {
+        const PartitionEntry& p = partitions_[i];
+        uint8_t* entry = table + i * PartitionEntry::ENTRY_SIZE;
+        
+        // CHS fields carry the LBA-only marker; firmware uses the LBA pair
+        entry[0] = p.status;
+        entry[1] = 0xFE; entry[2] = 0xFF; entry[3] = 0xFF;
+        entry[4] = p.type;
+        entry[5] = 0xFE; entry[6] = 0xFF; entry[7] = 0xFF;
+        putLE32(entry + 8, p.lba_start);
+        putLE32(entry + 12, p.sector_count);
+    }
+    return true;
+}
+
+bool BootImage::setBootSector(const std::vector<uint8_t>& sector) {
+    if (sector.size() != SECTOR_SIZE) return false;
+    
+    data_ = sector;
+    boot_sector_ = sector;
+    custom_boot_sector_ = true;
+    return true;
+}
+
+bool BootImage::loadBootSector(const std::string& filename) {
+    std::vector<uint8_t> bytes;
+    if (!readFile(filename, bytes) || bytes.size() < SECTOR_SIZE) return false;
+    
+    // Linked boot sectors may carry trailing bytes past 0x55AA (see build-direct.ps1)
+    bytes.resize(SECTOR_SIZE);
+    return setBootSector(bytes);
+}
+
+bool BootImage::setPayload(const std::vector<uint8_t>& payload) {
+    if (payload.size() > static_cast<size_t>(KERNEL_SECTORS) * SECTOR_SIZE) {
+        return false;   // boot16.s only reads KERNEL_SECTORS sectors
+    }
+    
+    payload_ = payload;
+    return true;
+}
+
+bool BootImage::loadPayload(const std::string& filename) {
+    std::vector<uint8_t> bytes;
+    if (!readFile(filename, bytes)) return false;
+    return setPayload(bytes);
 }
 
-void BootImage::writeBootCode() {
-    // Minimal x86 boot code
-    uint8_t boot_code[] = {
-        0xFA,                   // cli
-        0x31, 0xC0,             // xor ax, ax
-        0x8E, 0xD8,             // mov ds, ax
-        0x8E, 0xC0,             // mov es, ax
-        0xBC, 0x00, 0x7C,       // mov sp, 0x7C00
-        0xBE, 0x20, 0x7C,       // mov si, msg
-        0xB4, 0x0E,             // mov ah, 0x0E
-        // Print loop
-        0xAC,                   // lodsb
-        0x08, 0xC0,             // or al, al
-        0x74, 0x04,             // jz done
-        0xCD, 0x10,             // int 0x10
-        0xEB, 0xF5,             // jmp loop
-        // Done
-        0xB0, 0x55,             // mov al, 0x55 (NSIGII_YES)
-        0xF4,                   // hlt
-        0xEB, 0xFE              // jmp $
+bool BootImage::addPartition(const PartitionEntry& entry) {
+    if (partitions_.size() >= MAX_PARTITIONS || entry.sector_count == 0) {
+        return false;
+    }
+    
+    uint64_t start = entry.lba_start;
+    uint64_t end = start + entry.sector_count;
+    if (end > 0xFFFFFFFFull + 1) return false;
+    
+    // Keep clear of the MBR and the kernel area boot16.s loads from
+    if (start < KERNEL_LBA + KERNEL_SECTORS) return false;
+    
+    for (const auto& p : partitions_) {
+        uint64_t p_start = p.lba_start;
+        uint64_t p_end = p_start + p.sector_count;
+        if (start < p_end && p_start < end) return false;
+    }
+    
+    partitions_.push_back(entry);
+    return true;
+}
+
+bool BootImage::setDiskSize(uint64_t bytes) {
+    if (bytes % SECTOR_SIZE != 0) {
+        bytes += SECTOR_SIZE - bytes % SECTOR_SIZE;
+    }
+    if (bytes < SECTOR_SIZE) return false;
+    
+    disk_size_ = bytes;
+    return true;
+}
+
+uint64_t BootImage::getMinimumDiskSize() const {
+    uint64_t size = SECTOR_SIZE;
+    
+    if (!payload_.empty()) {
+        // boot16.s reads the full kernel area, so it must exist on disk
+        size = static_cast<uint64_t>(KERNEL_LBA + KERNEL_SECTORS) * SECTOR_SIZE;
+    }
+    
+    for (const auto& p : partitions_) {
+        uint64_t end = (static_cast<uint64_t>(p.lba_start) + p.sector_count) * SECTOR_SIZE;
+        size = std::max(size, end);
+    }
+    
+    return size;
+}
+
+uint64_t BootImage::getDiskSize() const {
+    return disk_size_ != 0 ? disk_size_ : getMinimumDiskSize();
+}
+
+bool BootImage::writeDisk(const std::string& filename) const {
+    uint64_t disk_size = getDiskSize();
+    if (disk_size < getMinimumDiskSize()) return false;
+    
+    const uint64_t payload_offset = static_cast<uint64_t>(KERNEL_LBA) * SECTOR_SIZE;
+    
+#ifndef _WIN32
+    int fd = createReplacing(filename);
+    if (fd < 0) return false;
+    
+    auto writeAt = [fd](const uint8_t* p, size_t len, uint64_t offset) {
+        return writeAll(fd, p, len, offset);
     };
+#else
+    std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+    if (!file) return false;
     
-    std::memcpy(data_.data() + 8, boot_code, sizeof(boot_code));
+    auto writeAt = [&file](const uint8_t* p, size_t len, uint64_t offset) {
+        file.seekp(static_cast<std::streamoff>(offset));
+        file.write(reinterpret_cast<const char*>(p), static_cast<std::streamsize>(len));
+        return file.good();
+    };
+#endif
+    
+    bool ok = writeAt(data_.data(), SECTOR_SIZE, 0);
+    uint64_t written_end = SECTOR_SIZE;     // Highest byte written so far
+    
+    // Write only the non-zero sector runs of the payload; zero runs stay holes
+    size_t pos = 0;
+    while (ok && pos < payload_.size()) {
+        size_t len = std::min(SECTOR_SIZE, payload_.size() - pos);
+        if (isZero(payload_.data() + pos, len)) {
+            pos += len;
+            continue;
+        }
+        
+        size_t run = pos;
+        while (run < payload_.size()) {
+            size_t run_len = std::min(SECTOR_SIZE, payload_.size() - run);
+            if (isZero(payload_.data() + run, run_len)) break;
+            run += run_len;
+        }
+        
+        ok = writeAt(payload_.data() + pos, run - pos, payload_offset + pos);
+        written_end = payload_offset + run;
+        pos = run;
+    }
+    
+#ifndef _WIN32
+    // Extend to the full disk size; everything past written_end is a hole
+    (void)written_end;
+    if (ok && ::ftruncate(fd, static_cast<off_t>(disk_size)) != 0) {
+        ok = false;
+    }
+    if (::close(fd) != 0) {
+        ok = false;
+    }
+#else
+    if (ok && disk_size > written_end) {
+        static const uint8_t last = 0;
+        ok = writeAt(&last, 1, disk_size - 1);
+    }
+#endif
+    
+    return ok;
+}
+
+uint32_t BootImage::integrityChecksum(const uint8_t* sector, const uint8_t* payload,
+                                      size_t payload_sectors) {
+    static const uint8_t zero_crc[4] = {0, 0, 0, 0};
     
-    // Boot message
-    const char* msg = "MMUKO-OS RINGBOOT\r\nNSIGII_VERIFIED\r\n";
-    std::memcpy(data_.data() + 0x20, msg, std::strlen(msg));
+    uint32_t crc = crc32c::update(0, sector, INTEGRITY_OFFSET);
+    crc = crc32c::update(crc, zero_crc, sizeof(zero_crc));
+    crc = crc32c::update(crc, sector + INTEGRITY_OFFSET + 4,
+                         SECTOR_SIZE - INTEGRITY_OFFSET - 4);
+    return crc32c::update(crc, payload, payload_sectors * SECTOR_SIZE);
 }
 
-void BootImage::writeSignature() {
-    data_[BOOT_SIG_OFFSET] = 0x55;
-    data_[BOOT_SIG_OFFSET + 1] = 0xAA;
+bool BootImage::writeIntegrity() {
+    RIFTHeader header;
+    std::memcpy(&header, data_.data(), sizeof(header));
+    if (!header.isValid()) {
+        return false;   // Only RIFT sectors carry the flag and record
+    }
+    if (hasCustomIntegrityArea()) return false;
+    
+    header.flags |= RIFTHeader::FLAG_CRC32C;
+    std::memcpy(data_.data(), &header, sizeof(header));
+    
+    size_t payload_sectors = sectorsFor(payload_.size());
+    std::vector<uint8_t> padded(payload_);
+    padded.resize(payload_sectors * SECTOR_SIZE, 0);
+    
+    uint8_t* record = data_.data() + INTEGRITY_OFFSET;
+    std::memset(record, 0, INTEGRITY_SIZE);
+    putLE16(record + 4, static_cast<uint16_t>(payload_sectors));
+    putLE32(record, integrityChecksum(data_.data(), padded.data(), payload_sectors));
+    return true;
 }
 
 bool BootImage::generate(const std::string& filename) {
-    writeRIFTHeader();
-    writeBootCode();
-    writeSignature();
+    // Start from the unedited sector, so repeated builds match
+    writeBootSector();
+    if (!writePartitionTable()) {
+        return false;
+    }
     
-    std::ofstream file(filename, std::ios::binary);
-    if (!file) return false;
+    if (integrity_ && !writeIntegrity()) {
+        return false;
+    }
     
-    file.write(reinterpret_cast<const char*>(data_.data()), data_.size());
-    return file.good();
+    return writeDisk(filename);
+}
+
+bool BootImage::generate(const std::string& filename, const ArtifactCache& cache, bool* hit) {
+    std::string key = cacheKey();
+    bool cached = cache.fetch(key, filename);
+    if (hit) *hit = cached;
+    if (cached) return true;
+    
+    if (!generate(filename)) return false;
+    cache.store(key, filename);     // A failed store only costs the next build
+    return true;
+}
+
+std::string BootImage::cacheKey() const {
+    CacheKey key;
+    key.add(BUILDER_VERSION);
+    
+    if (custom_boot_sector_) {
+        key.add(boot_sector_.data(), boot_sector_.size());
+    } else {
+        key.add(BOOT_SECTOR.bytes.data(), BOOT_SECTOR.bytes.size());
+    }
+    
+    key.add(static_cast<uint64_t>(integrity_));
+    key.add(payload_.data(), payload_.size());
+    for (const auto& entry : partitions_) {
+        key.add(static_cast<uint64_t>(entry.status) << 8 | entry.type);
+        key.add(static_cast<uint64_t>(entry.lba_start) << 32 | entry.sector_count);
+    }
+    key.add(getDiskSize());
+    return key.finish();
 }
 
 bool BootImage::load(const std::string& filename) {
@@ -307,19 +617,87 @@ bool BootImage::load(const std::string& filename) {
     if (!file) return false;
     
     file.read(reinterpret_cast<char*>(data_.data()), data_.size());
-    return file.good();
+    if (!file.good()) return false;
+    
+    // Integrity-mode images carry their payload sectors in the checksum
+    RIFTHeader header;
+    std::memcpy(&header, data_.data(), sizeof(header));
+    integrity_ = header.isValid() && (header.flags & RIFTHeader::FLAG_CRC32C) != 0;
+    payload_.clear();
+    
+    if (integrity_) {
+        size_t payload_sectors = getLE16(data_.data() + INTEGRITY_OFFSET + 4);
+        payload_.resize(payload_sectors * SECTOR_SIZE);
+        file.read(reinterpret_cast<char*>(payload_.data()),
+                  static_cast<std::streamsize>(payload_.size()));
+        if (static_cast<size_t>(file.gcount()) != payload_.size()) {
+            payload_.resize(static_cast<size_t>(file.gcount()));
+        }
+    }
+    
+    return true;
 }
 
-bool BootImage::verify() const {
+ImageStatus BootImage::inspectSector(const uint8_t* sector, const uint8_t* payload,
+                                     size_t payload_len) {
     // Check boot signature
-    if (data_[BOOT_SIG_OFFSET] != 0x55 || data_[BOOT_SIG_OFFSET + 1] != 0xAA) {
-        return false;
+    if (sector[BOOT_SIG_OFFSET] != 0x55 || sector[BOOT_SIG_OFFSET + 1] != 0xAA) {
+        return ImageStatus::BAD_SIGNATURE;
     }
     
     // Check RIFT header
     RIFTHeader header;
-    std::memcpy(&header, data_.data(), sizeof(header));
-    return header.isValid();
+    std::memcpy(&header, sector, sizeof(header));
+    if (!header.isValid()) {
+        return ImageStatus::BAD_HEADER;
+    }
+    
+    // Check the integrity record
+    if ((header.flags & RIFTHeader::FLAG_CRC32C) != 0) {
+        const uint8_t* record = sector + INTEGRITY_OFFSET;
+        size_t payload_sectors = getLE16(record + 4);
+        if (payload_len < payload_sectors * SECTOR_SIZE) {
+            return ImageStatus::TRUNCATED;
+        }
+        if (integrityChecksum(sector, payload, payload_sectors) != getLE32(record)) {
+            return ImageStatus::BAD_CHECKSUM;
+        }
+    }
+    
+    return ImageStatus::OK;
+}
+
+size_t BootImage::imageLength(const uint8_t* sector) {
+    RIFTHeader header;
+    std::memcpy(&header, sector, sizeof(header));
+    if (!header.isValid() || (header.flags & RIFTHeader::FLAG_CRC32C) == 0) {
+        return SECTOR_SIZE;
+    }
+    return (1 + static_cast<size_t>(getLE16(sector + INTEGRITY_OFFSET + 4))) * SECTOR_SIZE;
+}
+
+ImageStatus BootImage::inspect(const uint8_t* image, size_t len) {
+    if (image == nullptr || len < SECTOR_SIZE) {
+        return ImageStatus::TRUNCATED;
+    }
+    return inspectSector(image, image + SECTOR_SIZE, len - SECTOR_SIZE);
+}
+
+const char* BootImage::statusName(ImageStatus status) {
+    switch (status) {
+        case ImageStatus::OK: return "OK";
+        case ImageStatus::TRUNCATED: return "TRUNCATED";
+        case ImageStatus::BAD_SIGNATURE: return "BAD_SIGNATURE";
+        case ImageStatus::BAD_HEADER: return "BAD_HEADER";
+        case ImageStatus::BAD_CHECKSUM: return "BAD_CHECKSUM";
+    }
+    return "UNKNOWN";
+}
+
+bool BootImage::verify() const {
+    std::vector<uint8_t> padded(payload_);
+    padded.resize(sectorsFor(payload_.size()) * SECTOR_SIZE, 0);
+    return inspectSector(data_.data(), padded.data(), padded.size()) == ImageStatus::OK;
 }
 
 // ============================================================================
@@ -427,7 +805,7 @@ NSIGIIState RiftBridge::boot() {
 
 bool RiftBridge::createBootImage(const std::string& path) {
     BootImage img;
-    return img.generate(path);
+    return cache_ ? img.generate(path, *cache_) : img.generate(path);
 }
 
 std::string RiftBridge::getVersion() {
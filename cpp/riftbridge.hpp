@@ -10,6 +10,7 @@
 #ifndef RIFTBRIDGE_HPP
 #define RIFTBRIDGE_HPP
 
+#include <array>
 #include <cstdint>
 #include <cstddef>
 #include <vector>
@@ -75,6 +76,7 @@ class InterdepNode;
 class InterdepTree;
 class RingBootMachine;
 class RiftBridge;
+class ArtifactCache;
 
 // ============================================================================
 // Qubit Class
@@ -134,6 +136,8 @@ private:
     void* data_;
     
     bool hasCircularDep(bool* visited, bool* visiting);
+    
+    friend class InterdepTree;
 };
 
 // ============================================================================
@@ -198,35 +202,153 @@ struct RIFTHeader {
     uint8_t checksum;       // 0xFE
     uint8_t flags;          // Boot flags
     
-    RIFTHeader();
-    bool isValid() const;
-    uint8_t calculateChecksum() const;
+    // The BIOS enters the sector at offset 0, so the header runs as code:
+    // checksum 0xFE plus flags decode as `inc/dec byte [modrm]`. Flags must
+    // stay within 0x00-0x0F (excluding 0x06, 0x0E) for that instruction to
+    // remain two bytes long and fall through to the boot code at offset 8.
+    static constexpr uint8_t FLAG_BOOT = 0x01;
+    static constexpr uint8_t FLAG_CRC32C = 0x02;   // Integrity mode
+    
+    constexpr RIFTHeader()
+        : magic{'R', 'I', 'F', 'T'}, version(0x01), reserved(0x00),
+          checksum(0xFE), flags(FLAG_BOOT) {}
+    
+    constexpr bool isValid() const {
+        return magic[0] == 'R' && magic[1] == 'I' &&
+               magic[2] == 'F' && magic[3] == 'T' &&
+               version == 0x01 && checksum == 0xFE;
+    }
+    
+    constexpr uint8_t calculateChecksum() const {
+        return magic[0] ^ magic[1] ^ magic[2] ^ magic[3] ^
+               version ^ reserved ^ flags;
+    }
+    
+    // True if `value` keeps the header a two-byte instruction (see above)
+    static constexpr bool executableFlags(uint8_t value) {
+        return value <= 0x0F && value != 0x06 && value != 0x0E;
+    }
+};
+
+// ============================================================================
+// MBR Partition Entry
+// ============================================================================
+
+struct PartitionEntry {
+    uint8_t status;         // 0x80 = bootable, 0x00 = inactive
+    uint8_t type;           // Partition type ID
+    uint32_t lba_start;     // First sector of the partition
+    uint32_t sector_count;  // Partition length in sectors
+    
+    static constexpr uint8_t BOOTABLE = 0x80;
+    static constexpr size_t ENTRY_SIZE = 16;
 };
 
 // ============================================================================
 // Boot Image Generator
 // ============================================================================
 
+enum class ImageStatus : uint8_t {
+    OK              = 0,
+    TRUNCATED       = 1,    // Shorter than one sector
+    BAD_SIGNATURE   = 2,    // Missing 0x55AA at offset 510
+    BAD_HEADER      = 3,    // RIFTHeader::isValid() failed
+    BAD_CHECKSUM    = 4     // Integrity mode CRC32C mismatch
+};
+
 class BootImage {
 public:
     static constexpr size_t SECTOR_SIZE = 512;
     static constexpr size_t BOOT_SIG_OFFSET = 510;
+    static constexpr size_t PARTITION_TABLE_OFFSET = 446;
+    static constexpr size_t MAX_PARTITIONS = 4;
+    
+    // Kernel payload placement read by boot/boot16.s (disk_address_packet)
+    static constexpr uint32_t KERNEL_LBA = 1;
+    static constexpr uint32_t KERNEL_SECTORS = 64;
+    
+    // Per-device record written by fleet provisioning (riftfleet.hpp):
+    //   +0 node ID (LE32), +4 reserved. Boot messages must end before it
+    static constexpr size_t DEVICE_RECORD_OFFSET = 0x1A0;
+    static constexpr size_t DEVICE_RECORD_SIZE = 16;
+    
+    // Integrity mode record, stored ahead of the MBR disk signature:
+    //   +0 CRC32C (LE32) over the sector (this field zeroed) and payload sectors
+    //   +4 payload sector count (LE16), +6 reserved
+    static constexpr size_t INTEGRITY_OFFSET = 0x1B0;
+    static constexpr size_t INTEGRITY_SIZE = 8;
     
     BootImage();
     
+    // The built-in RIFT boot sector, assembled at compile time (riftasm.hpp)
+    static const std::array<uint8_t, SECTOR_SIZE>& bootSector();
+    
     bool generate(const std::string& filename);
     bool load(const std::string& filename);
+    
+    // Content-addressed build: reuse the cached image for identical inputs,
+    // otherwise generate and store it. `hit` reports which path was taken
+    bool generate(const std::string& filename, const ArtifactCache& cache, bool* hit = nullptr);
+    
+    // SHA-256 over builder version, boot code, message, header flags and layout
+    std::string cacheKey() const;
     bool verify() const;
     
+    // Check an image already in memory (e.g. mmap'd) without copying it
+    static ImageStatus inspect(const uint8_t* image, size_t len);
+    static const char* statusName(ImageStatus status);
+    
+    // Bytes inspect() needs: one sector, plus payload sectors in integrity mode
+    static size_t imageLength(const uint8_t* sector);
+    
+    // Integrity mode: stamp RIFTHeader::FLAG_CRC32C and a CRC32C record
+    void setIntegrity(bool enabled) { integrity_ = enabled; }
+    bool hasIntegrity() const { return integrity_; }
+    static uint32_t integrityChecksum(const uint8_t* sector, const uint8_t* payload,
+                                      size_t payload_sectors);
+    
+    // Disk layout: MBR at LBA 0, kernel payload at KERNEL_LBA, partitions
+    bool setBootSector(const std::vector<uint8_t>& sector);
+    bool loadBootSector(const std::string& filename);
+    bool setPayload(const std::vector<uint8_t>& payload);
+    bool loadPayload(const std::string& filename);
+    bool addPartition(const PartitionEntry& entry);
+    bool setDiskSize(uint64_t bytes);
+    
+    // A custom boot sector with non-zero bytes in the partition table area
+    // already carries a table; generate() will not overwrite it with
+    // addPartition() entries
+    bool hasCustomPartitionTable() const;
+    
+    // Likewise for the integrity record area, unless the sector is already
+    // in integrity mode and the record there is its own; integrity mode
+    // will not overwrite it
+    bool hasCustomIntegrityArea() const;
+    
+    uint64_t getDiskSize() const;
+    uint64_t getMinimumDiskSize() const;
+    const std::vector<uint8_t>& getPayload() const { return payload_; }
+    const std::vector<PartitionEntry>& getPartitions() const { return partitions_; }
+    
     const uint8_t* getData() const { return data_.data(); }
     size_t getSize() const { return data_.size(); }
     
 private:
     std::vector<uint8_t> data_;
-    
-    void writeRIFTHeader();
-    void writeBootCode();
-    void writeSignature();
+    std::vector<uint8_t> boot_sector_;  // Custom sector as given, before generate() edits it
+    std::vector<uint8_t> payload_;
+    std::vector<PartitionEntry> partitions_;
+    uint64_t disk_size_;
+    bool custom_boot_sector_;
+    bool integrity_;
+    
+    static ImageStatus inspectSector(const uint8_t* sector, const uint8_t* payload,
+                                     size_t payload_len);
+    
+    void writeBootSector();
+    bool writePartitionTable();
+    bool writeIntegrity();
+    bool writeDisk(const std::string& filename) const;
 };
 
 // ============================================================================
@@ -244,8 +366,9 @@ public:
     // Execute boot sequence
     NSIGIIState boot();
     
-    // Create boot image
+    // Create boot image (through the artifact cache when one is set)
     bool createBootImage(const std::string& path);
+    void setArtifactCache(std::shared_ptr<ArtifactCache> cache) { cache_ = std::move(cache); }
     
     // Getters
     RingBootMachine& getMachine() { return machine_; }
@@ -260,6 +383,7 @@ private:
     RingBootMachine machine_;
     std::unique_ptr<InterdepTree> tree_;
     std::vector<Qubit> qubits_;
+    std::shared_ptr<ArtifactCache> cache_;
     bool initialized_;
     
     void phaseSparse();
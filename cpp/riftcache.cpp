@@ -0,0 +1,323 @@
+/*
+ * riftcache.cpp - MMUKO-OS Content-Addressed Artifact Cache Implementation
+ */
+
+#include "riftcache.hpp"
+#include "riftio.hpp"
+#include <algorithm>
+#include <cstring>
+#include <cstdio>
+#include <vector>
+#include <fstream>
+#include <sys/stat.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+#include <sys/ioctl.h>
+#include <linux/fs.h>
+#endif
+
+namespace mmuko {
+
+// ============================================================================
+// SHA-256 Implementation (FIPS 180-4)
+// ============================================================================
+
+namespace {
+
+constexpr uint32_t K[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+inline uint32_t rotr(uint32_t x, int n) {
+    return (x >> n) | (x << (32 - n));
+}
+
+} // namespace
+
+Sha256::Sha256()
+    : state_{0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+             0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19},
+      block_{}, block_len_(0), total_len_(0) {}
+
+void Sha256::compress(const uint8_t* block) {
+    uint32_t w[64];
+    for (int i = 0; i < 16; i++) {
+        w[i] = static_cast<uint32_t>(block[i * 4]) << 24 | static_cast<uint32_t>(block[i * 4 + 1]) << 16 |
+               static_cast<uint32_t>(block[i * 4 + 2]) << 8 | block[i * 4 + 3];
+    }
+    for (int i = 16; i < 64; i++) {
+        uint32_t s0 = rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        uint32_t s1 = rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+
+    uint32_t a = state_[0], b = state_[1], c = state_[2], d = state_[3];
+    uint32_t e = state_[4], f = state_[5], g = state_[6], h = state_[7];
+
+    for (int i = 0; i < 64; i++) {
+        uint32_t t1 = h + (rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25)) + ((e & f) ^ (~e & g)) + K[i] + w[i];
+        uint32_t t2 = (rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+        h = g; g = f; f = e; e = d + t1;
+        d = c; c = b; b = a; a = t1 + t2;
+    }
+
+    state_[0] += a; state_[1] += b; state_[2] += c; state_[3] += d;
+    state_[4] += e; state_[5] += f; state_[6] += g; state_[7] += h;
+}
+
+void Sha256::update(const uint8_t* data, size_t len) {
+    total_len_ += len;
+
+    if (block_len_ > 0) {
+        size_t take = std::min(len, sizeof(block_) - block_len_);
+        std::memcpy(block_ + block_len_, data, take);
+        block_len_ += take;
+        data += take;
+        len -= take;
+        if (block_len_ < sizeof(block_)) return;
+        compress(block_);
+        block_len_ = 0;
+    }
+
+    while (len >= sizeof(block_)) {
+        compress(data);
+        data += sizeof(block_);
+        len -= sizeof(block_);
+    }
+
+    std::memcpy(block_, data, len);
+    block_len_ = len;
+}
+
+Sha256::Digest Sha256::finish() {
+    uint64_t bits = total_len_ * 8;
+
+    static const uint8_t pad = 0x80;
+    static const uint8_t zeros[64] = {};
+    update(&pad, 1);
+    update(zeros, (block_len_ <= 56 ? 56 : 120) - block_len_);
+
+    uint8_t length[8];
+    for (int i = 0; i < 8; i++) {
+        length[i] = static_cast<uint8_t>(bits >> (56 - 8 * i));
+    }
+    update(length, sizeof(length));
+
+    Digest digest;
+    for (int i = 0; i < 8; i++) {
+        digest[i * 4] = static_cast<uint8_t>(state_[i] >> 24);
+        digest[i * 4 + 1] = static_cast<uint8_t>(state_[i] >> 16);
+        digest[i * 4 + 2] = static_cast<uint8_t>(state_[i] >> 8);
+        digest[i * 4 + 3] = static_cast<uint8_t>(state_[i]);
+    }
+    return digest;
+}
+
+std::string Sha256::hex(const Digest& digest) {
+    static const char digits[] = "0123456789abcdef";
+    std::string out;
+    out.reserve(digest.size() * 2);
+    for (uint8_t byte : digest) {
+        out.push_back(digits[byte >> 4]);
+        out.push_back(digits[byte & 0x0F]);
+    }
+    return out;
+}
+
+// ============================================================================
+// CacheKey Implementation
+// ============================================================================
+
+CacheKey::CacheKey() {
+    add(std::string(SCHEMA));
+}
+
+CacheKey& CacheKey::add(const uint8_t* data, size_t len) {
+    uint8_t prefix[8];
+    for (int i = 0; i < 8; i++) {
+        prefix[i] = static_cast<uint8_t>(static_cast<uint64_t>(len) >> (8 * i));
+    }
+    hash_.update(prefix, sizeof(prefix));
+    hash_.update(data, len);
+    return *this;
+}
+
+CacheKey& CacheKey::add(const std::string& text) {
+    return add(reinterpret_cast<const uint8_t*>(text.data()), text.size());
+}
+
+CacheKey& CacheKey::add(uint64_t value) {
+    uint8_t bytes[8];
+    for (int i = 0; i < 8; i++) {
+        bytes[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+    return add(bytes, sizeof(bytes));
+}
+
+std::string CacheKey::finish() {
+    return Sha256::hex(hash_.finish());
+}
+
+// ============================================================================
+// File Placement Helpers
+// ============================================================================
+
+namespace {
+
+bool makeDirectories(const std::string& path) {
+    size_t pos = 0;
+    while (pos != std::string::npos) {
+        pos = path.find('/', pos + 1);
+        std::string prefix = path.substr(0, pos);
+        if (prefix.empty()) continue;
+        if (!makeDirectory(prefix)) return false;
+    }
+    return true;
+}
+
+bool isRegularFile(const std::string& path) {
+    struct stat st;
+    return ::stat(path.c_str(), &st) == 0 && S_ISREG(st.st_mode);
+}
+
+// Share the source's extents (copy-on-write); fails off btrfs/XFS/bcachefs
+bool reflinkFile(const std::string& src, const std::string& dest) {
+#if defined(__linux__) && defined(FICLONE)
+    int in = ::open(src.c_str(), O_RDONLY);
+    if (in < 0) return false;
+    int out = ::open(dest.c_str(), O_WRONLY | O_CREAT | O_EXCL, 0644);
+    if (out < 0) {
+        ::close(in);
+        return false;
+    }
+    bool ok = ::ioctl(out, FICLONE, in) == 0;
+    ::close(in);
+    ::close(out);
+    if (!ok) ::unlink(dest.c_str());
+    return ok;
+#else
+    (void)src;
+    (void)dest;
+    return false;
+#endif
+}
+
+bool hardLinkFile(const std::string& src, const std::string& dest) {
+#ifndef _WIN32
+    return ::link(src.c_str(), dest.c_str()) == 0;
+#else
+    (void)src;
+    (void)dest;
+    return false;
+#endif
+}
+
+// Byte copy that leaves all-zero blocks as holes, so sparse disks stay sparse
+bool copyFile(const std::string& src, const std::string& dest) {
+    std::ifstream in(src, std::ios::binary);
+    if (!in) return false;
+
+#ifndef _WIN32
+    int out = ::open(dest.c_str(), O_WRONLY | O_CREAT | O_EXCL, 0644);
+    if (out < 0) return false;
+
+    std::vector<uint8_t> buffer(1u << 16);
+    const size_t block = 4096;
+    uint64_t offset = 0;
+    bool ok = true;
+
+    while (ok && in) {
+        in.read(reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+        size_t got = static_cast<size_t>(in.gcount());
+        for (size_t pos = 0; ok && pos < got; pos += block) {
+            size_t len = std::min(block, got - pos);
+            if (!isZero(buffer.data() + pos, len)) ok = writeAll(out, buffer.data() + pos, len, offset + pos);
+        }
+        offset += got;
+    }
+
+    if (ok && ::ftruncate(out, static_cast<off_t>(offset)) != 0) ok = false;
+    if (::close(out) != 0) ok = false;
+    if (!ok) ::unlink(dest.c_str());
+    return ok;
+#else
+    std::ofstream out(dest, std::ios::binary | std::ios::trunc);
+    out << in.rdbuf();
+    return out.good();
+#endif
+}
+
+// The destination is replaced, never written through: a previous fetch may
+// have left it as a hard link to a cache entry
+void removeExisting(const std::string& path) {
+    std::remove(path.c_str());
+}
+
+} // namespace
+
+// ============================================================================
+// ArtifactCache Implementation
+// ============================================================================
+
+ArtifactCache::ArtifactCache(std::string directory, bool hard_links)
+    : directory_(std::move(directory)), hard_links_(hard_links) {
+    while (directory_.size() > 1 && directory_.back() == '/') {
+        directory_.pop_back();
+    }
+}
+
+std::string ArtifactCache::entryPath(const std::string& key) const {
+    // Two-level fan-out keeps directories small for large image matrices
+    return directory_ + "/" + key.substr(0, 2) + "/" + key;
+}
+
+bool ArtifactCache::contains(const std::string& key) const {
+    return isRegularFile(entryPath(key));
+}
+
+bool ArtifactCache::fetch(const std::string& key, const std::string& dest) const {
+    std::string entry = entryPath(key);
+    if (!isRegularFile(entry)) return false;
+
+    removeExisting(dest);
+    return reflinkFile(entry, dest) ||
+           (hard_links_ && hardLinkFile(entry, dest)) ||
+           copyFile(entry, dest);
+}
+
+bool ArtifactCache::store(const std::string& key, const std::string& src) const {
+    std::string entry = entryPath(key);
+    if (!makeDirectories(entry.substr(0, entry.rfind('/')))) return false;
+
+    // Build under a private name, then rename so readers never see a partial entry
+    std::string temp = entry + ".tmp";
+#ifndef _WIN32
+    temp += "." + std::to_string(::getpid());
+#endif
+    removeExisting(temp);
+
+    if (!reflinkFile(src, temp) && !copyFile(src, temp)) return false;
+
+#ifndef _WIN32
+    ::chmod(temp.c_str(), 0444);
+#endif
+    if (std::rename(temp.c_str(), entry.c_str()) != 0) {
+        removeExisting(temp);
+        return false;
+    }
+    return true;
+}
+
+} // namespace mmuko
@@ -0,0 +1,96 @@
+/*
+ * riftcache.hpp - MMUKO-OS Content-Addressed Artifact Cache
+ *
+ * Generated boot artifacts are stored under a SHA-256 key of everything
+ * that went into them (builder version, boot code, message, header flags,
+ * layout). A hit is materialized by reflink, then hard link, then copy,
+ * instead of rebuilding. The key format matches rift_cache.py so the C++
+ * and Python builders can share one cache directory.
+ */
+
+#ifndef RIFTCACHE_HPP
+#define RIFTCACHE_HPP
+
+#include <array>
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+namespace mmuko {
+
+// ============================================================================
+// SHA-256
+// ============================================================================
+
+class Sha256 {
+public:
+    using Digest = std::array<uint8_t, 32>;
+
+    Sha256();
+
+    void update(const uint8_t* data, size_t len);
+    Digest finish();
+
+    static std::string hex(const Digest& digest);
+
+private:
+    uint32_t state_[8];
+    uint8_t block_[64];
+    size_t block_len_;
+    uint64_t total_len_;
+
+    void compress(const uint8_t* block);
+};
+
+// ============================================================================
+// Cache Key Builder
+// ============================================================================
+
+// Fields are hashed as an 8-byte little-endian length followed by the bytes,
+// after the schema tag, so field boundaries can never alias
+class CacheKey {
+public:
+    static constexpr const char* SCHEMA = "rift-cache-v1";
+
+    CacheKey();
+
+    CacheKey& add(const uint8_t* data, size_t len);
+    CacheKey& add(const std::string& text);
+    CacheKey& add(uint64_t value);
+
+    std::string finish();
+
+private:
+    Sha256 hash_;
+};
+
+// ============================================================================
+// Artifact Cache
+// ============================================================================
+
+class ArtifactCache {
+public:
+    // Hard links share the entry's inode, so turn them off for artifacts that
+    // are opened read-write later (QEMU disks); entries are stored read-only
+    explicit ArtifactCache(std::string directory, bool hard_links = true);
+
+    // Materialize the artifact for `key` at `dest`, replacing any existing
+    // file rather than writing through it; false on a miss
+    bool fetch(const std::string& key, const std::string& dest) const;
+
+    // Insert `src` under `key` (reflink or copy, never a hard link, so later
+    // edits to `src` cannot reach the cache)
+    bool store(const std::string& key, const std::string& src) const;
+
+    bool contains(const std::string& key) const;
+    std::string entryPath(const std::string& key) const;
+    const std::string& getDirectory() const { return directory_; }
+
+private:
+    std::string directory_;
+    bool hard_links_;
+};
+
+} // namespace mmuko
+
+#endif // RIFTCACHE_HPP
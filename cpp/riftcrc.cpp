@@ -0,0 +1,192 @@
+/*
+ * riftcrc.cpp - MMUKO-OS CRC32C Implementation
+ */
+
+#include "riftcrc.hpp"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define MMUKO_CRC_SSE42 1
+#include <nmmintrin.h>
+#include <cstring>
+#endif
+
+namespace mmuko {
+namespace crc32c {
+
+namespace {
+
+constexpr uint32_t POLY = 0x82F63B78u;      // Castagnoli, bit-reflected
+
+// ============================================================================
+// Slicing-by-8 Tables (built at compile time)
+// ============================================================================
+
+struct SliceTables {
+    uint32_t t[8][256];
+};
+
+constexpr SliceTables makeTables() {
+    SliceTables tables{};
+    for (uint32_t n = 0; n < 256; n++) {
+        uint32_t c = n;
+        for (int k = 0; k < 8; k++) {
+            c = (c & 1) ? (c >> 1) ^ POLY : c >> 1;
+        }
+        tables.t[0][n] = c;
+    }
+    for (uint32_t n = 0; n < 256; n++) {
+        uint32_t c = tables.t[0][n];
+        for (int k = 1; k < 8; k++) {
+            c = tables.t[0][c & 0xFF] ^ (c >> 8);
+            tables.t[k][n] = c;
+        }
+    }
+    return tables;
+}
+
+constexpr SliceTables TABLES = makeTables();
+
+// Register state is kept un-inverted; update() applies the pre/post xor
+uint32_t updateTable(uint32_t s, const uint8_t* p, size_t len) {
+    const auto& t = TABLES.t;
+
+    while (len >= 8) {
+        uint32_t lo = s ^ (static_cast<uint32_t>(p[0]) | static_cast<uint32_t>(p[1]) << 8 |
+                           static_cast<uint32_t>(p[2]) << 16 | static_cast<uint32_t>(p[3]) << 24);
+        s = t[7][lo & 0xFF] ^ t[6][(lo >> 8) & 0xFF] ^
+            t[5][(lo >> 16) & 0xFF] ^ t[4][lo >> 24] ^
+            t[3][p[4]] ^ t[2][p[5]] ^ t[1][p[6]] ^ t[0][p[7]];
+        p += 8;
+        len -= 8;
+    }
+    while (len-- > 0) {
+        s = t[0][(s ^ *p++) & 0xFF] ^ (s >> 8);
+    }
+    return s;
+}
+
+// ============================================================================
+// GF(2) Shift: advance a CRC register over n zero bytes
+// ============================================================================
+
+constexpr uint32_t multModP(uint32_t a, uint32_t b) {
+    uint32_t m = 1u << 31;
+    uint32_t p = 0;
+    for (;;) {
+        if (a & m) {
+            p ^= b;
+            if ((a & (m - 1)) == 0) break;
+        }
+        m >>= 1;
+        b = (b & 1) ? (b >> 1) ^ POLY : b >> 1;
+    }
+    return p;
+}
+
+// x^(8 * n) mod P
+constexpr uint32_t xPow8n(size_t n) {
+    uint32_t square = 1u << 30;     // x^1, squared up to x^8 below
+    for (int k = 0; k < 3; k++) square = multModP(square, square);
+
+    uint32_t p = 1u << 31;          // x^0
+    while (n != 0) {
+        if (n & 1) p = multModP(square, p);
+        square = multModP(square, square);
+        n >>= 1;
+    }
+    return p;
+}
+
+#ifdef MMUKO_CRC_SSE42
+
+// Three independent streams hide the 3-cycle latency of crc32q
+constexpr size_t STREAM_BLOCK = 1024;
+constexpr uint32_t STREAM_SHIFT = xPow8n(STREAM_BLOCK);
+
+inline uint64_t load64(const uint8_t* p) {
+    uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+__attribute__((target("sse4.2")))
+uint32_t updateHardware(uint32_t s, const uint8_t* p, size_t len) {
+    while (len > 0 && (reinterpret_cast<uintptr_t>(p) & 7) != 0) {
+        s = _mm_crc32_u8(s, *p++);
+        len--;
+    }
+
+    while (len >= 3 * STREAM_BLOCK) {
+        uint64_t a = s, b = 0, c = 0;
+        for (size_t i = 0; i < STREAM_BLOCK; i += 8) {
+            a = _mm_crc32_u64(a, load64(p + i));
+            b = _mm_crc32_u64(b, load64(p + STREAM_BLOCK + i));
+            c = _mm_crc32_u64(c, load64(p + 2 * STREAM_BLOCK + i));
+        }
+        s = multModP(STREAM_SHIFT, static_cast<uint32_t>(a)) ^ static_cast<uint32_t>(b);
+        s = multModP(STREAM_SHIFT, s) ^ static_cast<uint32_t>(c);
+        p += 3 * STREAM_BLOCK;
+        len -= 3 * STREAM_BLOCK;
+    }
+
+    uint64_t s64 = s;
+    while (len >= 8) {
+        s64 = _mm_crc32_u64(s64, load64(p));
+        p += 8;
+        len -= 8;
+    }
+    s = static_cast<uint32_t>(s64);
+    while (len-- > 0) {
+        s = _mm_crc32_u8(s, *p++);
+    }
+    return s;
+}
+
+#endif // MMUKO_CRC_SSE42
+
+using UpdateFunc = uint32_t (*)(uint32_t, const uint8_t*, size_t);
+
+UpdateFunc selectUpdate() {
+#ifdef MMUKO_CRC_SSE42
+    if (__builtin_cpu_supports("sse4.2")) {
+        return updateHardware;
+    }
+#endif
+    return updateTable;
+}
+
+UpdateFunc activeUpdate() {
+    static const UpdateFunc func = selectUpdate();
+    return func;
+}
+
+} // namespace
+
+// ============================================================================
+// Public Interface
+// ============================================================================
+
+uint32_t update(uint32_t crc, const uint8_t* data, size_t len) {
+    return ~activeUpdate()(~crc, data, len);
+}
+
+uint32_t combine(uint32_t crc_a, uint32_t crc_b, size_t len_b) {
+    return multModP(xPow8n(len_b), crc_a) ^ crc_b;
+}
+
+uint32_t xorDelta(const uint8_t* delta, size_t len, size_t bytes_after) {
+    // Pure polynomial part of the CRC: zero initial register, no final xor
+    uint32_t raw = activeUpdate()(0, delta, len);
+    return multModP(xPow8n(bytes_after), raw);
+}
+
+bool hardwareAccelerated() {
+#ifdef MMUKO_CRC_SSE42
+    return activeUpdate() == updateHardware;
+#else
+    return false;
+#endif
+}
+
+} // namespace crc32c
+} // namespace mmuko
@@ -0,0 +1,40 @@
+/*
+ * riftcrc.hpp - MMUKO-OS CRC32C (Castagnoli) Checksums
+ *
+ * Image integrity checksum for RIFT integrity mode. Uses the SSE4.2 crc32
+ * instruction when the CPU has it (three interleaved streams, recombined
+ * with GF(2) shifts) and a slicing-by-8 table walk everywhere else
+ */
+
+#ifndef RIFTCRC_HPP
+#define RIFTCRC_HPP
+
+#include <cstdint>
+#include <cstddef>
+
+namespace mmuko {
+namespace crc32c {
+
+// Continue a CRC32C over more data; start with crc = 0 (zlib-style chaining)
+uint32_t update(uint32_t crc, const uint8_t* data, size_t len);
+
+// CRC32C of one buffer
+inline uint32_t compute(const uint8_t* data, size_t len) {
+    return update(0, data, len);
+}
+
+// CRC32C of A followed by B, from crc(A), crc(B) and B's length
+uint32_t combine(uint32_t crc_a, uint32_t crc_b, size_t len_b);
+
+// Change to a message's CRC32C when `len` bytes, followed by `bytes_after`
+// more, are XORed with `delta`: crc(patched) = crc(original) ^ xorDelta(...).
+// Lets a one-field patch be re-checksummed without reading the rest
+uint32_t xorDelta(const uint8_t* delta, size_t len, size_t bytes_after);
+
+// True if update() dispatches to the SSE4.2 instruction path
+bool hardwareAccelerated();
+
+} // namespace crc32c
+} // namespace mmuko
+
+#endif // RIFTCRC_HPP
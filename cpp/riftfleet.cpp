@@ -0,0 +1,412 @@
+/*
+ * riftfleet.cpp - MMUKO-OS Fleet Image Provisioning Implementation
+ */
+
+#include "riftfleet.hpp"
+#include "riftcrc.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <set>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+namespace mmuko {
+
+namespace {
+
+constexpr size_t SECTOR = BootImage::SECTOR_SIZE;
+constexpr size_t BODY_BLOCK = 4096;
+constexpr size_t PROVISION_BATCH = 64;
+constexpr uint16_t LOAD_ADDRESS = 0x7C00;
+constexpr uint8_t MOV_SI_IMM16 = 0xBE;
+
+// Both generators load the message with `mov si, imm16` early in the code
+size_t findMessageOffset(const uint8_t* sector) {
+    for (size_t i = sizeof(RIFTHeader); i + 2 < 0x40; i++) {
+        if (sector[i] != MOV_SI_IMM16) continue;
+        size_t address = getLE16(sector + i + 1);
+        if (address < LOAD_ADDRESS) return 0;
+        size_t offset = address - LOAD_ADDRESS;
+        return offset > i + 2 && offset < BootImage::DEVICE_RECORD_OFFSET ? offset : 0;
+    }
+    return 0;
+}
+
+// ----------------------------------------------------------------------------
+// CSV Parsing
+// ----------------------------------------------------------------------------
+
+bool splitCsvLine(const std::string& line, std::vector<std::string>& fields) {
+    fields.clear();
+    std::string field;
+    bool quoted = false;
+
+    for (size_t i = 0; i < line.size(); i++) {
+        char c = line[i];
+        if (quoted) {
+            if (c == '"' && i + 1 < line.size() && line[i + 1] == '"') {
+                field.push_back('"');
+                i++;
+            } else if (c == '"') {
+                quoted = false;
+            } else {
+                field.push_back(c);
+            }
+        } else if (c == '"' && field.empty()) {
+            quoted = true;
+        } else if (c == ',') {
+            fields.push_back(field);
+            field.clear();
+        } else if (c != '\r') {
+            field.push_back(c);
+        }
+    }
+
+    fields.push_back(field);
+    return !quoted;
+}
+
+bool unescape(const std::string& text, std::string& out) {
+    out.clear();
+    for (size_t i = 0; i < text.size(); i++) {
+        if (text[i] != '\\') {
+            out.push_back(text[i]);
+            continue;
+        }
+        if (++i >= text.size()) return false;
+        switch (text[i]) {
+            case 'r':  out.push_back('\r'); break;
+            case 'n':  out.push_back('\n'); break;
+            case '\\': out.push_back('\\'); break;
+            default:   return false;
+        }
+    }
+    return true;
+}
+
+bool parseField(const std::string& text, int64_t max, int64_t& out) {
+    if (text.empty()) {
+        out = DeviceSpec::KEEP;
+        return true;
+    }
+
+    char* end = nullptr;
+    unsigned long long value = std::strtoull(text.c_str(), &end, 0);
+    if (end == text.c_str() || *end != '\0' || value > static_cast<unsigned long long>(max)) {
+        return false;
+    }
+    out = static_cast<int64_t>(value);
+    return true;
+}
+
+} // namespace
+
+// ============================================================================
+// FleetProvisioner Implementation
+// ============================================================================
+
+FleetProvisioner::FleetProvisioner(unsigned threads)
+    : pool_(threads),
+      sector_(SECTOR, 0),
+      message_offset_(0),
+      message_length_(0),
+      message_capacity_(0),
+      payload_sectors_(0),
+      integrity_(false) {}
+
+bool FleetProvisioner::loadTemplate(const std::string& path, std::string& error) {
+    if (!template_file_.open(path, MappedFile::Access::SEQUENTIAL) ||
+        template_file_.size() < SECTOR) {
+        error = "cannot read a boot sector from " + path;
+        return false;
+    }
+
+    const uint8_t* data = template_file_.data();
+    RIFTHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    if (!header.isValid()) {
+        error = path + " has no RIFT header to personalize";
+        return false;
+    }
+
+    ImageStatus status = BootImage::inspect(data, template_file_.size());
+    if (status != ImageStatus::OK) {
+        error = path + " fails verification (" + BootImage::statusName(status) + ")";
+        return false;
+    }
+
+    // Personalizing writes the device record and rewrites the message, so
+    // neither may hold the template's own code or data
+    if (!isZero(data + BootImage::DEVICE_RECORD_OFFSET, BootImage::DEVICE_RECORD_SIZE)) {
+        error = path + " has data in the device record area (bytes " +
+                std::to_string(BootImage::DEVICE_RECORD_OFFSET) + "-" +
+                std::to_string(BootImage::DEVICE_RECORD_OFFSET + BootImage::DEVICE_RECORD_SIZE - 1) +
+                ")";
+        return false;
+    }
+
+    message_offset_ = findMessageOffset(data);
+    message_length_ = 0;
+    message_capacity_ = 0;
+    if (message_offset_ != 0) {
+        const uint8_t* message = data + message_offset_;
+        const void* nul = std::memchr(message, 0, BootImage::DEVICE_RECORD_OFFSET - message_offset_);
+        if (nul == nullptr) {
+            error = path + " has a boot message that runs into the device record at " +
+                    std::to_string(BootImage::DEVICE_RECORD_OFFSET);
+            return false;
+        }
+        message_length_ = static_cast<size_t>(static_cast<const uint8_t*>(nul) - message);
+
+        size_t end = message_offset_ + message_length_ + 1;
+        while (end < BootImage::DEVICE_RECORD_OFFSET && data[end] == 0) end++;
+        message_capacity_ = end - message_offset_;
+    }
+
+    std::memcpy(sector_.data(), data, SECTOR);
+    integrity_ = (header.flags & RIFTHeader::FLAG_CRC32C) != 0;
+    payload_sectors_ = integrity_ ? getLE16(data + BootImage::INTEGRITY_OFFSET + 4) : 0;
+
+    // Everything past sector 0 is copied as-is; only its non-zero runs are written
+    body_runs_.clear();
+    for (size_t pos = SECTOR; pos < template_file_.size();) {
+        size_t end = std::min(template_file_.size(), (pos / BODY_BLOCK + 1) * BODY_BLOCK);
+        if (!isZero(data + pos, end - pos)) {
+            if (!body_runs_.empty() && body_runs_.back().offset + body_runs_.back().len == pos) {
+                body_runs_.back().len += end - pos;
+            } else {
+                body_runs_.push_back({pos, end - pos});
+            }
+        }
+        pos = end;
+    }
+
+    return true;
+}
+
+bool FleetProvisioner::loadTable(const std::string& path, std::vector<DeviceSpec>& out,
+                                 std::string& error) {
+    std::ifstream file(path);
+    if (!file) {
+        error = "cannot open " + path;
+        return false;
+    }
+
+    std::string line;
+    std::vector<std::string> fields;
+    size_t line_no = 0;
+
+    while (std::getline(file, line)) {
+        line_no++;
+        if (line.empty() || line == "\r" || line[0] == '#') continue;
+
+        std::string where = path + ":" + std::to_string(line_no) + ": ";
+        if (!splitCsvLine(line, fields)) {
+            error = where + "unterminated quote";
+            return false;
+        }
+        if (fields.size() < 1 || fields.size() > 4) {
+            error = where + "expected name,flags,node_id,message";
+            return false;
+        }
+        fields.resize(4);
+
+        if (line_no == 1 && fields[0] == "name") continue;     // Header row
+
+        DeviceSpec spec;
+        int64_t flags = 0;
+        spec.name = fields[0];
+        spec.line = line_no;
+        if (!parseField(fields[1], 0xFF, flags)) {
+            error = where + "invalid flags '" + fields[1] + "'";
+            return false;
+        }
+        if (!parseField(fields[2], 0xFFFFFFFFll, spec.node_id)) {
+            error = where + "invalid node_id '" + fields[2] + "'";
+            return false;
+        }
+        if (!unescape(fields[3], spec.message)) {
+            error = where + "bad escape in message";
+            return false;
+        }
+        spec.flags = static_cast<int>(flags);
+        out.push_back(std::move(spec));
+    }
+
+    return true;
+}
+
+bool FleetProvisioner::personalize(const DeviceSpec& device, uint8_t* sector,
+                                   std::string& error) const {
+    if (device.flags != DeviceSpec::KEEP) {
+        uint8_t flags = static_cast<uint8_t>(device.flags);
+        if (!RIFTHeader::executableFlags(flags)) {
+            error = "flags must stay within 0x00-0x0F, excluding 0x06 and 0x0E";
+            return false;
+        }
+        if (integrity_ != ((flags & RIFTHeader::FLAG_CRC32C) != 0)) {
+            error = integrity_ ? "template is in integrity mode; flags must keep 0x02"
+                               : "template has no integrity record; flags cannot set 0x02";
+            return false;
+        }
+        sector[offsetof(RIFTHeader, flags)] = flags;
+    }
+
+    if (device.node_id != DeviceSpec::KEEP) {
+        putLE32(sector + BootImage::DEVICE_RECORD_OFFSET, static_cast<uint32_t>(device.node_id));
+    }
+
+    if (!device.message.empty()) {
+        size_t capacity = getMessageCapacity();
+        if (capacity == 0) {
+            error = "template boot code has no message to replace";
+            return false;
+        }
+        if (device.message.size() + 1 > capacity) {
+            error = "message is " + std::to_string(device.message.size()) +
+                    " bytes; the template has room for " + std::to_string(capacity - 1);
+            return false;
+        }
+        // Past the old message the room is already zero
+        uint8_t* msg = sector + message_offset_;
+        size_t cleared = std::max(device.message.size() + 1, message_length_ + 1);
+        std::memcpy(msg, device.message.data(), device.message.size());
+        std::memset(msg + device.message.size(), 0, cleared - device.message.size());
+    }
+
+    if (!integrity_) return true;
+
+    // CRC32C is linear: fold in just the XOR of each changed run
+    const size_t payload_bytes = payload_sectors_ * SECTOR;
+    uint32_t crc = getLE32(sector_.data() + BootImage::INTEGRITY_OFFSET);
+    uint8_t delta[SECTOR];
+
+    for (size_t i = 0; i < SECTOR;) {
+        if (sector[i] == sector_[i]) {
+            i++;
+            continue;
+        }
+        size_t start = i;
+        while (i < SECTOR && sector[i] != sector_[i]) {
+            delta[i - start] = sector[i] ^ sector_[i];
+            i++;
+        }
+        crc ^= crc32c::xorDelta(delta, i - start, (SECTOR - i) + payload_bytes);
+    }
+
+    putLE32(sector + BootImage::INTEGRITY_OFFSET, crc);
+    return true;
+}
+
+bool FleetProvisioner::validate(const std::vector<DeviceSpec>& devices,
+                                std::vector<ProvisionError>& errors) const {
+    std::set<std::string> names;
+    std::vector<uint8_t> scratch(SECTOR);
+
+    for (const auto& device : devices) {
+        std::string problem;
+        if (device.name.empty() || device.name == "." || device.name == ".." ||
+            device.name.find_first_of("/\\") != std::string::npos) {
+            problem = "invalid output name '" + device.name + "'";
+        } else if (!names.insert(device.name).second) {
+            problem = "duplicate output name";
+        } else {
+            std::memcpy(scratch.data(), sector_.data(), SECTOR);
+            personalize(device, scratch.data(), problem);
+        }
+
+        if (!problem.empty()) {
+            std::string where = device.line != 0 ? "line " + std::to_string(device.line) + ": " : "";
+            errors.push_back({device.name, where + problem});
+        }
+    }
+
+    return errors.empty();
+}
+
+bool FleetProvisioner::writeImage(const std::string& path, const uint8_t* sector) const {
+    const uint8_t* data = template_file_.data();
+
+#ifndef _WIN32
+    int fd = createReplacing(path);
+    if (fd < 0) return false;
+
+    bool ok = writeAll(fd, sector, SECTOR, 0);
+    for (size_t i = 0; ok && i < body_runs_.size(); i++) {
+        ok = writeAll(fd, data + body_runs_[i].offset, body_runs_[i].len, body_runs_[i].offset);
+    }
+    if (ok && ::ftruncate(fd, static_cast<off_t>(template_file_.size())) != 0) ok = false;
+    if (::close(fd) != 0) ok = false;
+    return ok;
+#else
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(sector), SECTOR);
+    file.write(reinterpret_cast<const char*>(data + SECTOR),
+               static_cast<std::streamsize>(template_file_.size() - SECTOR));
+    return file.good();
+#endif
+}
+
+ProvisionReport FleetProvisioner::provision(const std::vector<DeviceSpec>& devices,
+                                            const std::string& out_dir, bool verify) {
+    ProvisionReport report;
+    if (!validate(devices, report.errors)) return report;
+
+    if (!makeDirectory(out_dir)) {
+        report.errors.push_back({out_dir, "cannot create output directory"});
+        return report;
+    }
+
+    std::atomic<uint64_t> written(0);
+    std::mutex error_mutex;
+    const size_t image_len = SECTOR + payload_sectors_ * SECTOR;
+
+    pool_.parallelFor(devices.size(), PROVISION_BATCH, [&](size_t begin, size_t end) {
+        std::vector<uint8_t> image(image_len);
+        if (image_len > SECTOR) {
+            std::memcpy(image.data() + SECTOR, template_file_.data() + SECTOR, image_len - SECTOR);
+        }
+
+        for (size_t i = begin; i < end; i++) {
+            const DeviceSpec& device = devices[i];
+            std::string problem;
+            std::memcpy(image.data(), sector_.data(), SECTOR);
+
+            ImageStatus status = ImageStatus::OK;
+            if (!personalize(device, image.data(), problem)) {
+                // Already rejected by validate(); kept for callers that skip it
+            } else if (verify &&
+                       (status = BootImage::inspect(image.data(), image.size())) != ImageStatus::OK) {
+                problem = std::string("verification failed (") + BootImage::statusName(status) + ")";
+            } else if (!writeImage(out_dir + "/" + device.name, image.data())) {
+                problem = "write failed";
+            } else {
+                written++;
+                continue;
+            }
+
+            std::lock_guard<std::mutex> lock(error_mutex);
+            report.errors.push_back({device.name, problem});
+        }
+    });
+
+    report.images_written = written.load();
+#ifndef _WIN32
+    // writeImage() writes the sector and the body runs; the rest are holes
+    uint64_t image_bytes = SECTOR;
+    for (const Run& run : body_runs_) image_bytes += run.len;
+#else
+    uint64_t image_bytes = template_file_.size();
+#endif
+    report.bytes_written = report.images_written * image_bytes;
+    return report;
+}
+
+} // namespace mmuko
@@ -0,0 +1,109 @@
+/*
+ * riftfleet.hpp - MMUKO-OS Fleet Image Provisioning
+ *
+ * Writes one personalized image per device from a shared template image.
+ * Each image is the template with its boot sector patched (header flags,
+ * node ID record, boot message); the integrity CRC32C is updated from the
+ * changed bytes alone, and the template body is written as sparse runs
+ */
+
+#ifndef RIFTFLEET_HPP
+#define RIFTFLEET_HPP
+
+#include "riftbridge.hpp"
+#include "riftio.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace mmuko {
+
+// ============================================================================
+// Device Table
+// ============================================================================
+
+struct DeviceSpec {
+    std::string name;           // Output file name inside the output directory
+    int flags;                  // Header flags, or KEEP to use the template's
+    int64_t node_id;            // Device record node ID, or KEEP
+    std::string message;        // Boot message; empty keeps the template's
+    size_t line;                // Table line, for error reports
+
+    static constexpr int KEEP = -1;
+
+    DeviceSpec() : flags(KEEP), node_id(KEEP), line(0) {}
+};
+
+// ============================================================================
+// Provisioning Results
+// ============================================================================
+
+struct ProvisionError {
+    std::string name;
+    std::string message;
+};
+
+struct ProvisionReport {
+    uint64_t images_written;
+    uint64_t bytes_written;     // Data written; holes in sparse images are not counted
+    std::vector<ProvisionError> errors;
+
+    ProvisionReport() : images_written(0), bytes_written(0) {}
+};
+
+// ============================================================================
+// Fleet Provisioner
+// ============================================================================
+
+class FleetProvisioner {
+public:
+    // threads == 0 selects one worker per hardware thread
+    explicit FleetProvisioner(unsigned threads = 0);
+
+    // Template: any image with a RIFT boot sector (payload and size kept)
+    // whose device record area is zero and whose boot message ends before it
+    bool loadTemplate(const std::string& path, std::string& error);
+
+    // CSV with header "name,flags,node_id,message". Fields may be
+    // double-quoted; the message understands the escapes \r, \n and a
+    // doubled backslash. Empty fields keep the template's values
+    static bool loadTable(const std::string& path, std::vector<DeviceSpec>& out,
+                          std::string& error);
+
+    // Check every spec before anything is written; false with errors listed
+    bool validate(const std::vector<DeviceSpec>& devices,
+                  std::vector<ProvisionError>& errors) const;
+
+    // Personalize one boot sector in place (sector starts as the template's)
+    bool personalize(const DeviceSpec& device, uint8_t* sector, std::string& error) const;
+
+    ProvisionReport provision(const std::vector<DeviceSpec>& devices, const std::string& out_dir,
+                              bool verify = false);
+
+    size_t getMessageOffset() const { return message_offset_; }
+    size_t getMessageCapacity() const { return message_capacity_; }   // Bytes including the NUL
+    bool hasIntegrity() const { return integrity_; }
+    unsigned getThreadCount() const { return pool_.size(); }
+
+private:
+    struct Run {
+        size_t offset;
+        size_t len;
+    };
+
+    ThreadPool pool_;
+    MappedFile template_file_;
+    std::vector<uint8_t> sector_;
+    std::vector<Run> body_runs_;    // Non-zero 4 KiB-granular runs past sector 0
+    size_t message_offset_;         // 0 if the template has no `mov si, msg`
+    size_t message_length_;         // Template message bytes, without the NUL
+    size_t message_capacity_;       // The message, its NUL and the zero bytes after it
+    size_t payload_sectors_;
+    bool integrity_;
+
+    bool writeImage(const std::string& path, const uint8_t* sector) const;
+};
+
+} // namespace mmuko
+
+#endif // RIFTFLEET_HPP
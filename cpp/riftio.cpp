@@ -0,0 +1,283 @@
+/*
+ * riftio.cpp - MMUKO-OS RiftBridge I/O and Worker Utilities
+ */
+
+#include "riftio.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <utility>
+#include <sys/stat.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#else
+#include <direct.h>
+#endif
+
+namespace mmuko {
+
+// ============================================================================
+// Byte and File Helpers
+// ============================================================================
+
+bool isZero(const uint8_t* p, size_t len) {
+    return len == 0 || (p[0] == 0 && std::memcmp(p, p + 1, len - 1) == 0);
+}
+
+bool readFile(const std::string& path, std::vector<uint8_t>& out) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) return false;
+
+    std::streamoff len = file.tellg();
+    if (len < 0) return false;
+
+    out.resize(static_cast<size_t>(len));
+    file.seekg(0);
+    return static_cast<bool>(file.read(reinterpret_cast<char*>(out.data()), len));
+}
+
+bool makeDirectory(const std::string& path) {
+#ifndef _WIN32
+    return ::mkdir(path.c_str(), 0755) == 0 || errno == EEXIST;
+#else
+    return ::_mkdir(path.c_str()) == 0 || errno == EEXIST;
+#endif
+}
+
+#ifndef _WIN32
+int createReplacing(const std::string& path) {
+    ::unlink(path.c_str());
+    return ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+}
+
+bool writeAll(int fd, const uint8_t* p, size_t len, uint64_t offset) {
+    while (len > 0) {
+        ssize_t n = ::pwrite(fd, p, len, static_cast<off_t>(offset));
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        p += n;
+        len -= static_cast<size_t>(n);
+        offset += static_cast<uint64_t>(n);
+    }
+    return true;
+}
+#endif
+
+// ============================================================================
+// MappedFile Implementation
+// ============================================================================
+
+MappedFile::MappedFile()
+    : data_(nullptr),
+      size_(0),
+      open_(false) {
+}
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : data_(other.data_),
+      size_(other.size_),
+      open_(other.open_),
+      buffer_(std::move(other.buffer_)) {
+    other.data_ = nullptr;
+    other.size_ = 0;
+    other.open_ = false;
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        close();
+        data_ = other.data_;
+        size_ = other.size_;
+        open_ = other.open_;
+        buffer_ = std::move(other.buffer_);
+        other.data_ = nullptr;
+        other.size_ = 0;
+        other.open_ = false;
+    }
+    return *this;
+}
+
+bool MappedFile::open(const std::string& path, Access access) {
+    close();
+
+#ifndef _WIN32
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || !(S_ISREG(st.st_mode) || S_ISBLK(st.st_mode))) {
+        ::close(fd);
+        return false;
+    }
+
+    // st_size is 0 for block devices; the end offset is the device size
+    off_t end = S_ISBLK(st.st_mode) ? ::lseek(fd, 0, SEEK_END) : st.st_size;
+    if (end < 0) {
+        ::close(fd);
+        return false;
+    }
+
+    size_ = static_cast<size_t>(end);
+    if (size_ > 0) {
+        void* addr = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr == MAP_FAILED) {
+            ::close(fd);
+            size_ = 0;
+            return false;
+        }
+        ::madvise(addr, size_, access == Access::SEQUENTIAL ? MADV_SEQUENTIAL : MADV_RANDOM);
+        data_ = static_cast<const uint8_t*>(addr);
+    }
+
+    // The mapping keeps its own reference to the file
+    ::close(fd);
+#else
+    (void)access;
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) return false;
+
+    std::streamoff len = file.tellg();
+    if (len < 0) return false;
+
+    buffer_.resize(static_cast<size_t>(len));
+    file.seekg(0);
+    file.read(reinterpret_cast<char*>(buffer_.data()), len);
+    if (!file) return false;
+
+    data_ = buffer_.data();
+    size_ = buffer_.size();
+#endif
+
+    open_ = true;
+    return true;
+}
+
+void MappedFile::close() {
+#ifndef _WIN32
+    if (data_ != nullptr && buffer_.empty()) {
+        ::munmap(const_cast<uint8_t*>(data_), size_);
+    }
+#endif
+    buffer_.clear();
+    data_ = nullptr;
+    size_ = 0;
+    open_ = false;
+}
+
+void MappedFile::release(size_t offset, size_t len) {
+#ifndef _WIN32
+    if (data_ == nullptr || !buffer_.empty() || offset >= size_) return;
+
+    // madvise needs page-aligned ranges; only whole pages inside the range go
+    size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    size_t begin = (offset + page - 1) / page * page;
+    size_t end = std::min(offset + len, size_) / page * page;
+    if (end > begin) {
+        ::madvise(const_cast<uint8_t*>(data_) + begin, end - begin, MADV_DONTNEED);
+    }
+#else
+    (void)offset;
+    (void)len;
+#endif
+}
+
+// ============================================================================
+// ThreadPool Implementation
+// ============================================================================
+
+ThreadPool::ThreadPool(unsigned threads)
+    : active_(0),
+      stopping_(false) {
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    workers_.reserve(threads);
+    for (unsigned i = 0; i < threads; i++) {
+        workers_.emplace_back([this] { workerLoop(); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    task_ready_.notify_all();
+
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+void ThreadPool::submit(Task task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        tasks_.push_back(std::move(task));
+    }
+    task_ready_.notify_one();
+}
+
+void ThreadPool::wait() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    idle_.wait(lock, [this] { return tasks_.empty() && active_ == 0; });
+}
+
+void ThreadPool::workerLoop() {
+    for (;;) {
+        Task task;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            task_ready_.wait(lock, [this] { return stopping_ || !tasks_.empty(); });
+            if (tasks_.empty()) return;     // stopping_ and drained
+
+            task = std::move(tasks_.front());
+            tasks_.pop_front();
+            active_++;
+        }
+
+        task();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            active_--;
+            if (tasks_.empty() && active_ == 0) {
+                idle_.notify_all();
+            }
+        }
+    }
+}
+
+void ThreadPool::parallelFor(size_t count, size_t grain,
+                             const std::function<void(size_t, size_t)>& body) {
+    if (count == 0) return;
+    if (grain == 0) grain = 1;
+
+    // One task per worker pulling batches keeps uneven files balanced
+    std::atomic<size_t> next(0);
+    size_t batches = (count + grain - 1) / grain;
+    size_t runners = std::min<size_t>(size(), batches);
+
+    for (size_t r = 0; r < runners; r++) {
+        submit([&next, &body, count, grain] {
+            for (;;) {
+                size_t begin = next.fetch_add(grain);
+                if (begin >= count) return;
+                body(begin, std::min(count, begin + grain));
+            }
+        });
+    }
+
+    wait();
+}
+
+} // namespace mmuko
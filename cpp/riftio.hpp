@@ -0,0 +1,150 @@
+/*
+ * riftio.hpp - MMUKO-OS RiftBridge I/O and Worker Utilities
+ *
+ * Read-only file mappings, a small thread pool and the byte and file
+ * helpers shared by the bulk image tools (build, audit, scan,
+ * provisioning, store)
+ *
+ * Supports: Linux, macOS (mmap); Windows falls back to buffered reads
+ */
+
+#ifndef RIFTIO_HPP
+#define RIFTIO_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <deque>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+namespace mmuko {
+
+// ============================================================================
+// Byte and File Helpers
+// ============================================================================
+
+// Little-endian fields of on-disk records
+inline void putLE16(uint8_t* p, uint16_t v) {
+    p[0] = static_cast<uint8_t>(v);
+    p[1] = static_cast<uint8_t>(v >> 8);
+}
+
+inline void putLE32(uint8_t* p, uint32_t v) {
+    putLE16(p, static_cast<uint16_t>(v));
+    putLE16(p + 2, static_cast<uint16_t>(v >> 16));
+}
+
+inline void putLE64(uint8_t* p, uint64_t v) {
+    putLE32(p, static_cast<uint32_t>(v));
+    putLE32(p + 4, static_cast<uint32_t>(v >> 32));
+}
+
+inline uint16_t getLE16(const uint8_t* p) {
+    return static_cast<uint16_t>(p[0] | p[1] << 8);
+}
+
+inline uint32_t getLE32(const uint8_t* p) {
+    return static_cast<uint32_t>(getLE16(p)) | static_cast<uint32_t>(getLE16(p + 2)) << 16;
+}
+
+inline uint64_t getLE64(const uint8_t* p) {
+    return static_cast<uint64_t>(getLE32(p)) | static_cast<uint64_t>(getLE32(p + 4)) << 32;
+}
+
+bool isZero(const uint8_t* p, size_t len);
+
+// Whole file into `out`
+bool readFile(const std::string& path, std::vector<uint8_t>& out);
+
+// One directory level; an existing directory counts as created
+bool makeDirectory(const std::string& path);
+
+#ifndef _WIN32
+// Open `path` for writing as a new file. An existing file is unlinked, not
+// truncated: it may be a hard link into an artifact cache or image store
+int createReplacing(const std::string& path);
+
+// pwrite all of `p`, retrying short writes and EINTR
+bool writeAll(int fd, const uint8_t* p, size_t len, uint64_t offset);
+#endif
+
+// ============================================================================
+// Read-only File Mapping
+// ============================================================================
+
+class MappedFile {
+public:
+    enum class Access : uint8_t {
+        RANDOM      = 0,    // Small images: touch the first sectors only
+        SEQUENTIAL  = 1     // Volumes: stream front to back, read ahead
+    };
+
+    MappedFile();
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    // Regular files and block devices (sized by their end offset)
+    bool open(const std::string& path, Access access = Access::RANDOM);
+    void close();
+
+    // Drop pages in [offset, offset + len) that are no longer needed
+    void release(size_t offset, size_t len);
+
+    const uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+    bool isOpen() const { return open_; }
+
+private:
+    const uint8_t* data_;
+    size_t size_;
+    bool open_;
+    std::vector<uint8_t> buffer_;   // Fallback storage when mmap is unavailable
+};
+
+// ============================================================================
+// Thread Pool
+// ============================================================================
+
+class ThreadPool {
+public:
+    using Task = std::function<void()>;
+
+    // threads == 0 selects std::thread::hardware_concurrency()
+    explicit ThreadPool(unsigned threads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void submit(Task task);
+    void wait();
+
+    unsigned size() const { return static_cast<unsigned>(workers_.size()); }
+
+    // Run body(begin, end) over [0, count) in batches of `grain`, then wait
+    void parallelFor(size_t count, size_t grain,
+                     const std::function<void(size_t, size_t)>& body);
+
+private:
+    std::vector<std::thread> workers_;
+    std::deque<Task> tasks_;
+    std::mutex mutex_;
+    std::condition_variable task_ready_;
+    std::condition_variable idle_;
+    size_t active_;
+    bool stopping_;
+
+    void workerLoop();
+};
+
+} // namespace mmuko
+
+#endif // RIFTIO_HPP
@@ -0,0 +1,268 @@
+/*
+ * riftscan.cpp - MMUKO-OS RIFT Boot Sector Scanner Implementation
+ */
+
+#include "riftscan.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#else
+#include <fstream>
+#endif
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define MMUKO_SCAN_AVX2 1
+#include <immintrin.h>
+#endif
+
+namespace mmuko {
+
+namespace {
+
+constexpr size_t SECTOR = BootImage::SECTOR_SIZE;
+constexpr uint32_t RIFT_MAGIC_LE = 0x54464952u;     // "RIFT" read as little-endian
+constexpr uint32_t BOOT_SIG_HI = 0xAA550000u;       // 0x55,0xAA at +510 in the +508 dword
+
+inline uint32_t load32(const uint8_t* p) {
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+void findScalar(const uint8_t* data, size_t begin, size_t sectors, std::vector<size_t>& out) {
+    for (size_t i = begin; i < sectors; i++) {
+        const uint8_t* sector = data + i * SECTOR;
+        if (load32(sector) == RIFT_MAGIC_LE &&
+            (load32(sector + SECTOR - 4) & 0xFFFF0000u) == BOOT_SIG_HI) {
+            out.push_back(i);
+        }
+    }
+}
+
+#ifdef MMUKO_SCAN_AVX2
+
+// Eight sector heads per gather; the tail gather only runs when a head matched
+__attribute__((target("avx2")))
+void findAvx2(const uint8_t* data, size_t sectors, std::vector<size_t>& out) {
+    const __m256i head_index = _mm256_setr_epi32(0, 512, 1024, 1536, 2048, 2560, 3072, 3584);
+    const __m256i tail_index = _mm256_add_epi32(head_index, _mm256_set1_epi32(SECTOR - 4));
+    const __m256i magic = _mm256_set1_epi32(static_cast<int>(RIFT_MAGIC_LE));
+    const __m256i sig = _mm256_set1_epi32(static_cast<int>(BOOT_SIG_HI));
+    const __m256i sig_mask = _mm256_set1_epi32(static_cast<int>(0xFFFF0000u));
+
+    size_t i = 0;
+    for (; i + 8 <= sectors; i += 8) {
+        const int* base = reinterpret_cast<const int*>(data + i * SECTOR);
+
+        __m256i head = _mm256_i32gather_epi32(base, head_index, 1);
+        int mask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(head, magic)));
+        if (mask == 0) continue;
+
+        __m256i tail = _mm256_and_si256(_mm256_i32gather_epi32(base, tail_index, 1), sig_mask);
+        mask &= _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(tail, sig)));
+
+        while (mask != 0) {
+            out.push_back(i + static_cast<size_t>(__builtin_ctz(static_cast<unsigned>(mask))));
+            mask &= mask - 1;
+        }
+    }
+
+    findScalar(data, i, sectors, out);
+}
+
+#endif // MMUKO_SCAN_AVX2
+
+bool cpuHasAvx2() {
+#ifdef MMUKO_SCAN_AVX2
+    static const bool has = __builtin_cpu_supports("avx2");
+    return has;
+#else
+    return false;
+#endif
+}
+
+// ============================================================================
+// Input Stream (raw devices and regular files alike)
+// ============================================================================
+
+class InputStream {
+public:
+    bool open(const std::string& path) {
+#ifndef _WIN32
+        fd_ = ::open(path.c_str(), O_RDONLY);
+        if (fd_ < 0) return false;
+#ifdef POSIX_FADV_SEQUENTIAL
+        ::posix_fadvise(fd_, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+        return true;
+#else
+        file_.open(path, std::ios::binary);
+        return static_cast<bool>(file_);
+#endif
+    }
+
+    ~InputStream() {
+#ifndef _WIN32
+        if (fd_ >= 0) ::close(fd_);
+#endif
+    }
+
+    // Fill `len` bytes unless the stream ends first. EIO skips to the next
+    // sector boundary: the skipped bytes read as zero and go to `unreadable`.
+    // Any other error, or EIO on an input that cannot seek, sets error()
+    size_t read(uint8_t* buffer, size_t len, std::vector<ScanGap>& unreadable) {
+        size_t got = 0;
+#ifndef _WIN32
+        while (got < len) {
+            ssize_t n = ::read(fd_, buffer + got, len - got);
+            if (n > 0) {
+                got += static_cast<size_t>(n);
+                position_ += static_cast<uint64_t>(n);
+                continue;
+            }
+            if (n == 0) break;
+            if (errno == EINTR) continue;
+            
+            uint64_t next = (position_ / SECTOR + 1) * SECTOR;
+            size_t skip = static_cast<size_t>(std::min<uint64_t>(next - position_, len - got));
+            if (errno != EIO ||
+                ::lseek(fd_, static_cast<off_t>(position_ + skip), SEEK_SET) < 0) {
+                error_ = errno;
+                break;
+            }
+            
+            std::memset(buffer + got, 0, skip);
+            if (!unreadable.empty() &&
+                unreadable.back().offset + unreadable.back().length == position_) {
+                unreadable.back().length += skip;
+            } else {
+                unreadable.push_back({position_, skip});
+            }
+            got += skip;
+            position_ += skip;
+        }
+#else
+        (void)unreadable;
+        file_.read(reinterpret_cast<char*>(buffer), static_cast<std::streamsize>(len));
+        got = static_cast<size_t>(file_.gcount());
+#endif
+        return got;
+    }
+
+    // Positional read that leaves the streaming position alone. It stops at
+    // a read error; the streaming read records the bytes when it gets there
+    size_t readAt(uint8_t* buffer, size_t len, uint64_t offset) {
+        size_t got = 0;
+#ifndef _WIN32
+        while (got < len) {
+            ssize_t n = ::pread(fd_, buffer + got, len - got, static_cast<off_t>(offset + got));
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) break;
+            got += static_cast<size_t>(n);
+        }
+#else
+        std::streampos resume = file_.tellg();
+        file_.clear();
+        file_.seekg(static_cast<std::streamoff>(offset));
+        file_.read(reinterpret_cast<char*>(buffer), static_cast<std::streamsize>(len));
+        got = static_cast<size_t>(file_.gcount());
+        file_.clear();
+        file_.seekg(resume);
+#endif
+        return got;
+    }
+
+    int error() const { return error_; }
+
+private:
+    int error_ = 0;
+#ifndef _WIN32
+    int fd_ = -1;
+    uint64_t position_ = 0;
+#else
+    std::ifstream file_;
+#endif
+};
+
+} // namespace
+
+// ============================================================================
+// SectorScanner Implementation
+// ============================================================================
+
+SectorScanner::SectorScanner(size_t buffer_bytes)
+    : buffer_bytes_(buffer_bytes / SECTOR * SECTOR) {
+    if (buffer_bytes_ < SECTOR) {
+        buffer_bytes_ = SECTOR;
+    }
+}
+
+void SectorScanner::findCandidates(const uint8_t* data, size_t sectors, std::vector<size_t>& out) {
+#ifdef MMUKO_SCAN_AVX2
+    if (cpuHasAvx2()) {
+        findAvx2(data, sectors, out);
+        return;
+    }
+#endif
+    findScalar(data, 0, sectors, out);
+}
+
+bool SectorScanner::vectorized() {
+    return cpuHasAvx2();
+}
+
+bool SectorScanner::scan(const std::string& path, ScanReport& report, const HitFunc& on_hit) {
+    InputStream input;
+    if (!input.open(path)) {
+        report.error = errno;
+        return false;
+    }
+
+    std::vector<uint8_t> buffer(buffer_bytes_);
+    std::vector<size_t> candidates;
+    std::vector<uint8_t> spill;
+    uint64_t base = 0;
+
+    for (;;) {
+        size_t got = input.read(buffer.data(), buffer.size(), report.unreadable);
+        size_t sectors = got / SECTOR;
+
+        candidates.clear();
+        findCandidates(buffer.data(), sectors, candidates);
+
+        for (size_t index : candidates) {
+            const uint8_t* sector = buffer.data() + index * SECTOR;
+            uint64_t offset = base + static_cast<uint64_t>(index) * SECTOR;
+            size_t available = got - index * SECTOR;
+            size_t needed = BootImage::imageLength(sector);
+
+            // Integrity-mode payload running past this buffer: fetch it directly
+            ImageStatus status;
+            if (needed <= available) {
+                status = BootImage::inspect(sector, available);
+            } else {
+                spill.resize(needed);
+                size_t len = input.readAt(spill.data(), needed, offset);
+                status = BootImage::inspect(spill.data(), len);
+            }
+
+            ScanHit hit{offset, status};
+            report.hits.push_back(hit);
+            if (on_hit) on_hit(hit);
+        }
+
+        report.bytes_scanned += got;
+        base += got;
+
+        if (got < buffer.size()) break;
+    }
+
+    report.error = input.error();
+    return report.error == 0;
+}
+
+} // namespace mmuko
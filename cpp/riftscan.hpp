@@ -0,0 +1,76 @@
+/*
+ * riftscan.hpp - MMUKO-OS RIFT Boot Sector Scanner
+ *
+ * Streams a raw block device or disk dump and finds every 512-byte-aligned
+ * sector carrying the "RIFT" magic and the 0x55AA signature. Candidate
+ * sectors are picked out with SIMD compares (AVX2 when available) and then
+ * run through the full BootImage::inspect check
+ */
+
+#ifndef RIFTSCAN_HPP
+#define RIFTSCAN_HPP
+
+#include "riftbridge.hpp"
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace mmuko {
+
+// ============================================================================
+// Scan Results
+// ============================================================================
+
+struct ScanHit {
+    uint64_t offset;            // Byte offset of the sector in the stream
+    ImageStatus status;         // Full verification result
+};
+
+// Bytes the device failed to read (EIO); the scan reads them as zero
+struct ScanGap {
+    uint64_t offset;
+    uint64_t length;
+};
+
+struct ScanReport {
+    uint64_t bytes_scanned;     // Including the unreadable bytes
+    std::vector<ScanHit> hits;  // Every magic + signature match, valid or not
+    std::vector<ScanGap> unreadable;
+    int error;                  // errno when scan() returns false
+
+    ScanReport() : bytes_scanned(0), error(0) {}
+};
+
+// ============================================================================
+// Sector Scanner
+// ============================================================================
+
+class SectorScanner {
+public:
+    using HitFunc = std::function<void(const ScanHit&)>;
+
+    static constexpr size_t DEFAULT_BUFFER = 16u << 20;
+
+    explicit SectorScanner(size_t buffer_bytes = DEFAULT_BUFFER);
+
+    // Stream `path` front to back; on_hit (if set) sees each hit as found.
+    // A sector that fails with EIO is skipped and listed in report.unreadable;
+    // false if `path` cannot be opened or another read error stops the scan
+    bool scan(const std::string& path, ScanReport& report, const HitFunc& on_hit = HitFunc());
+
+    // Append the indexes of sectors in data[0, sectors * 512) that carry
+    // both "RIFT" at +0 and 0x55AA at +510
+    static void findCandidates(const uint8_t* data, size_t sectors, std::vector<size_t>& out);
+
+    // True if findCandidates runs the AVX2 kernel on this CPU
+    static bool vectorized();
+
+private:
+    size_t buffer_bytes_;
+};
+
+} // namespace mmuko
+
+#endif // RIFTSCAN_HPP
@@ -0,0 +1,483 @@
+/*
+ * riftstore.cpp - MMUKO-OS Deduplicating Image Store Implementation
+ */
+
+#include "riftstore.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+#endif
+
+namespace mmuko {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// ============================================================================
+// Gear Table
+// ============================================================================
+
+constexpr uint64_t splitmix64(uint64_t& state) {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+struct GearTable {
+    uint64_t values[256];
+};
+
+constexpr GearTable makeGearTable() {
+    GearTable table{};
+    uint64_t state = 0x4D4D554B4F524946ull;     // "MMUKORIF"
+    for (int i = 0; i < 256; i++) {
+        table.values[i] = splitmix64(state);
+    }
+    return table;
+}
+
+// Fixed forever: changing it moves every cut point and defeats dedup
+constexpr GearTable GEAR = makeGearTable();
+
+// The hash shifts left per byte, so its high bits cover the last 64 bytes.
+// Normalized chunking: a stricter mask before AVG_SIZE, a looser one after
+constexpr uint64_t MASK_STRICT = 0x7FFFull << 49;     // 15 bits
+constexpr uint64_t MASK_LOOSE = 0x7FFull << 53;       // 11 bits
+
+// ============================================================================
+// Encoding Helpers
+// ============================================================================
+
+constexpr char INDEX_MAGIC[8] = {'R', 'I', 'F', 'T', 'I', 'D', 'X', '1'};
+constexpr char RECIPE_MAGIC[8] = {'R', 'I', 'F', 'T', 'R', 'C', 'P', '1'};
+constexpr size_t INDEX_RECORD = 32 + 4 + 4 + 8;
+constexpr size_t RECIPE_RECORD = 32 + 4;
+
+// Relative names only; "a/./b" is stored as "a/b"
+bool normalizeName(const std::string& name, std::string& out) {
+    fs::path path = fs::path(name).lexically_normal();
+    if (name.empty() || path.is_absolute() || !path.has_filename()) return false;
+    for (const auto& part : path) {
+        if (part == "..") return false;
+    }
+    out = path.generic_string();
+    return true;
+}
+
+// Serializes writers across processes; a no-op where flock is unavailable
+class StoreLock {
+public:
+    explicit StoreLock(const std::string& path) : fd_(-1) {
+#ifndef _WIN32
+        fd_ = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+        if (fd_ >= 0) ::flock(fd_, LOCK_EX);
+#else
+        (void)path;
+#endif
+    }
+
+    ~StoreLock() {
+#ifndef _WIN32
+        if (fd_ >= 0) ::close(fd_);
+#endif
+    }
+
+    StoreLock(const StoreLock&) = delete;
+    StoreLock& operator=(const StoreLock&) = delete;
+
+private:
+    int fd_;
+};
+
+} // namespace
+
+// ============================================================================
+// Chunker Implementation
+// ============================================================================
+
+size_t Chunker::next(const uint8_t* data, size_t len) {
+    if (len <= MIN_SIZE) return len;
+
+    const size_t limit = std::min(len, MAX_SIZE);
+    const size_t normal = std::min(limit, AVG_SIZE);
+    uint64_t hash = 0;
+    size_t i = MIN_SIZE;
+
+    for (; i < normal; i++) {
+        hash = (hash << 1) + GEAR.values[data[i]];
+        if ((hash & MASK_STRICT) == 0) return i + 1;
+    }
+    for (; i < limit; i++) {
+        hash = (hash << 1) + GEAR.values[data[i]];
+        if ((hash & MASK_LOOSE) == 0) return i + 1;
+    }
+    return limit;
+}
+
+// ============================================================================
+// ChunkStore Implementation
+// ============================================================================
+
+size_t ChunkStore::ChunkIdHash::operator()(const ChunkId& id) const {
+    // SHA-256 output is already uniform
+    size_t h;
+    std::memcpy(&h, id.data(), sizeof(h));
+    return h;
+}
+
+ChunkStore::ChunkStore(std::string directory)
+    : directory_(std::move(directory)), pack_count_(0), last_pack_size_(0) {
+    while (directory_.size() > 1 && directory_.back() == '/') {
+        directory_.pop_back();
+    }
+}
+
+std::string ChunkStore::packPath(uint32_t pack) const {
+    char name[32];
+    std::snprintf(name, sizeof(name), "%08u.pack", pack);
+    return directory_ + "/packs/" + name;
+}
+
+std::string ChunkStore::recipePath(const std::string& name) const {
+    return directory_ + "/recipes/" + name;
+}
+
+bool ChunkStore::open(std::string& error) {
+    std::error_code ec;
+    fs::create_directories(directory_ + "/packs", ec);
+    fs::create_directories(directory_ + "/recipes", ec);
+    if (!fs::is_directory(directory_ + "/packs") || !fs::is_directory(directory_ + "/recipes")) {
+        error = "cannot create store layout in " + directory_;
+        return false;
+    }
+    return loadIndex(error);
+}
+
+bool ChunkStore::loadIndex(std::string& error) {
+    index_.clear();
+    packs_.clear();
+
+    std::error_code ec;
+    pack_count_ = 0;
+    while (fs::exists(packPath(pack_count_), ec)) {
+        pack_count_++;
+    }
+    last_pack_size_ = pack_count_ > 0 ? fs::file_size(packPath(pack_count_ - 1), ec) : 0;
+    packs_.resize(pack_count_);
+
+    std::vector<uint8_t> raw;
+    if (!readFile(directory_ + "/index", raw) || raw.empty()) return true;     // New store
+    if (raw.size() < sizeof(INDEX_MAGIC) ||
+        std::memcmp(raw.data(), INDEX_MAGIC, sizeof(INDEX_MAGIC)) != 0) {
+        error = directory_ + "/index is not a RIFT store index";
+        return false;
+    }
+
+    // A torn final record (interrupted put) is ignored and trimmed by the next put
+    size_t count = (raw.size() - sizeof(INDEX_MAGIC)) / INDEX_RECORD;
+    index_.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        const uint8_t* rec = raw.data() + sizeof(INDEX_MAGIC) + i * INDEX_RECORD;
+        ChunkId id;
+        std::memcpy(id.data(), rec, id.size());
+        Location location;
+        location.pack = getLE32(rec + 32);
+        location.len = getLE32(rec + 36);
+        location.offset = getLE64(rec + 40);
+        if (location.pack >= pack_count_) {
+            error = "index references missing pack " + packPath(location.pack);
+            return false;
+        }
+        index_.emplace(id, location);
+    }
+    return true;
+}
+
+bool ChunkStore::put(const std::string& name, const std::string& path, PutResult& result,
+                     std::string& error) {
+    std::string stored_name;
+    if (!normalizeName(name, stored_name)) {
+        error = "invalid store name '" + name + "'";
+        return false;
+    }
+
+    MappedFile input;
+    if (!input.open(path, MappedFile::Access::SEQUENTIAL)) {
+        error = "cannot read " + path;
+        return false;
+    }
+
+    StoreLock lock(directory_ + "/lock");
+    if (!loadIndex(error)) return false;     // Another writer may have added chunks
+
+    std::string index_path = directory_ + "/index";
+    std::error_code ec;
+    uint64_t index_size = fs::exists(index_path, ec) ? fs::file_size(index_path, ec) : 0;
+    if (index_size < sizeof(INDEX_MAGIC)) {
+        std::ofstream init(index_path, std::ios::binary | std::ios::trunc);
+        init.write(INDEX_MAGIC, sizeof(INDEX_MAGIC));
+        if (!init) {
+            error = "cannot write " + index_path;
+            return false;
+        }
+    } else if ((index_size - sizeof(INDEX_MAGIC)) % INDEX_RECORD != 0) {
+        fs::resize_file(index_path, index_size - (index_size - sizeof(INDEX_MAGIC)) % INDEX_RECORD, ec);
+    }
+
+    const uint8_t* data = input.data();
+    const size_t size = input.size();
+    std::vector<uint8_t> recipe(sizeof(RECIPE_MAGIC) + 16);
+    std::vector<uint8_t> new_records;
+    std::unordered_map<size_t, ChunkId> zero_ids;       // Sparse images: hash zeros once
+    std::ofstream pack;
+
+    result = PutResult();
+    result.file_bytes = size;
+
+    for (size_t pos = 0; pos < size;) {
+        size_t len = Chunker::next(data + pos, size - pos);
+        const uint8_t* chunk = data + pos;
+
+        ChunkId id;
+        bool zero = isZero(chunk, len);
+        auto memo = zero ? zero_ids.find(len) : zero_ids.end();
+        if (memo != zero_ids.end()) {
+            id = memo->second;
+        } else {
+            Sha256 hash;
+            hash.update(chunk, len);
+            id = hash.finish();
+            if (zero) zero_ids.emplace(len, id);
+        }
+
+        if (index_.find(id) == index_.end()) {
+            if (!pack.is_open() || last_pack_size_ + len > PACK_LIMIT) {
+                if (pack.is_open()) pack.close();
+                if (pack_count_ == 0 || last_pack_size_ + len > PACK_LIMIT) {
+                    pack_count_++;
+                    packs_.resize(pack_count_);
+                    last_pack_size_ = 0;
+                }
+                pack.open(packPath(pack_count_ - 1), std::ios::binary | std::ios::app);
+                if (!pack) {
+                    error = "cannot append to " + packPath(pack_count_ - 1);
+                    return false;
+                }
+            }
+
+            Location location = {pack_count_ - 1, static_cast<uint32_t>(len), last_pack_size_};
+            pack.write(reinterpret_cast<const char*>(chunk), static_cast<std::streamsize>(len));
+            if (!pack) {
+                error = "write to " + packPath(location.pack) + " failed";
+                return false;
+            }
+            last_pack_size_ += len;
+            index_.emplace(id, location);
+
+            uint8_t rec[INDEX_RECORD];
+            std::memcpy(rec, id.data(), id.size());
+            putLE32(rec + 32, location.pack);
+            putLE32(rec + 36, location.len);
+            putLE64(rec + 40, location.offset);
+            new_records.insert(new_records.end(), rec, rec + sizeof(rec));
+
+            result.new_chunks++;
+            result.new_bytes += len;
+        }
+
+        uint8_t entry[RECIPE_RECORD];
+        std::memcpy(entry, id.data(), id.size());
+        putLE32(entry + 32, len);
+        recipe.insert(recipe.end(), entry, entry + sizeof(entry));
+
+        result.chunks++;
+        pos += len;
+    }
+
+    if (pack.is_open()) {
+        pack.close();
+        if (pack.fail()) {
+            error = "write to " + packPath(pack_count_ - 1) + " failed";
+            return false;
+        }
+    }
+
+    // Index records only after their pack bytes are written
+    std::ofstream index(index_path, std::ios::binary | std::ios::app);
+    index.write(reinterpret_cast<const char*>(new_records.data()),
+                static_cast<std::streamsize>(new_records.size()));
+    index.close();
+    if (index.fail()) {
+        error = "cannot append to " + index_path;
+        return false;
+    }
+
+    std::memcpy(recipe.data(), RECIPE_MAGIC, sizeof(RECIPE_MAGIC));
+    putLE64(recipe.data() + 8, size);
+    putLE64(recipe.data() + 16, result.chunks);
+
+    std::string recipe_path = recipePath(stored_name);
+    std::string temp = recipe_path + ".tmp";
+    fs::create_directories(fs::path(recipe_path).parent_path(), ec);
+    std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(recipe.data()), static_cast<std::streamsize>(recipe.size()));
+    out.close();
+    if (out.fail()) {
+        error = "cannot write " + temp;
+        return false;
+    }
+    fs::rename(temp, recipe_path, ec);
+    if (ec) {
+        error = "cannot publish " + recipe_path + ": " + ec.message();
+        return false;
+    }
+    return true;
+}
+
+bool ChunkStore::readRecipe(const std::string& name, uint64_t& size,
+                            std::vector<RecipeEntry>& entries, std::string& error) const {
+    std::string stored_name;
+    std::vector<uint8_t> raw;
+    if (!normalizeName(name, stored_name) || !readFile(recipePath(stored_name), raw)) {
+        error = "no file '" + name + "' in " + directory_;
+        return false;
+    }
+
+    const size_t header = sizeof(RECIPE_MAGIC) + 16;
+    if (raw.size() < header || std::memcmp(raw.data(), RECIPE_MAGIC, sizeof(RECIPE_MAGIC)) != 0 ||
+        (raw.size() - header) / RECIPE_RECORD != getLE64(raw.data() + 16) ||
+        (raw.size() - header) % RECIPE_RECORD != 0) {
+        error = "corrupt recipe for '" + name + "'";
+        return false;
+    }
+
+    size = getLE64(raw.data() + 8);
+    entries.resize((raw.size() - header) / RECIPE_RECORD);
+    uint64_t total = 0;
+    for (size_t i = 0; i < entries.size(); i++) {
+        const uint8_t* rec = raw.data() + header + i * RECIPE_RECORD;
+        std::memcpy(entries[i].id.data(), rec, entries[i].id.size());
+        entries[i].len = getLE32(rec + 32);
+        total += entries[i].len;
+    }
+    if (total != size) {
+        error = "corrupt recipe for '" + name + "'";
+        return false;
+    }
+    return true;
+}
+
+const uint8_t* ChunkStore::chunkData(const Location& location) {
+    if (location.pack >= packs_.size()) return nullptr;
+
+    // Packs grow after they are mapped; remap when a chunk lies past the end
+    auto& pack = packs_[location.pack];
+    if (!pack || pack->size() < location.offset + location.len) {
+        pack.reset(new MappedFile());
+        if (!pack->open(packPath(location.pack), MappedFile::Access::RANDOM) ||
+            pack->size() < location.offset + location.len) {
+            return nullptr;
+        }
+    }
+    return pack->data() + location.offset;
+}
+
+bool ChunkStore::get(const std::string& name, const std::string& dest, std::string& error) {
+    uint64_t size = 0;
+    std::vector<RecipeEntry> entries;
+    if (!readRecipe(name, size, entries, error)) return false;
+
+    // Resolve every chunk before touching the destination
+    std::vector<const uint8_t*> chunks(entries.size());
+    for (size_t i = 0; i < entries.size(); i++) {
+        auto it = index_.find(entries[i].id);
+        if (it == index_.end() || it->second.len != entries[i].len ||
+            (chunks[i] = chunkData(it->second)) == nullptr) {
+            error = "chunk " + Sha256::hex(entries[i].id).substr(0, 16) + " of '" + name +
+                    "' is missing";
+            return false;
+        }
+    }
+
+#ifndef _WIN32
+    int fd = createReplacing(dest);
+    if (fd < 0) {
+        error = "cannot create " + dest;
+        return false;
+    }
+
+    bool ok = true;
+    uint64_t offset = 0;
+    for (size_t i = 0; ok && i < entries.size(); i++) {
+        const uint8_t* p = chunks[i];
+        size_t len = entries[i].len;
+        if (!isZero(p, len)) ok = writeAll(fd, p, len, offset);
+        offset += len;
+    }
+    if (ok && ::ftruncate(fd, static_cast<off_t>(size)) != 0) ok = false;
+    if (::close(fd) != 0) ok = false;
+#else
+    std::remove(dest.c_str());
+    std::ofstream out(dest, std::ios::binary | std::ios::trunc);
+    for (size_t i = 0; out && i < entries.size(); i++) {
+        out.write(reinterpret_cast<const char*>(chunks[i]), entries[i].len);
+    }
+    bool ok = out.good();
+#endif
+
+    if (!ok) {
+        std::remove(dest.c_str());
+        error = "write to " + dest + " failed";
+    }
+    return ok;
+}
+
+std::vector<std::string> ChunkStore::list() const {
+    std::vector<std::string> names;
+    fs::path root = directory_ + "/recipes";
+    std::error_code ec;
+
+    for (fs::recursive_directory_iterator it(root, ec), end; !ec && it != end; it.increment(ec)) {
+        if (!it->is_regular_file(ec) || it->path().extension() == ".tmp") continue;
+        names.push_back(it->path().lexically_relative(root).generic_string());
+    }
+
+    std::sort(names.begin(), names.end());
+    return names;
+}
+
+bool ChunkStore::stats(StoreStats& out, std::string& error) const {
+    out = StoreStats();
+
+    for (const auto& name : list()) {
+        uint64_t size = 0;
+        std::vector<RecipeEntry> entries;
+        if (!readRecipe(name, size, entries, error)) return false;
+        out.files++;
+        out.logical_bytes += size;
+    }
+
+    out.unique_chunks = index_.size();
+    for (const auto& entry : index_) {
+        out.stored_bytes += entry.second.len;
+    }
+
+    std::error_code ec;
+    for (uint32_t pack = 0; pack < pack_count_; pack++) {
+        uint64_t len = fs::file_size(packPath(pack), ec);
+        out.pack_bytes += ec ? 0 : len;
+    }
+    return true;
+}
+
+} // namespace mmuko
@@ -0,0 +1,130 @@
+/*
+ * riftstore.hpp - MMUKO-OS Deduplicating Image Store
+ *
+ * Image variants share almost all of their bytes (same kernel, different
+ * headers), so files are split with content-defined chunking (FastCDC
+ * gear hash) and each unique chunk is stored once, addressed by SHA-256.
+ *
+ * Layout of a store directory:
+ *   packs/NNNNNNNN.pack   chunk bytes, append-only, read through mmap
+ *   index                 "RIFTIDX1" + {id[32], pack LE32, len LE32, offset LE64}
+ *   recipes/<name>        "RIFTRCP1" + size LE64 + count LE64 + {id[32], len LE32}
+ *
+ * Writers append pack data before index records and publish the recipe
+ * last (temp file + rename), so an interrupted put leaves only unreferenced
+ * pack bytes behind. One writer at a time.
+ */
+
+#ifndef RIFTSTORE_HPP
+#define RIFTSTORE_HPP
+
+#include "riftcache.hpp"
+#include "riftio.hpp"
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace mmuko {
+
+// ============================================================================
+// Content-Defined Chunking
+// ============================================================================
+
+class Chunker {
+public:
+    static constexpr size_t MIN_SIZE = 2 * 1024;
+    static constexpr size_t AVG_SIZE = 8 * 1024;
+    static constexpr size_t MAX_SIZE = 64 * 1024;
+
+    // Length of the chunk starting at `data` (the whole input if shorter
+    // than MIN_SIZE). Cut points depend only on the last 64 bytes, so an
+    // edit shifts at most the chunks around it
+    static size_t next(const uint8_t* data, size_t len);
+};
+
+// ============================================================================
+// Store Statistics
+// ============================================================================
+
+struct PutResult {
+    uint64_t file_bytes;
+    uint64_t chunks;
+    uint64_t new_chunks;
+    uint64_t new_bytes;         // Bytes appended to packs by this put
+
+    PutResult() : file_bytes(0), chunks(0), new_chunks(0), new_bytes(0) {}
+};
+
+struct StoreStats {
+    uint64_t files;
+    uint64_t logical_bytes;     // Sum of stored file sizes
+    uint64_t unique_chunks;
+    uint64_t stored_bytes;      // Sum of unique chunk sizes
+    uint64_t pack_bytes;        // On disk, including unreferenced bytes
+
+    StoreStats() : files(0), logical_bytes(0), unique_chunks(0), stored_bytes(0), pack_bytes(0) {}
+};
+
+// ============================================================================
+// Chunk Store
+// ============================================================================
+
+class ChunkStore {
+public:
+    using ChunkId = Sha256::Digest;
+
+    static constexpr uint64_t PACK_LIMIT = 256ull * 1024 * 1024;
+
+    explicit ChunkStore(std::string directory);
+
+    // Create the layout if missing and load the index
+    bool open(std::string& error);
+
+    // Store `path` under `name` (a relative path), replacing any earlier file
+    bool put(const std::string& name, const std::string& path, PutResult& result,
+             std::string& error);
+
+    // Rebuild `name` at `dest`; all-zero chunks are left as holes
+    bool get(const std::string& name, const std::string& dest, std::string& error);
+
+    std::vector<std::string> list() const;
+    bool stats(StoreStats& out, std::string& error) const;
+
+    const std::string& getDirectory() const { return directory_; }
+
+private:
+    struct Location {
+        uint32_t pack;
+        uint32_t len;
+        uint64_t offset;
+    };
+
+    struct ChunkIdHash {
+        size_t operator()(const ChunkId& id) const;
+    };
+
+    struct RecipeEntry {
+        ChunkId id;
+        uint32_t len;
+    };
+
+    std::string directory_;
+    std::unordered_map<ChunkId, Location, ChunkIdHash> index_;
+    std::vector<std::unique_ptr<MappedFile>> packs_;
+    uint32_t pack_count_;
+    uint64_t last_pack_size_;
+
+    std::string packPath(uint32_t pack) const;
+    std::string recipePath(const std::string& name) const;
+    bool loadIndex(std::string& error);
+    bool readRecipe(const std::string& name, uint64_t& size, std::vector<RecipeEntry>& entries,
+                    std::string& error) const;
+    const uint8_t* chunkData(const Location& location);
+};
+
+} // namespace mmuko
+
+#endif // RIFTSTORE_HPP
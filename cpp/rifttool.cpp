@@ -0,0 +1,587 @@
+/*
+ * rifttool.cpp - MMUKO-OS RiftBridge Command Line Tool
+ *
+ * Command front end for the C++ RiftBridge image utilities
+ *
+ * Commands:
+ *   image  - Build a disk image: MBR, kernel payload at LBA 1, partitions
+ *   audit  - Verify image stores or concatenated volumes in parallel
+ *   scan   - Find RIFT boot sectors in raw devices and disk dumps
+ *   run    - Execute a boot sector in the real-mode interpreter
+ *   fleet  - Personalize one image per device from a template image
+ *   store  - Deduplicating chunk store for image variants and packages
+ */
+
+#include "riftbridge.hpp"
+#include "riftaudit.hpp"
+#include "riftscan.hpp"
+#include "riftcache.hpp"
+#include "riftvm.hpp"
+#include "riftfleet.hpp"
+#include "riftstore.hpp"
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+using namespace mmuko;
+
+namespace {
+
+int usage() {
+    std::cerr << "Usage: rifttool <command> [options]\n"
+                 "\n"
+                 "Commands:\n"
+                 "  image -o <out.img> [--boot <sector.bin>] [--payload <kernel.bin>]\n"
+                 "        [--size <bytes>[K|M|G]] [--partition <type>:<lba>:<sectors>[:boot]]...\n"
+                 "        [--integrity] [--cache <dir>]\n"
+                 "      Build a sparse disk image. Without --boot the RIFT boot sector\n"
+                 "      is generated; the payload is placed at LBA 1 for boot16.s.\n"
+                 "      --integrity stores a CRC32C over the sector and payload sectors.\n"
+                 "      --cache reuses a previously built image with the same inputs.\n"
+                 "  audit [-j <threads>] [--volume <file-or-device> [--stride <bytes>]] [<path>...]\n"
+                 "      Verify every image file under <path> (directories recurse), or\n"
+                 "      every <stride>-byte image of a concatenated volume. Lists the bad\n"
+                 "      images and exits 1 if there are any.\n"
+                 "  scan [--buffer <bytes>] <device-or-file>\n"
+                 "      Stream a raw device or dump and list every 512-byte-aligned\n"
+                 "      RIFT sector with its verification status. Sectors that fail with EIO\n"
+                 "      are skipped and listed as UNREADABLE, and the scan exits 1.\n"
+                 "  run [--steps <n>] [--repeat <n>] [<image>]\n"
+                 "      Execute the boot sector of <image> (default: the built-in RIFT\n"
+                 "      sector) in-process and print its teletype output and halt code.\n"
+                 "      Exits 0 only on hlt with AL = 0x55 (NSIGII_YES).\n"
+                 "  fleet --template <img> --table <devices.csv> -o <dir> [-j <threads>]\n"
+                 "        [--verify]\n"
+                 "      Write <dir>/<name> for every row of name,flags,node_id,message.\n"
+                 "      Only the boot sector differs from the template; integrity\n"
+                 "      templates get their CRC32C patched from the changed bytes.\n"
+                 "  store <dir> put <file>... [--as <name>] | get <name> <out> | ls | stat\n"
+                 "      Content-defined chunk store: each unique chunk of every file is\n"
+                 "      kept once, so image variants cost only their differing chunks.\n"
+                 "      Files are stored under their relative path unless --as names one.\n";
+    return 2;
+}
+
+bool parseNumber(const std::string& text, uint64_t& out) {
+    if (text.empty()) return false;
+
+    char* end = nullptr;
+    unsigned long long value = std::strtoull(text.c_str(), &end, 0);
+    if (end == text.c_str() || *end != '\0') return false;
+
+    out = value;
+    return true;
+}
+
+bool parseSize(std::string text, uint64_t& out) {
+    uint64_t scale = 1;
+    if (!text.empty()) {
+        switch (text.back()) {
+            case 'K': case 'k': scale = 1ull << 10; break;
+            case 'M': case 'm': scale = 1ull << 20; break;
+            case 'G': case 'g': scale = 1ull << 30; break;
+            default: break;
+        }
+        if (scale != 1) text.pop_back();
+    }
+
+    uint64_t value = 0;
+    if (!parseNumber(text, value)) return false;
+
+    out = value * scale;
+    return true;
+}
+
+bool parsePartition(const std::string& text, PartitionEntry& out) {
+    std::vector<std::string> fields;
+    size_t start = 0;
+    while (true) {
+        size_t colon = text.find(':', start);
+        fields.push_back(text.substr(start, colon - start));
+        if (colon == std::string::npos) break;
+        start = colon + 1;
+    }
+
+    if (fields.size() < 3 || fields.size() > 4) return false;
+
+    uint64_t type = 0, lba = 0, sectors = 0;
+    if (!parseNumber(fields[0], type) || type > 0xFF) return false;
+    if (!parseNumber(fields[1], lba) || lba > 0xFFFFFFFFull) return false;
+    if (!parseNumber(fields[2], sectors) || sectors > 0xFFFFFFFFull) return false;
+    if (fields.size() == 4 && fields[3] != "boot") return false;
+
+    out.status = fields.size() == 4 ? PartitionEntry::BOOTABLE : 0x00;
+    out.type = static_cast<uint8_t>(type);
+    out.lba_start = static_cast<uint32_t>(lba);
+    out.sector_count = static_cast<uint32_t>(sectors);
+    return true;
+}
+
+int runImage(const std::vector<std::string>& args) {
+    BootImage image;
+    std::string output;
+    std::string cache_dir;
+
+    for (size_t i = 0; i < args.size(); i++) {
+        const std::string& arg = args[i];
+        if (arg == "--integrity") {
+            image.setIntegrity(true);
+            continue;
+        }
+        if (i + 1 >= args.size()) {
+            std::cerr << "missing value for " << arg << "\n";
+            return usage();
+        }
+        const std::string& value = args[++i];
+
+        if (arg == "-o" || arg == "--output") {
+            output = value;
+        } else if (arg == "--cache") {
+            cache_dir = value;
+        } else if (arg == "--boot") {
+            if (!image.loadBootSector(value)) {
+                std::cerr << "cannot read a 512-byte boot sector from " << value << "\n";
+                return 1;
+            }
+        } else if (arg == "--payload") {
+            if (!image.loadPayload(value)) {
+                std::cerr << "cannot load payload " << value << " (limit "
+                          << BootImage::KERNEL_SECTORS * BootImage::SECTOR_SIZE << " bytes)\n";
+                return 1;
+            }
+        } else if (arg == "--size") {
+            uint64_t size = 0;
+            if (!parseSize(value, size) || !image.setDiskSize(size)) {
+                std::cerr << "invalid disk size: " << value << "\n";
+                return 1;
+            }
+        } else if (arg == "--partition") {
+            PartitionEntry entry{};
+            if (!parsePartition(value, entry)) {
+                std::cerr << "invalid partition spec: " << value << "\n";
+                return usage();
+            }
+            if (!image.addPartition(entry)) {
+                std::cerr << "partition " << value << " overlaps the kernel area, "
+                          << "another partition, or exceeds " << BootImage::MAX_PARTITIONS
+                          << " entries\n";
+                return 1;
+            }
+        } else {
+            std::cerr << "unknown option: " << arg << "\n";
+            return usage();
+        }
+    }
+
+    if (output.empty()) {
+        std::cerr << "image: -o <out.img> is required\n";
+        return usage();
+    }
+    if (!image.getPartitions().empty() && image.hasCustomPartitionTable()) {
+        std::cerr << "the --boot sector already has a partition table; "
+                  << "clear bytes " << BootImage::PARTITION_TABLE_OFFSET << "-"
+                  << BootImage::PARTITION_TABLE_OFFSET +
+                         BootImage::MAX_PARTITIONS * PartitionEntry::ENTRY_SIZE - 1
+                  << " to use --partition\n";
+        return 1;
+    }
+
+    if (image.hasIntegrity() && image.hasCustomIntegrityArea()) {
+        std::cerr << "the --boot sector has data in the integrity record area; "
+                  << "clear bytes " << BootImage::INTEGRITY_OFFSET << "-"
+                  << BootImage::INTEGRITY_OFFSET + BootImage::INTEGRITY_SIZE - 1
+                  << " to use --integrity\n";
+        return 1;
+    }
+
+    if (image.getDiskSize() < image.getMinimumDiskSize()) {
+        std::cerr << "disk size " << image.getDiskSize() << " is below the layout minimum "
+                  << image.getMinimumDiskSize() << "\n";
+        return 1;
+    }
+
+    // Disk images are often booted read-write, so never hard-link them
+    bool hit = false;
+    bool ok = cache_dir.empty() ? image.generate(output)
+                                : image.generate(output, ArtifactCache(cache_dir, false), &hit);
+    if (!ok) {
+        std::cerr << "failed to write " << output
+                  << (image.hasIntegrity() ? " (integrity mode needs a RIFT boot sector)" : "")
+                  << "\n";
+        return 1;
+    }
+
+    std::cout << (hit ? "Cached " : "Built ") << output << " (" << image.getDiskSize() << " bytes, "
+              << image.getPayload().size() << " payload bytes, "
+              << image.getPartitions().size() << " partitions)\n";
+    return 0;
+}
+
+void printFindings(const AuditReport& report, bool with_offset) {
+    for (const auto& finding : report.bad) {
+        std::cout << "BAD " << finding.path;
+        if (with_offset) std::cout << "@" << finding.offset;
+        switch (finding.error) {
+            case AuditError::NONE: std::cout << " " << BootImage::statusName(finding.status); break;
+            case AuditError::UNREADABLE: std::cout << " UNREADABLE"; break;
+            case AuditError::BAD_STRIDE: std::cout << " BAD_STRIDE"; break;
+        }
+        std::cout << "\n";
+    }
+}
+
+int runAudit(const std::vector<std::string>& args) {
+    unsigned threads = 0;
+    std::string volume;
+    uint64_t stride = BootImage::SECTOR_SIZE;
+    std::vector<std::string> roots;
+
+    for (size_t i = 0; i < args.size(); i++) {
+        const std::string& arg = args[i];
+        if (arg == "-j" || arg == "--volume" || arg == "--stride") {
+            if (i + 1 >= args.size()) {
+                std::cerr << "missing value for " << arg << "\n";
+                return usage();
+            }
+            const std::string& value = args[++i];
+            uint64_t number = 0;
+
+            if (arg == "--volume") {
+                volume = value;
+            } else if (!parseSize(value, number) || number == 0) {
+                std::cerr << "invalid value for " << arg << ": " << value << "\n";
+                return usage();
+            } else if (arg == "-j") {
+                threads = static_cast<unsigned>(number);
+            } else {
+                stride = number;
+            }
+        } else {
+            roots.push_back(arg);
+        }
+    }
+
+    if (volume.empty() && roots.empty()) {
+        std::cerr << "audit: give image paths or --volume <file>\n";
+        return usage();
+    }
+    if (stride < BootImage::SECTOR_SIZE) {
+        std::cerr << "audit: --stride must be at least " << BootImage::SECTOR_SIZE << "\n";
+        return 1;
+    }
+
+    FleetAuditor auditor(threads);
+    auto started = std::chrono::steady_clock::now();
+
+    AuditReport report;
+    if (!volume.empty()) {
+        report = auditor.auditVolume(volume, static_cast<size_t>(stride));
+        printFindings(report, true);
+    }
+    if (!roots.empty()) {
+        AuditReport files = auditor.auditFiles(FleetAuditor::collectImages(roots));
+        printFindings(files, false);
+        report.images_checked += files.images_checked;
+        report.bytes_scanned += files.bytes_scanned;
+        report.bad.insert(report.bad.end(), files.bad.begin(), files.bad.end());
+    }
+
+    double seconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - started).count();
+    std::cout << "Audited " << report.images_checked << " images ("
+              << report.bytes_scanned / (1024.0 * 1024.0) << " MiB) on "
+              << auditor.getThreadCount() << " threads in " << seconds * 1000.0 << " ms: "
+              << report.bad.size() << " bad\n";
+
+    return report.bad.empty() ? 0 : 1;
+}
+
+int runScan(const std::vector<std::string>& args) {
+    uint64_t buffer = SectorScanner::DEFAULT_BUFFER;
+    std::string path;
+
+    for (size_t i = 0; i < args.size(); i++) {
+        if (args[i] == "--buffer") {
+            if (i + 1 >= args.size() || !parseSize(args[++i], buffer) || buffer == 0) {
+                std::cerr << "invalid value for --buffer\n";
+                return usage();
+            }
+        } else if (path.empty()) {
+            path = args[i];
+        } else {
+            std::cerr << "scan: only one device or file per run\n";
+            return usage();
+        }
+    }
+
+    if (path.empty()) {
+        std::cerr << "scan: give a device or file\n";
+        return usage();
+    }
+
+    SectorScanner scanner(static_cast<size_t>(buffer));
+    ScanReport report;
+    auto started = std::chrono::steady_clock::now();
+
+    bool ok = scanner.scan(path, report, [](const ScanHit& hit) {
+        std::cout << "RIFT @" << hit.offset << " LBA " << hit.offset / BootImage::SECTOR_SIZE
+                  << " " << BootImage::statusName(hit.status) << "\n";
+    });
+    for (const auto& gap : report.unreadable) {
+        std::cout << "UNREADABLE @" << gap.offset << " LBA " << gap.offset / BootImage::SECTOR_SIZE
+                  << " " << gap.length << " bytes\n";
+    }
+    if (!ok) {
+        std::cerr << "cannot read " << path << " past byte " << report.bytes_scanned << ": "
+                  << std::strerror(report.error) << "\n";
+        return 1;
+    }
+
+    double seconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - started).count();
+    std::cout << "Scanned " << report.bytes_scanned / (1024.0 * 1024.0) << " MiB in "
+              << seconds * 1000.0 << " ms ("
+              << (seconds > 0 ? report.bytes_scanned / seconds / 1e9 : 0.0) << " GB/s, "
+              << (SectorScanner::vectorized() ? "AVX2" : "scalar") << "): "
+              << report.hits.size() << " RIFT sectors, " << report.unreadable.size()
+              << " unreadable ranges\n";
+    return report.unreadable.empty() ? 0 : 1;
+}
+
+int runBoot(const std::vector<std::string>& args) {
+    uint64_t steps = RealModeVM::DEFAULT_STEP_LIMIT;
+    uint64_t repeat = 1;
+    std::string path;
+
+    for (size_t i = 0; i < args.size(); i++) {
+        if (args[i] == "--steps" || args[i] == "--repeat") {
+            uint64_t& target = args[i] == "--steps" ? steps : repeat;
+            if (i + 1 >= args.size() || !parseNumber(args[++i], target) || target == 0) {
+                std::cerr << "invalid value for " << args[i - 1] << "\n";
+                return usage();
+            }
+        } else if (path.empty()) {
+            path = args[i];
+        } else {
+            std::cerr << "run: only one image per run\n";
+            return usage();
+        }
+    }
+
+    std::vector<uint8_t> sector(BootImage::bootSector().begin(), BootImage::bootSector().end());
+    if (!path.empty()) {
+        std::ifstream file(path, std::ios::binary);
+        file.read(reinterpret_cast<char*>(sector.data()), static_cast<std::streamsize>(sector.size()));
+        if (file.gcount() != static_cast<std::streamsize>(sector.size())) {
+            std::cerr << "cannot read a 512-byte boot sector from " << path << "\n";
+            return 1;
+        }
+    }
+
+    RealModeVM vm;
+    RunResult result;
+    auto started = std::chrono::steady_clock::now();
+    for (uint64_t n = 0; n < repeat; n++) {
+        vm.load(sector.data(), sector.size());
+        result = vm.run(steps);
+    }
+    double seconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - started).count();
+
+    std::cout << result.output;
+    if (!result.output.empty() && result.output.back() != '\n') std::cout << "\n";
+
+    char code[8];
+    std::snprintf(code, sizeof(code), "0x%02X", result.reason == StopReason::HALTED
+                                                   ? result.halt_code : result.opcode);
+    std::cout << RealModeVM::reasonName(result.reason)
+              << (result.reason == StopReason::HALTED ? " AL=" : " opcode=") << code
+              << " at 0000:" << std::hex << result.stop_ip << std::dec
+              << " after " << result.steps << " steps";
+    if (repeat > 1) {
+        std::cout << " (" << repeat << " runs, " << seconds * 1e6 / repeat << " us/run)";
+    }
+    std::cout << "\n";
+
+    return result.reason == StopReason::HALTED && result.halt_code == 0x55 ? 0 : 1;
+}
+
+int runFleet(const std::vector<std::string>& args) {
+    unsigned threads = 0;
+    bool verify = false;
+    std::string template_path;
+    std::string table_path;
+    std::string out_dir;
+
+    for (size_t i = 0; i < args.size(); i++) {
+        const std::string& arg = args[i];
+        if (arg == "--verify") {
+            verify = true;
+            continue;
+        }
+        if (arg != "--template" && arg != "--table" && arg != "-o" && arg != "-j") {
+            std::cerr << "unknown option: " << arg << "\n";
+            return usage();
+        }
+        if (i + 1 >= args.size()) {
+            std::cerr << "missing value for " << arg << "\n";
+            return usage();
+        }
+        const std::string& value = args[++i];
+        uint64_t number = 0;
+
+        if (arg == "--template") {
+            template_path = value;
+        } else if (arg == "--table") {
+            table_path = value;
+        } else if (arg == "-o") {
+            out_dir = value;
+        } else if (!parseSize(value, number) || number == 0) {
+            std::cerr << "invalid value for -j: " << value << "\n";
+            return usage();
+        } else {
+            threads = static_cast<unsigned>(number);
+        }
+    }
+
+    if (template_path.empty() || table_path.empty() || out_dir.empty()) {
+        std::cerr << "fleet: --template, --table and -o are required\n";
+        return usage();
+    }
+
+    FleetProvisioner provisioner(threads);
+    std::vector<DeviceSpec> devices;
+    std::string error;
+    if (!provisioner.loadTemplate(template_path, error) ||
+        !FleetProvisioner::loadTable(table_path, devices, error)) {
+        std::cerr << error << "\n";
+        return 1;
+    }
+
+    auto started = std::chrono::steady_clock::now();
+    ProvisionReport report = provisioner.provision(devices, out_dir, verify);
+    double seconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - started).count();
+
+    for (const auto& failure : report.errors) {
+        std::cerr << "ERROR " << failure.name << ": " << failure.message << "\n";
+    }
+    std::cout << "Wrote " << report.images_written << " of " << devices.size()
+              << " images to " << out_dir << " in " << seconds << " s ("
+              << provisioner.getThreadCount() << " threads"
+              << (provisioner.hasIntegrity() ? ", integrity" : "") << ")\n";
+
+    return report.errors.empty() ? 0 : 1;
+}
+
+int runStore(const std::vector<std::string>& args) {
+    if (args.size() < 2) {
+        std::cerr << "store: give a store directory and put, get, ls or stat\n";
+        return usage();
+    }
+
+    ChunkStore store(args[0]);
+    const std::string& action = args[1];
+    std::string error;
+    if (!store.open(error)) {
+        std::cerr << error << "\n";
+        return 1;
+    }
+
+    if (action == "put") {
+        std::string as;
+        std::vector<std::string> files;
+        for (size_t i = 2; i < args.size(); i++) {
+            if (args[i] == "--as" && i + 1 < args.size()) {
+                as = args[++i];
+            } else {
+                files.push_back(args[i]);
+            }
+        }
+        if (files.empty() || (!as.empty() && files.size() != 1)) {
+            std::cerr << "store put: give files, or one file with --as <name>\n";
+            return usage();
+        }
+
+        for (const auto& file : files) {
+            // Absolute paths are stored without their leading '/'
+            std::string name = as.empty() ? std::filesystem::path(file).relative_path().string() : as;
+            PutResult result;
+            if (!store.put(name, file, result, error)) {
+                std::cerr << error << "\n";
+                return 1;
+            }
+            std::cout << "Stored " << name << ": " << result.file_bytes
+                      << " bytes, " << result.chunks << " chunks, " << result.new_chunks
+                      << " new (" << result.new_bytes << " bytes added)\n";
+        }
+        return 0;
+    }
+
+    if (action == "get") {
+        if (args.size() != 4) {
+            std::cerr << "store get: give <name> <out>\n";
+            return usage();
+        }
+        if (!store.get(args[2], args[3], error)) {
+            std::cerr << error << "\n";
+            return 1;
+        }
+        return 0;
+    }
+
+    if (action == "ls") {
+        for (const auto& name : store.list()) {
+            std::cout << name << "\n";
+        }
+        return 0;
+    }
+
+    if (action == "stat") {
+        StoreStats stats;
+        if (!store.stats(stats, error)) {
+            std::cerr << error << "\n";
+            return 1;
+        }
+        double ratio = stats.stored_bytes > 0
+                     ? static_cast<double>(stats.logical_bytes) / stats.stored_bytes : 0.0;
+        std::cout << "Files:   " << stats.files << " (" << stats.logical_bytes << " bytes)\n"
+                  << "Chunks:  " << stats.unique_chunks << " unique (" << stats.stored_bytes
+                  << " bytes)\n"
+                  << "Packs:   " << stats.pack_bytes << " bytes\n"
+                  << "Dedup:   " << ratio << "x\n";
+        return 0;
+    }
+
+    std::cerr << "store: unknown action " << action << "\n";
+    return usage();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2) return usage();
+
+    std::string command = argv[1];
+    std::vector<std::string> args(argv + 2, argv + argc);
+
+    if (command == "image") return runImage(args);
+    if (command == "audit") return runAudit(args);
+    if (command == "scan") return runScan(args);
+    if (command == "run") return runBoot(args);
+    if (command == "fleet") return runFleet(args);
+    if (command == "store") return runStore(args);
+    if (command == "help" || command == "--help" || command == "-h") {
+        usage();
+        return 0;
+    }
+
+    std::cerr << "unknown command: " << command << "\n\n";
+    return usage();
+}
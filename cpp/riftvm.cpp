@@ -0,0 +1,504 @@
+/*
+ * riftvm.cpp - MMUKO-OS Real-Mode Boot Sector Interpreter Implementation
+ */
+
+#include "riftvm.hpp"
+#include <cstring>
+
+namespace mmuko {
+
+namespace {
+
+constexpr int NO_OVERRIDE = -1;
+
+// ALU group operation numbers (opcode bits 5:3 and the /r of 0x80-0x83)
+enum AluOp : uint8_t { ADD = 0, OR, ADC, SBB, AND, SUB, XOR, CMP };
+
+inline bool parity(uint8_t value) {
+    value ^= value >> 4;
+    value ^= value >> 2;
+    value ^= value >> 1;
+    return (value & 1) == 0;
+}
+
+} // namespace
+
+// ============================================================================
+// Memory
+// ============================================================================
+
+RealModeVM::RealModeVM()
+    : cpu_{}, memory_(MEMORY_SIZE, 0), page_dirty_(MEMORY_SIZE / PAGE_SIZE, false),
+      segment_override_(NO_OVERRIDE) {}
+
+uint32_t RealModeVM::linear(uint16_t segment, uint16_t offset) const {
+    return (static_cast<uint32_t>(segment) * 16 + offset) & (MEMORY_SIZE - 1);
+}
+
+uint8_t RealModeVM::read8(uint32_t address) const {
+    return memory_[address & (MEMORY_SIZE - 1)];
+}
+
+uint16_t RealModeVM::read16(uint32_t address) const {
+    return static_cast<uint16_t>(read8(address) | read8(address + 1) << 8);
+}
+
+void RealModeVM::write8(uint32_t address, uint8_t value) {
+    address &= MEMORY_SIZE - 1;
+    markDirty(address);
+    memory_[address] = value;
+}
+
+// Pages, not addresses: a loop storing to the stack must not grow the list
+void RealModeVM::markDirty(uint32_t address) {
+    uint32_t page = address / PAGE_SIZE;
+    if (page_dirty_[page]) return;
+    page_dirty_[page] = true;
+    dirty_.push_back(page);
+}
+
+void RealModeVM::write16(uint32_t address, uint16_t value) {
+    write8(address, static_cast<uint8_t>(value));
+    write8(address + 1, static_cast<uint8_t>(value >> 8));
+}
+
+bool RealModeVM::load(const uint8_t* sector, size_t len, uint8_t boot_drive) {
+    if (len == 0 || len > 0x10000 - LOAD_ADDRESS) return false;
+
+    for (uint32_t page : dirty_) {
+        std::memset(memory_.data() + page * PAGE_SIZE, 0, PAGE_SIZE);
+        page_dirty_[page] = false;
+    }
+    dirty_.clear();
+    std::memcpy(memory_.data() + LOAD_ADDRESS, sector, len);
+
+    // Loaded bytes count as written so the next load clears them too
+    for (size_t i = 0; i < len; i += PAGE_SIZE) {
+        markDirty(static_cast<uint32_t>(LOAD_ADDRESS + i));
+    }
+    markDirty(static_cast<uint32_t>(LOAD_ADDRESS + len - 1));
+
+    // BIOS handoff: 0000:7C00, DL = boot drive, interrupts enabled
+    std::memset(&cpu_, 0, sizeof(cpu_));
+    cpu_.regs[CpuState::DX] = boot_drive;
+    cpu_.regs[CpuState::SP] = LOAD_ADDRESS;
+    cpu_.ip = LOAD_ADDRESS;
+    cpu_.flags = 0x0002 | CpuState::IF;
+    return true;
+}
+
+// ============================================================================
+// Decoding
+// ============================================================================
+
+uint8_t RealModeVM::fetch8() {
+    uint8_t value = read8(linear(cpu_.sregs[CpuState::CS], cpu_.ip));
+    cpu_.ip++;
+    return value;
+}
+
+uint16_t RealModeVM::fetch16() {
+    uint16_t lo = fetch8();
+    return static_cast<uint16_t>(lo | fetch8() << 8);
+}
+
+RealModeVM::Operand RealModeVM::decodeModRM() {
+    uint8_t byte = fetch8();
+    uint8_t mod = byte >> 6;
+
+    Operand op{};
+    op.reg = (byte >> 3) & 7;
+    op.rm = byte & 7;
+    if (mod == 3) {
+        op.is_reg = true;
+        return op;
+    }
+
+    const uint16_t* r = cpu_.regs;
+    uint16_t offset = 0;
+    int segment = CpuState::DS;
+
+    switch (op.rm) {
+        case 0: offset = static_cast<uint16_t>(r[CpuState::BX] + r[CpuState::SI]); break;
+        case 1: offset = static_cast<uint16_t>(r[CpuState::BX] + r[CpuState::DI]); break;
+        case 2: offset = static_cast<uint16_t>(r[CpuState::BP] + r[CpuState::SI]); segment = CpuState::SS; break;
+        case 3: offset = static_cast<uint16_t>(r[CpuState::BP] + r[CpuState::DI]); segment = CpuState::SS; break;
+        case 4: offset = r[CpuState::SI]; break;
+        case 5: offset = r[CpuState::DI]; break;
+        case 6:
+            if (mod == 0) {
+                offset = fetch16();     // [disp16]
+            } else {
+                offset = r[CpuState::BP];
+                segment = CpuState::SS;
+            }
+            break;
+        case 7: offset = r[CpuState::BX]; break;
+    }
+
+    if (mod == 1) {
+        offset = static_cast<uint16_t>(offset + static_cast<int8_t>(fetch8()));
+    } else if (mod == 2) {
+        offset = static_cast<uint16_t>(offset + fetch16());
+    }
+
+    if (segment_override_ != NO_OVERRIDE) segment = segment_override_;
+    op.address = linear(cpu_.sregs[segment], offset);
+    return op;
+}
+
+// ============================================================================
+// Register and Operand Access
+// ============================================================================
+
+uint8_t RealModeVM::getReg8(uint8_t reg) const {
+    uint16_t value = cpu_.regs[reg & 3];
+    return static_cast<uint8_t>(reg < 4 ? value : value >> 8);
+}
+
+void RealModeVM::setReg8(uint8_t reg, uint8_t value) {
+    uint16_t& r = cpu_.regs[reg & 3];
+    r = reg < 4 ? static_cast<uint16_t>((r & 0xFF00) | value)
+                : static_cast<uint16_t>((r & 0x00FF) | value << 8);
+}
+
+uint8_t RealModeVM::readRM8(const Operand& op) const {
+    return op.is_reg ? getReg8(op.rm) : read8(op.address);
+}
+
+uint16_t RealModeVM::readRM16(const Operand& op) const {
+    return op.is_reg ? cpu_.regs[op.rm] : read16(op.address);
+}
+
+void RealModeVM::writeRM8(const Operand& op, uint8_t value) {
+    if (op.is_reg) setReg8(op.rm, value);
+    else write8(op.address, value);
+}
+
+void RealModeVM::writeRM16(const Operand& op, uint16_t value) {
+    if (op.is_reg) cpu_.regs[op.rm] = value;
+    else write16(op.address, value);
+}
+
+void RealModeVM::push(uint16_t value) {
+    cpu_.regs[CpuState::SP] = static_cast<uint16_t>(cpu_.regs[CpuState::SP] - 2);
+    write16(linear(cpu_.sregs[CpuState::SS], cpu_.regs[CpuState::SP]), value);
+}
+
+uint16_t RealModeVM::pop() {
+    uint16_t value = read16(linear(cpu_.sregs[CpuState::SS], cpu_.regs[CpuState::SP]));
+    cpu_.regs[CpuState::SP] = static_cast<uint16_t>(cpu_.regs[CpuState::SP] + 2);
+    return value;
+}
+
+// ============================================================================
+// Arithmetic and Flags
+// ============================================================================
+
+void RealModeVM::setResultFlags(uint32_t result, bool wide) {
+    uint32_t mask = wide ? 0xFFFF : 0xFF;
+    uint32_t sign = wide ? 0x8000 : 0x80;
+
+    cpu_.flags &= static_cast<uint16_t>(~(CpuState::ZF | CpuState::SF | CpuState::PF));
+    if ((result & mask) == 0) cpu_.flags |= CpuState::ZF;
+    if (result & sign) cpu_.flags |= CpuState::SF;
+    if (parity(static_cast<uint8_t>(result))) cpu_.flags |= CpuState::PF;
+}
+
+uint32_t RealModeVM::alu(uint8_t op, uint32_t a, uint32_t b, bool wide) {
+    uint32_t mask = wide ? 0xFFFF : 0xFF;
+    uint32_t sign = wide ? 0x8000 : 0x80;
+    uint32_t carry_in = (cpu_.flags & CpuState::CF) ? 1 : 0;
+    uint32_t result = 0;
+    bool cf = false, of = false, af = false;
+
+    switch (op) {
+        case ADD:
+        case ADC: {
+            uint32_t c = op == ADC ? carry_in : 0;
+            result = a + b + c;
+            cf = result > mask;
+            of = ((a ^ result) & (b ^ result) & sign) != 0;
+            af = ((a ^ b ^ result) & 0x10) != 0;
+            break;
+        }
+        case SUB:
+        case SBB:
+        case CMP: {
+            uint32_t c = op == SBB ? carry_in : 0;
+            result = a - b - c;
+            cf = b + c > a;
+            of = ((a ^ b) & (a ^ result) & sign) != 0;
+            af = ((a ^ b ^ result) & 0x10) != 0;
+            break;
+        }
+        case OR:  result = a | b; break;
+        case AND: result = a & b; break;
+        case XOR: result = a ^ b; break;
+    }
+
+    result &= mask;
+    cpu_.flags &= static_cast<uint16_t>(~(CpuState::CF | CpuState::OF | CpuState::AF));
+    if (cf) cpu_.flags |= CpuState::CF;
+    if (of) cpu_.flags |= CpuState::OF;
+    if (af) cpu_.flags |= CpuState::AF;
+    setResultFlags(result, wide);
+    return result;
+}
+
+// inc/dec leave CF alone
+uint32_t RealModeVM::incdec(uint32_t a, bool dec, bool wide) {
+    uint16_t saved_cf = cpu_.flags & CpuState::CF;
+    uint32_t result = alu(dec ? SUB : ADD, a, 1, wide);
+    cpu_.flags = static_cast<uint16_t>((cpu_.flags & ~CpuState::CF) | saved_cf);
+    return result;
+}
+
+bool RealModeVM::condition(uint8_t cc) const {
+    uint16_t f = cpu_.flags;
+    bool cf = f & CpuState::CF, zf = f & CpuState::ZF, sf = f & CpuState::SF;
+    bool of = f & CpuState::OF, pf = f & CpuState::PF;
+
+    bool result = false;
+    switch (cc >> 1) {
+        case 0: result = of; break;                 // jo
+        case 1: result = cf; break;                 // jb
+        case 2: result = zf; break;                 // jz
+        case 3: result = cf || zf; break;           // jbe
+        case 4: result = sf; break;                 // js
+        case 5: result = pf; break;                 // jp
+        case 6: result = sf != of; break;           // jl
+        case 7: result = zf || sf != of; break;     // jle
+    }
+    return (cc & 1) ? !result : result;
+}
+
+// ============================================================================
+// Execution
+// ============================================================================
+
+RunResult RealModeVM::run(uint64_t step_limit) {
+    RunResult result;
+    uint16_t* r = cpu_.regs;
+
+    for (;;) {
+        if (result.steps >= step_limit) {
+            result.reason = StopReason::STEP_LIMIT;
+            result.stop_ip = cpu_.ip;
+            result.opcode = read8(linear(cpu_.sregs[CpuState::CS], cpu_.ip));
+            return result;
+        }
+
+        uint16_t start_ip = cpu_.ip;
+        segment_override_ = NO_OVERRIDE;
+        uint8_t opcode = fetch8();
+
+        // Segment override prefixes
+        while (opcode == 0x26 || opcode == 0x2E || opcode == 0x36 || opcode == 0x3E) {
+            segment_override_ = (opcode >> 3) & 3;
+            opcode = fetch8();
+        }
+
+        result.steps++;
+        result.stop_ip = start_ip;
+        result.opcode = opcode;
+
+        // ALU group: op r/m,r / op r,r/m / op al|ax,imm
+        if (opcode < 0x40 && (opcode & 7) < 6) {
+            uint8_t op = opcode >> 3;
+            bool wide = opcode & 1;
+            switch (opcode & 7) {
+                case 0: case 1: {
+                    Operand m = decodeModRM();
+                    uint32_t a = wide ? readRM16(m) : readRM8(m);
+                    uint32_t b = wide ? r[m.reg] : getReg8(m.reg);
+                    uint32_t v = alu(op, a, b, wide);
+                    if (op != CMP) {
+                        if (wide) writeRM16(m, static_cast<uint16_t>(v));
+                        else writeRM8(m, static_cast<uint8_t>(v));
+                    }
+                    break;
+                }
+                case 2: case 3: {
+                    Operand m = decodeModRM();
+                    uint32_t a = wide ? r[m.reg] : getReg8(m.reg);
+                    uint32_t b = wide ? readRM16(m) : readRM8(m);
+                    uint32_t v = alu(op, a, b, wide);
+                    if (op != CMP) {
+                        if (wide) r[m.reg] = static_cast<uint16_t>(v);
+                        else setReg8(m.reg, static_cast<uint8_t>(v));
+                    }
+                    break;
+                }
+                case 4: {
+                    uint32_t v = alu(op, getReg8(0), fetch8(), false);
+                    if (op != CMP) setReg8(0, static_cast<uint8_t>(v));
+                    break;
+                }
+                case 5: {
+                    uint32_t v = alu(op, r[CpuState::AX], fetch16(), true);
+                    if (op != CMP) r[CpuState::AX] = static_cast<uint16_t>(v);
+                    break;
+                }
+            }
+            continue;
+        }
+
+        switch (opcode) {
+            case 0x40: case 0x41: case 0x42: case 0x43:
+            case 0x44: case 0x45: case 0x46: case 0x47:
+                r[opcode & 7] = static_cast<uint16_t>(incdec(r[opcode & 7], false, true));
+                break;
+
+            case 0x48: case 0x49: case 0x4A: case 0x4B:
+            case 0x4C: case 0x4D: case 0x4E: case 0x4F:
+                r[opcode & 7] = static_cast<uint16_t>(incdec(r[opcode & 7], true, true));
+                break;
+
+            case 0x50: case 0x51: case 0x52: case 0x53:
+            case 0x54: case 0x55: case 0x56: case 0x57:
+                // 8086 semantics differ for push sp; 286+ pushes the old value
+                push(r[opcode & 7]);
+                break;
+
+            case 0x58: case 0x59: case 0x5A: case 0x5B:
+            case 0x5C: case 0x5D: case 0x5E: case 0x5F:
+                r[opcode & 7] = pop();
+                break;
+
+            case 0x70: case 0x71: case 0x72: case 0x73:
+            case 0x74: case 0x75: case 0x76: case 0x77:
+            case 0x78: case 0x79: case 0x7A: case 0x7B:
+            case 0x7C: case 0x7D: case 0x7E: case 0x7F: {
+                int8_t rel = static_cast<int8_t>(fetch8());
+                if (condition(opcode & 0x0F)) cpu_.ip = static_cast<uint16_t>(cpu_.ip + rel);
+                break;
+            }
+
+            case 0x80: case 0x81: case 0x83: {
+                bool wide = opcode != 0x80;
+                Operand m = decodeModRM();
+                uint32_t a = wide ? readRM16(m) : readRM8(m);
+                uint32_t b = opcode == 0x81 ? fetch16()
+                           : opcode == 0x83 ? static_cast<uint16_t>(static_cast<int8_t>(fetch8()))
+                                            : fetch8();
+                uint32_t v = alu(m.reg, a, b, wide);
+                if (m.reg != CMP) {
+                    if (wide) writeRM16(m, static_cast<uint16_t>(v));
+                    else writeRM8(m, static_cast<uint8_t>(v));
+                }
+                break;
+            }
+
+            case 0x88: { Operand m = decodeModRM(); writeRM8(m, getReg8(m.reg)); break; }
+            case 0x89: { Operand m = decodeModRM(); writeRM16(m, r[m.reg]); break; }
+            case 0x8A: { Operand m = decodeModRM(); setReg8(m.reg, readRM8(m)); break; }
+            case 0x8B: { Operand m = decodeModRM(); r[m.reg] = readRM16(m); break; }
+            case 0x8C: { Operand m = decodeModRM(); writeRM16(m, cpu_.sregs[m.reg & 3]); break; }
+            case 0x8E: {
+                Operand m = decodeModRM();
+                if ((m.reg & 3) == CpuState::CS) {
+                    result.reason = StopReason::BAD_OPCODE;     // mov cs is undefined
+                    return result;
+                }
+                cpu_.sregs[m.reg & 3] = readRM16(m);
+                break;
+            }
+
+            case 0x90:
+                break;
+
+            case 0xAC:
+            case 0xAD: {
+                int segment = segment_override_ != NO_OVERRIDE ? segment_override_ : CpuState::DS;
+                uint32_t address = linear(cpu_.sregs[segment], r[CpuState::SI]);
+                int step = opcode == 0xAC ? 1 : 2;
+                if (opcode == 0xAC) setReg8(0, read8(address));
+                else r[CpuState::AX] = read16(address);
+                r[CpuState::SI] = static_cast<uint16_t>(r[CpuState::SI] +
+                                                        ((cpu_.flags & CpuState::DF) ? -step : step));
+                break;
+            }
+
+            case 0xB0: case 0xB1: case 0xB2: case 0xB3:
+            case 0xB4: case 0xB5: case 0xB6: case 0xB7:
+                setReg8(opcode & 7, fetch8());
+                break;
+
+            case 0xB8: case 0xB9: case 0xBA: case 0xBB:
+            case 0xBC: case 0xBD: case 0xBE: case 0xBF:
+                r[opcode & 7] = fetch16();
+                break;
+
+            case 0xC3:
+                cpu_.ip = pop();
+                break;
+
+            case 0xCD: {
+                uint8_t vector = fetch8();
+                if (vector != 0x10 || getReg8(4) != 0x0E) {
+                    result.reason = StopReason::BAD_INTERRUPT;
+                    return result;
+                }
+                result.output.push_back(static_cast<char>(getReg8(0)));
+                break;
+            }
+
+            case 0xE8: {
+                uint16_t rel = fetch16();
+                push(cpu_.ip);
+                cpu_.ip = static_cast<uint16_t>(cpu_.ip + rel);
+                break;
+            }
+
+            case 0xE9: {
+                uint16_t rel = fetch16();
+                cpu_.ip = static_cast<uint16_t>(cpu_.ip + rel);
+                break;
+            }
+
+            case 0xEB: {
+                int8_t rel = static_cast<int8_t>(fetch8());
+                cpu_.ip = static_cast<uint16_t>(cpu_.ip + rel);
+                break;
+            }
+
+            case 0xF4:
+                // No interrupt sources are modelled, so hlt always ends the run
+                result.reason = StopReason::HALTED;
+                result.halt_code = getReg8(0);
+                return result;
+
+            case 0xFA: cpu_.flags &= static_cast<uint16_t>(~CpuState::IF); break;
+            case 0xFB: cpu_.flags |= CpuState::IF; break;
+            case 0xFC: cpu_.flags &= static_cast<uint16_t>(~CpuState::DF); break;
+            case 0xFD: cpu_.flags |= CpuState::DF; break;
+
+            case 0xFE: {
+                Operand m = decodeModRM();
+                if (m.reg > 1) {
+                    result.reason = StopReason::BAD_OPCODE;
+                    return result;
+                }
+                writeRM8(m, static_cast<uint8_t>(incdec(readRM8(m), m.reg == 1, false)));
+                break;
+            }
+
+            default:
+                result.reason = StopReason::BAD_OPCODE;
+                return result;
+        }
+    }
+}
+
+const char* RealModeVM::reasonName(StopReason reason) {
+    switch (reason) {
+        case StopReason::HALTED:        return "HALTED";
+        case StopReason::STEP_LIMIT:    return "STEP_LIMIT";
+        case StopReason::BAD_OPCODE:    return "BAD_OPCODE";
+        case StopReason::BAD_INTERRUPT: return "BAD_INTERRUPT";
+    }
+    return "UNKNOWN";
+}
+
+} // namespace mmuko
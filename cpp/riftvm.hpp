@@ -0,0 +1,137 @@
+/*
+ * riftvm.hpp - MMUKO-OS Real-Mode Boot Sector Interpreter
+ *
+ * Runs a 512-byte boot sector in-process the way a BIOS would hand it over
+ * (CS:IP = 0000:7C00, DL = boot drive) and captures its int 0x10 teletype
+ * output and the AL value at hlt. Covers the 16-bit subset the RIFT sectors
+ * use, including the RIFT header itself, which executes as code:
+ *   push/pop/inc/dec r16, the ALU group (add/or/adc/sbb/and/sub/xor/cmp),
+ *   inc/dec r/m8, mov (reg, imm, sreg, memory), lodsb/lodsw, jcc/jmp/call/
+ *   ret, cli/sti/cld/std, hlt, int 0x10 AH=0x0E, segment override prefixes
+ */
+
+#ifndef RIFTVM_HPP
+#define RIFTVM_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace mmuko {
+
+// ============================================================================
+// CPU State
+// ============================================================================
+
+struct CpuState {
+    enum Reg : uint8_t { AX = 0, CX, DX, BX, SP, BP, SI, DI };
+    enum SReg : uint8_t { ES = 0, CS, SS, DS };
+
+    static constexpr uint16_t CF = 0x0001;
+    static constexpr uint16_t PF = 0x0004;
+    static constexpr uint16_t AF = 0x0010;
+    static constexpr uint16_t ZF = 0x0040;
+    static constexpr uint16_t SF = 0x0080;
+    static constexpr uint16_t IF = 0x0200;
+    static constexpr uint16_t DF = 0x0400;
+    static constexpr uint16_t OF = 0x0800;
+
+    uint16_t regs[8];
+    uint16_t sregs[4];
+    uint16_t ip;
+    uint16_t flags;
+};
+
+// ============================================================================
+// Run Result
+// ============================================================================
+
+enum class StopReason : uint8_t {
+    HALTED          = 0,    // hlt reached
+    STEP_LIMIT      = 1,    // Still running after the step budget
+    BAD_OPCODE      = 2,    // Instruction outside the supported subset
+    BAD_INTERRUPT   = 3     // int other than 0x10 AH=0x0E
+};
+
+struct RunResult {
+    StopReason reason;
+    uint64_t steps;             // Instructions executed
+    std::string output;         // Teletype output
+    uint8_t halt_code;          // AL at hlt (0x55 = NSIGII_YES)
+    uint16_t stop_ip;           // IP of the instruction that stopped the run
+    uint8_t opcode;             // Its first byte
+
+    RunResult() : reason(StopReason::HALTED), steps(0), halt_code(0), stop_ip(0), opcode(0) {}
+};
+
+// ============================================================================
+// Real-Mode Interpreter
+// ============================================================================
+
+class RealModeVM {
+public:
+    static constexpr uint32_t MEMORY_SIZE = 1u << 20;   // A20 off: addresses wrap
+    static constexpr uint16_t LOAD_ADDRESS = 0x7C00;
+    static constexpr uint64_t DEFAULT_STEP_LIMIT = 100000;
+
+    RealModeVM();
+
+    // Reset the machine and place `sector` at 0000:7C00. Only pages written
+    // by the previous run are cleared, so reloading costs microseconds
+    bool load(const uint8_t* sector, size_t len, uint8_t boot_drive = 0x80);
+
+    RunResult run(uint64_t step_limit = DEFAULT_STEP_LIMIT);
+
+    CpuState& state() { return cpu_; }
+    const CpuState& state() const { return cpu_; }
+    uint8_t peek(uint32_t address) const { return memory_[address & (MEMORY_SIZE - 1)]; }
+
+    static const char* reasonName(StopReason reason);
+
+private:
+    struct Operand {
+        bool is_reg;
+        uint8_t reg;            // ModRM reg field
+        uint8_t rm;             // Register number when is_reg
+        uint32_t address;       // Linear address otherwise
+    };
+
+    static constexpr uint32_t PAGE_SIZE = 4096;
+
+    CpuState cpu_;
+    std::vector<uint8_t> memory_;
+    std::vector<uint32_t> dirty_;       // Pages written since load(), once each
+    std::vector<bool> page_dirty_;      // Whether each page is in dirty_
+    int segment_override_;
+
+    uint32_t linear(uint16_t segment, uint16_t offset) const;
+    uint8_t read8(uint32_t address) const;
+    uint16_t read16(uint32_t address) const;
+    void write8(uint32_t address, uint8_t value);
+    void write16(uint32_t address, uint16_t value);
+    void markDirty(uint32_t address);
+
+    uint8_t fetch8();
+    uint16_t fetch16();
+    Operand decodeModRM();
+
+    uint8_t getReg8(uint8_t reg) const;
+    void setReg8(uint8_t reg, uint8_t value);
+    uint8_t readRM8(const Operand& op) const;
+    uint16_t readRM16(const Operand& op) const;
+    void writeRM8(const Operand& op, uint8_t value);
+    void writeRM16(const Operand& op, uint16_t value);
+
+    void push(uint16_t value);
+    uint16_t pop();
+
+    uint32_t alu(uint8_t op, uint32_t a, uint32_t b, bool wide);
+    uint32_t incdec(uint32_t a, bool dec, bool wide);
+    void setResultFlags(uint32_t result, bool wide);
+    bool condition(uint8_t cc) const;
+};
+
+} // namespace mmuko
+
+#endif // RIFTVM_HPP
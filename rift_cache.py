@@ -0,0 +1,163 @@
+#!/usr/bin/env python3
+"""
+rift_cache.py - MMUKO-OS Content-Addressed Artifact Cache
+Reuses generated boot artifacts whose inputs have not changed
+
+Artifacts are stored under a SHA-256 key of their inputs. The key format
+matches cpp/riftcache.cpp (schema tag, then each field as an 8-byte
+little-endian length followed by its bytes), so build_img.py and rifttool
+can share one cache directory. A hit is materialized by reflink, then hard
+link, then copy.
+
+Usage (wrap an external build, e.g. the direct image):
+    rift_cache.py wrap --cache-dir DIR --output FILE [--tag TEXT]
+                  [--input FILE]... [--no-hardlink] -- COMMAND...
+"""
+
+import errno
+import hashlib
+import os
+import shutil
+import struct
+import subprocess
+import sys
+
+SCHEMA = b"rift-cache-v1"
+DEFAULT_CACHE_DIR = os.path.join("build", "rift-cache")
+
+FICLONE = 0x40049409    # linux/fs.h _IOW(0x94, 9, int)
+
+
+def cache_key(*fields):
+    """SHA-256 over the schema tag and length-prefixed fields"""
+    h = hashlib.sha256()
+    for field in (SCHEMA,) + fields:
+        if isinstance(field, str):
+            field = field.encode("utf-8")
+        elif isinstance(field, int):
+            field = struct.pack("<Q", field)
+        h.update(struct.pack("<Q", len(field)))
+        h.update(field)
+    return h.hexdigest()
+
+
+def entry_path(cache_dir, key):
+    """Two-level fan-out keeps directories small for large image matrices"""
+    return os.path.join(cache_dir, key[:2], key)
+
+
+def _reflink(src, dest):
+    try:
+        import fcntl
+    except ImportError:
+        return False
+    try:
+        with open(src, "rb") as fin:
+            fd = os.open(dest, os.O_WRONLY | os.O_CREAT | os.O_EXCL, 0o644)
+            try:
+                fcntl.ioctl(fd, FICLONE, fin.fileno())
+                return True
+            except OSError:
+                pass
+            finally:
+                os.close(fd)
+    except OSError:
+        return False
+    os.unlink(dest)
+    return False
+
+
+def _hard_link(src, dest):
+    try:
+        os.link(src, dest)
+        return True
+    except (OSError, AttributeError):
+        return False
+
+
+def _remove(path):
+    try:
+        os.unlink(path)
+    except OSError as e:
+        if e.errno != errno.ENOENT:
+            raise
+
+
+def fetch(cache_dir, key, dest, hard_links=True):
+    """Materialize the artifact for key at dest; False on a miss
+
+    dest is replaced, never written through: an earlier fetch may have left
+    it as a hard link to the (read-only) cache entry.
+    """
+    entry = entry_path(cache_dir, key)
+    if not os.path.isfile(entry):
+        return False
+
+    parent = os.path.dirname(dest)
+    if parent:
+        os.makedirs(parent, exist_ok=True)
+    _remove(dest)
+
+    if not _reflink(entry, dest) and not (hard_links and _hard_link(entry, dest)):
+        shutil.copyfile(entry, dest)
+    return True
+
+
+def store(cache_dir, key, src):
+    """Insert src under key (reflink or copy, never a hard link)"""
+    entry = entry_path(cache_dir, key)
+    os.makedirs(os.path.dirname(entry), exist_ok=True)
+
+    # Build under a private name, then rename so readers never see a partial entry
+    temp = f"{entry}.tmp.{os.getpid()}"
+    _remove(temp)
+    if not _reflink(src, temp):
+        shutil.copyfile(src, temp)
+    os.chmod(temp, 0o444)
+    os.replace(temp, entry)
+    return entry
+
+
+def wrap(argv):
+    """Run an external build only when its inputs changed"""
+    import argparse
+
+    parser = argparse.ArgumentParser(prog="rift_cache.py wrap")
+    parser.add_argument("--cache-dir", default=DEFAULT_CACHE_DIR)
+    parser.add_argument("--output", required=True)
+    parser.add_argument("--tag", default="", help="builder name/version and flags")
+    parser.add_argument("--input", action="append", default=[])
+    parser.add_argument("--no-hardlink", action="store_true",
+                        help="never hard-link the output (it is opened read-write later)")
+    parser.add_argument("command", nargs=argparse.REMAINDER)
+    args = parser.parse_args(argv)
+
+    command = args.command[1:] if args.command[:1] == ["--"] else args.command
+    if not command:
+        parser.error("missing build command after --")
+
+    fields = [args.tag]
+    for path in args.input:
+        with open(path, "rb") as f:
+            fields += [path, f.read()]
+    key = cache_key(*fields)
+
+    if fetch(args.cache_dir, key, args.output, hard_links=not args.no_hardlink):
+        # Newer than its inputs, so mtime-driven makes downstream stay quiet
+        os.utime(args.output)
+        print(f"Cache hit: {args.output} ({key[:12]})")
+        return 0
+
+    # The build may write the output in place; start it from a fresh file
+    _remove(args.output)
+    result = subprocess.call(command)
+    if result == 0 and os.path.isfile(args.output):
+        store(args.cache_dir, key, args.output)
+    return result
+
+
+if __name__ == "__main__":
+    if len(sys.argv) < 2 or sys.argv[1] != "wrap":
+        print(__doc__.strip(), file=sys.stderr)
+        sys.exit(2)
+    sys.exit(wrap(sys.argv[2:]))